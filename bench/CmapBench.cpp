@@ -13,6 +13,8 @@
 #include "src/utils/SkCharToGlyphCache.h"
 #include "src/utils/SkUTF.h"
 
+#include <algorithm>
+
 enum {
     NGLYPHS = 100
 };
@@ -38,6 +40,22 @@ static void textToGlyphs_proc(const Rec& r) {
     }
 }
 
+static void utf8ToGlyphs_proc(const Rec& r) {
+    // Typical text is mostly ASCII, even when it isn't all ASCII.
+    static const char kText[] = "The quick brown fox jumps over the lazy dog, 1234567890 times. "
+                                "Voix ambigu\xC3\xAB d'un c\xC5\x93ur qui au z\xC3\xA9phyr "
+                                "pr\xC3\xA9\x66\xC3\xA8re les jattes.";
+    uint16_t glyphs[sizeof(kText)];
+    size_t length = std::min<size_t>(strlen(kText), r.fCount);
+    while ((kText[length] & 0xC0) == 0x80) {
+        length--;  // Don't split a character.
+    }
+
+    for (int i = 0; i < r.fLoops; ++i) {
+        r.fFont.textToGlyphs(kText, length, SkTextEncoding::kUTF8, glyphs, SK_ARRAY_COUNT(glyphs));
+    }
+}
+
 static void charsToGlyphs_proc(const Rec& r) {
     uint16_t glyphs[NGLYPHS];
     SkASSERT(r.fCount <= NGLYPHS);
@@ -112,6 +130,7 @@ private:
 constexpr int SMALL = 10;
 
 DEF_BENCH( return new CMAPBench(textToGlyphs_proc, "font_charToGlyph", SMALL); )
+DEF_BENCH( return new CMAPBench(utf8ToGlyphs_proc, "font_utf8ToGlyph", SMALL); )
 DEF_BENCH( return new CMAPBench(charsToGlyphs_proc, "face_charToGlyph", SMALL); )
 DEF_BENCH( return new CMAPBench(addcache_proc, "addcache_charToGlyph", SMALL); )
 DEF_BENCH( return new CMAPBench(findcache_proc, "findcache_charToGlyph", SMALL); )
@@ -119,6 +138,7 @@ DEF_BENCH( return new CMAPBench(findcache_proc, "findcache_charToGlyph", SMALL);
 constexpr int BIG = 100;
 
 DEF_BENCH( return new CMAPBench(textToGlyphs_proc, "font_charToGlyph", BIG); )
+DEF_BENCH( return new CMAPBench(utf8ToGlyphs_proc, "font_utf8ToGlyph", BIG); )
 DEF_BENCH( return new CMAPBench(charsToGlyphs_proc, "face_charToGlyph", BIG); )
 DEF_BENCH( return new CMAPBench(addcache_proc, "addcache_charToGlyph", BIG); )
 DEF_BENCH( return new CMAPBench(findcache_proc, "findcache_charToGlyph", BIG); )
@@ -72,6 +72,19 @@ static bool encode_webp_lossless(SkWStream* dst, const SkPixmap& src) {
     return SkWebpEncoder::Encode(dst, src, opts);
 }
 
+static bool encode_webp(SkWStream* dst,
+                        const SkPixmap& src,
+                        SkWebpEncoder::Compression compression,
+                        SkWebpEncoder::Effort effort,
+                        bool multithreaded) {
+    SkWebpEncoder::Options opts;
+    opts.fCompression = compression;
+    opts.fQuality = 90;
+    opts.fEffort = effort;
+    opts.fMultithreaded = multithreaded;
+    return SkWebpEncoder::Encode(dst, src, opts);
+}
+
 static bool encode_png(SkWStream* dst,
                        const SkPixmap& src,
                        SkPngEncoder::FilterFlag filters,
@@ -82,6 +95,10 @@ static bool encode_png(SkWStream* dst,
     return SkPngEncoder::Encode(dst, src, opts);
 }
 
+#define WEBP(COMPRESSION, EFFORT, MT) [](SkWStream* d, const SkPixmap& s) {             \
+           return encode_webp(d, s, SkWebpEncoder::Compression::COMPRESSION,             \
+                              SkWebpEncoder::Effort::EFFORT, MT); }
+
 #define PNG(FLAG, ZLIBLEVEL) [](SkWStream* d, const SkPixmap& s) { \
            return encode_png(d, s, SkPngEncoder::FilterFlag::FLAG, ZLIBLEVEL); }
 
@@ -98,6 +115,27 @@ DEF_BENCH(return new EncodeBench(srcs[1], encode_webp_lossy, "WEBP"));
 DEF_BENCH(return new EncodeBench(srcs[0], encode_webp_lossless, "WEBP_LL"));
 DEF_BENCH(return new EncodeBench(srcs[1], encode_webp_lossless, "WEBP_LL"));
 
+// Each effort preset, on one thread and with libwebp's threading.
+DEF_BENCH(return new EncodeBench(srcs[0], WEBP(kLossy, kFastest, false), "WEBP_fastest"));
+DEF_BENCH(return new EncodeBench(srcs[0], WEBP(kLossy, kFast, false), "WEBP_fast"));
+DEF_BENCH(return new EncodeBench(srcs[0], WEBP(kLossy, kBalanced, false), "WEBP_balanced"));
+DEF_BENCH(return new EncodeBench(srcs[0], WEBP(kLossy, kSmallest, false), "WEBP_smallest"));
+DEF_BENCH(return new EncodeBench(srcs[0], WEBP(kLossy, kFastest, true), "WEBP_fastest_mt"));
+DEF_BENCH(return new EncodeBench(srcs[0], WEBP(kLossy, kFast, true), "WEBP_fast_mt"));
+DEF_BENCH(return new EncodeBench(srcs[0], WEBP(kLossy, kBalanced, true), "WEBP_balanced_mt"));
+DEF_BENCH(return new EncodeBench(srcs[0], WEBP(kLossy, kSmallest, true), "WEBP_smallest_mt"));
+
+DEF_BENCH(return new EncodeBench(srcs[0], WEBP(kLossless, kFastest, false), "WEBP_LL_fastest"));
+DEF_BENCH(return new EncodeBench(srcs[0], WEBP(kLossless, kFast, false), "WEBP_LL_fast"));
+DEF_BENCH(return new EncodeBench(srcs[0], WEBP(kLossless, kBalanced, false), "WEBP_LL_balanced"));
+DEF_BENCH(return new EncodeBench(srcs[0], WEBP(kLossless, kSmallest, false), "WEBP_LL_smallest"));
+DEF_BENCH(return new EncodeBench(srcs[0], WEBP(kLossless, kFastest, true), "WEBP_LL_fastest_mt"));
+DEF_BENCH(return new EncodeBench(srcs[0], WEBP(kLossless, kFast, true), "WEBP_LL_fast_mt"));
+DEF_BENCH(return new EncodeBench(srcs[0], WEBP(kLossless, kBalanced, true),
+                                 "WEBP_LL_balanced_mt"));
+DEF_BENCH(return new EncodeBench(srcs[0], WEBP(kLossless, kSmallest, true),
+                                 "WEBP_LL_smallest_mt"));
+
 DEF_BENCH(return new EncodeBench(srcs[0], PNG(kAll, 6), "PNG"));
 DEF_BENCH(return new EncodeBench(srcs[0], PNG(kAll, 3), "PNG_3"));
 DEF_BENCH(return new EncodeBench(srcs[0], PNG(kAll, 1), "PNG_1"));
@@ -122,4 +160,5 @@ DEF_BENCH(return new EncodeBench(srcs[1], PNG(kNone, 6), "PNG_6n"));
 DEF_BENCH(return new EncodeBench(srcs[1], PNG(kNone, 3), "PNG_3n"));
 DEF_BENCH(return new EncodeBench(srcs[1], PNG(kNone, 1), "PNG_1n"));
 
+#undef WEBP
 #undef PNG
@@ -6,28 +6,46 @@
  */
 
 #include "bench/Benchmark.h"
+#include "include/core/SkString.h"
+#include "src/codec/SkSwizzler.h"
 #include "src/core/SkOpts.h"
+#include "src/core/SkYUVMath.h"
 
 class SwizzleBench : public Benchmark {
 public:
 
     SwizzleBench(const char* name, SkOpts::Swizzle_8888_u32 fn) : fName(name), fFn_u32(fn) {}
     SwizzleBench(const char* name, SkOpts::Swizzle_8888_u8  fn) : fName(name), fFn_u8 (fn) {}
+    SwizzleBench(const char* name, SkOpts::Swizzle_8888_index fn) : fName(name), fFn_index(fn) {}
+    SwizzleBench(const char* name, SkOpts::Swizzle_8888_yuv fn, int uvShift)
+        : fName(name), fFn_yuv(fn), fUVShift(uvShift) {
+        SkColorMatrix_YUV2RGB(kRec601_SkYUVColorSpace, fMatrix);
+    }
 
     bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
     const char* onGetName() override { return fName; }
     void onDraw(int loops, SkCanvas*) override {
         static const int K = 1023; // Arbitrary, but nice to be a non-power-of-two to trip up SIMD.
-        uint32_t dst[K], src[K];
+        // 16-bit formats read up to 8 bytes per pixel.
+        uint32_t dst[K], src[2*K], ctable[256];
         while (loops --> 0) {
-            if (fFn_u32) { fFn_u32(dst,                 src, K); }
-            if (fFn_u8)  { fFn_u8 (dst, (const uint8_t*)src, K); }
+            if (fFn_u32)   { fFn_u32  (dst,                 src, K); }
+            if (fFn_u8)    { fFn_u8   (dst, (const uint8_t*)src, K); }
+            if (fFn_index) { fFn_index(dst, (const uint8_t*)src, K, ctable); }
+            if (fFn_yuv) {
+                auto y = (const uint8_t*)src;
+                fFn_yuv(dst, y, y + K, y + 2*K, K, fUVShift, fMatrix);
+            }
         }
     }
 private:
     const char* fName;
     SkOpts::Swizzle_8888_u32 fFn_u32 = nullptr;
     SkOpts::Swizzle_8888_u8  fFn_u8  = nullptr;
+    SkOpts::Swizzle_8888_index fFn_index = nullptr;
+    SkOpts::Swizzle_8888_yuv   fFn_yuv   = nullptr;
+    int                        fUVShift  = 0;
+    float                      fMatrix[20];
 };
 
 
@@ -41,3 +59,72 @@ DEF_BENCH(return new SwizzleBench("SkOpts::grayA_to_RGBA", SkOpts::grayA_to_RGBA
 DEF_BENCH(return new SwizzleBench("SkOpts::grayA_to_rgbA", SkOpts::grayA_to_rgbA));
 DEF_BENCH(return new SwizzleBench("SkOpts::inverted_CMYK_to_RGB1", SkOpts::inverted_CMYK_to_RGB1));
 DEF_BENCH(return new SwizzleBench("SkOpts::inverted_CMYK_to_BGR1", SkOpts::inverted_CMYK_to_BGR1));
+DEF_BENCH(return new SwizzleBench("SkOpts::RGB16_to_RGB1", SkOpts::RGB16_to_RGB1));
+DEF_BENCH(return new SwizzleBench("SkOpts::RGB16_to_BGR1", SkOpts::RGB16_to_BGR1));
+DEF_BENCH(return new SwizzleBench("SkOpts::RGBA16_to_RGBA", SkOpts::RGBA16_to_RGBA));
+DEF_BENCH(return new SwizzleBench("SkOpts::RGBA16_to_BGRA", SkOpts::RGBA16_to_BGRA));
+DEF_BENCH(return new SwizzleBench("SkOpts::RGBA16_to_rgbA", SkOpts::RGBA16_to_rgbA));
+DEF_BENCH(return new SwizzleBench("SkOpts::RGBA16_to_bgrA", SkOpts::RGBA16_to_bgrA));
+DEF_BENCH(return new SwizzleBench("SkOpts::index_to_8888", SkOpts::index_to_8888));
+DEF_BENCH(return new SwizzleBench("SkOpts::YUV444_to_RGB1", SkOpts::YUV_to_RGB1, 0));
+DEF_BENCH(return new SwizzleBench("SkOpts::YUV420_to_RGB1", SkOpts::YUV_to_RGB1, 1));
+
+// Swizzles rows of an encoded format the way the codecs do, with and without sampling.
+class CodecSwizzlerBench : public Benchmark {
+public:
+    CodecSwizzlerBench(const char* format, SkEncodedInfo::Color color, SkEncodedInfo::Alpha alpha,
+                       int bitsPerComponent, int sampleX)
+        : fInfo(SkEncodedInfo::Make(kWidth, 1, color, alpha, bitsPerComponent))
+        , fSampleX(sampleX) {
+        fName.printf("CodecSwizzler_%s_sample%d", format, sampleX);
+    }
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        SkAlphaType at = SkEncodedInfo::kOpaque_Alpha == fInfo.alpha() ? kOpaque_SkAlphaType
+                                                                       : kPremul_SkAlphaType;
+        SkImageInfo dstInfo = SkImageInfo::MakeN32(kWidth, 1, at);
+        for (int i = 0; i < 256; i++) {
+            fColorTable[i] = SkPackARGB32(0xFF, i, i, i);
+        }
+        fSwizzler = SkSwizzler::Make(fInfo, fColorTable, dstInfo, SkCodec::Options());
+        fSwizzler->setSampleX(fSampleX);
+        for (size_t i = 0; i < sizeof(fSrc); i++) {
+            fSrc[i] = (i * 37 + 11) & 0xFF;
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        while (loops --> 0) {
+            fSwizzler->swizzle(fDst, fSrc);
+        }
+    }
+
+private:
+    static constexpr int kWidth = 1023;
+
+    SkString                    fName;
+    const SkEncodedInfo         fInfo;
+    const int                   fSampleX;
+    std::unique_ptr<SkSwizzler> fSwizzler;
+    SkPMColor                   fColorTable[256];
+    uint8_t                     fSrc[8 * kWidth];
+    uint32_t                    fDst[kWidth];
+};
+
+#define DEF_CODEC_SWIZZLER_BENCHES(name, color, alpha, bits)                                    \
+    DEF_BENCH(return new CodecSwizzlerBench(name, SkEncodedInfo::color, SkEncodedInfo::alpha, \
+                                            bits, 1));                                        \
+    DEF_BENCH(return new CodecSwizzlerBench(name, SkEncodedInfo::color, SkEncodedInfo::alpha, \
+                                            bits, 2));
+
+DEF_CODEC_SWIZZLER_BENCHES("gray", kGray_Color, kOpaque_Alpha, 8)
+DEF_CODEC_SWIZZLER_BENCHES("grayA", kGrayAlpha_Color, kUnpremul_Alpha, 8)
+DEF_CODEC_SWIZZLER_BENCHES("index", kPalette_Color, kOpaque_Alpha, 8)
+DEF_CODEC_SWIZZLER_BENCHES("RGB", kRGB_Color, kOpaque_Alpha, 8)
+DEF_CODEC_SWIZZLER_BENCHES("RGBA", kRGBA_Color, kUnpremul_Alpha, 8)
+DEF_CODEC_SWIZZLER_BENCHES("BGRA", kBGRA_Color, kUnpremul_Alpha, 8)
+DEF_CODEC_SWIZZLER_BENCHES("RGB16", kRGB_Color, kOpaque_Alpha, 16)
+DEF_CODEC_SWIZZLER_BENCHES("RGBA16", kRGBA_Color, kUnpremul_Alpha, 16)
@@ -13,6 +13,8 @@
 #include "include/core/SkStream.h"
 #include "include/core/SkTypes.h"
 
+class SkExecutor;
+
 /**
  *  Abstract interface defining image codec functionality that is necessary for
  *  Android.
@@ -274,6 +276,43 @@ public:
         return this->getAndroidPixels(info, pixels, rowBytes);
     }
 
+    /**
+     *  A region of the image for DecodeRegions() to decode, and where to decode it to.
+     */
+    struct Region {
+        /**
+         *  The part of the image to decode. It must be a subset supported by the codec, as
+         *  returned by getSupportedSubset().
+         */
+        SkIRect         fSubset;
+
+        /**
+         *  Where to decode the region. Its dimensions must be
+         *  getSampledSubsetDimensions(sampleSize, fSubset).
+         */
+        SkPixmap        fDst;
+
+        /**
+         *  Set by DecodeRegions() to the result of decoding this region.
+         */
+        SkCodec::Result fResult = SkCodec::kUnimplemented;
+    };
+
+    /**
+     *  Decodes each of the count regions of the image in data, downscaled by sampleSize, into
+     *  the region's fDst.
+     *
+     *  A codec can only decode one region at a time, so this makes a codec over data for each
+     *  region being decoded at once, and reuses it for later regions. If executor is not NULL
+     *  the regions are decoded concurrently on it, otherwise they are decoded one after another
+     *  on this thread.
+     *
+     *  Returns false if data is not an image we know how to decode. Otherwise sets fResult on
+     *  every region and returns true, even if some regions failed to decode.
+     */
+    static bool DecodeRegions(sk_sp<SkData> data, int sampleSize, Region regions[], int count,
+                              SkExecutor* executor = nullptr);
+
     SkCodec* codec() const { return fCodec.get(); }
 
 protected:
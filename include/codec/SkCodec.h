@@ -26,6 +26,7 @@
 
 class SkColorSpace;
 class SkData;
+class SkExecutor;
 class SkFrameHolder;
 class SkPngChunkReader;
 class SkSampler;
@@ -277,6 +278,7 @@ public:
             , fSubset(nullptr)
             , fFrameIndex(0)
             , fPriorFrame(kNoFrame)
+            , fExecutor(nullptr)
         {}
 
         ZeroInitialized            fZeroInitialized;
@@ -320,6 +322,14 @@ public:
          *  If set to kNoFrame, the codec will decode any necessary required frame(s) first.
          */
         int                        fPriorFrame;
+
+        /**
+         *  If not NULL, getPixels() may use this to decode independent parts of the image
+         *  in parallel. The result is the same as decoding without it.
+         *
+         *  Currently only used for baseline JPEGs with restart markers.
+         */
+        SkExecutor*                fExecutor;
     };
 
     /**
@@ -366,6 +376,22 @@ public:
         return this->getPixels(pm.info(), pm.writable_addr(), pm.rowBytes(), opts);
     }
 
+    /**
+     *  Decode the image, resized to the dimensions of |dst|, into |dst|.  Unlike getPixels(),
+     *  |dst| may have any dimensions that are no larger than the image's.
+     *
+     *  The image is decoded at the smallest size returned by getScaledDimensions() that is at
+     *  least as large as |dst|, a row at a time where the codec supports that, and each pixel
+     *  of |dst| is the average of the decoded pixels under it.  So the time and memory this
+     *  takes depend on the size of |dst| rather than that of the image, for codecs that scale
+     *  natively (e.g. JPEG and WebP).
+     *
+     *  |dst| must be kRGBA_8888_SkColorType or kBGRA_8888_SkColorType.  |options| may not
+     *  specify a subset.  Pixels are averaged premultiplied, so if |dst| is unpremultiplied,
+     *  the colors of transparent pixels do not bleed into their neighbors.
+     */
+    Result getResizedPixels(const SkPixmap& dst, const Options* options = nullptr);
+
     /**
      *  If decoding to YUV is supported, this returns true.  Otherwise, this
      *  returns false and does not modify any of the parameters.
@@ -11,6 +11,7 @@
 #include "include/core/SkRefCnt.h"
 
 class SkData;
+class SkExecutor;
 class SkImageGenerator;
 class SkTraceMemoryDump;
 
@@ -97,6 +98,19 @@ public:
      */
     static void PurgeFontCache();
 
+    /**
+     *  Keep rendered glyphs in the directory at path (creating it if needed) and reuse them in
+     *  later processes using the same directory, so they don't need to be rasterized again.
+     *
+     *  Glyphs are saved on a background thread when their strike is purged from the font cache,
+     *  so before exiting call PurgeFontCache(), then SetFontCacheDirectory(nullptr, 0) to wait
+     *  for everything to be written. The oldest strikes are deleted to keep the directory under
+     *  maxBytes. Pass nullptr to stop using the directory.
+     *
+     *  Returns false, and stops using any directory, if path could not be created.
+     */
+    static bool SetFontCacheDirectory(const char path[], size_t maxBytes);
+
     /**
      *  Scaling bitmaps with the kHigh_SkFilterQuality setting is
      *  expensive, so the result is saved in the global Scaled Image
@@ -176,4 +190,26 @@ public:
     }
 };
 
+/**
+ *  While alive, text drawn to raster canvases on the thread that made it rasterizes the glyphs
+ *  each draw needs on executor before drawing. Glyphs of different typefaces are rasterized in
+ *  parallel; those of one typeface are not, even at different sizes, because FreeType renders
+ *  with one face at a time. This speeds up the first draw of text using many typefaces.
+ *
+ *  Other threads are unaffected. executor must outlive this, and should not be an executor
+ *  whose own threads draw text. The previous executor, if any, is restored when this is
+ *  destroyed. On iOS, glyphs are always rasterized one at a time as they are drawn.
+ */
+class SK_API SkAutoFontRasterizationExecutor {
+public:
+    explicit SkAutoFontRasterizationExecutor(SkExecutor* executor);
+    ~SkAutoFontRasterizationExecutor();
+
+    SkAutoFontRasterizationExecutor(const SkAutoFontRasterizationExecutor&) = delete;
+    SkAutoFontRasterizationExecutor& operator=(const SkAutoFontRasterizationExecutor&) = delete;
+
+private:
+    SkExecutor* fPrevious;
+};
+
 #endif
@@ -560,7 +560,11 @@ public:
         format of data is recognized and supported. Otherwise, nullptr is returned.
         Recognized GPU formats vary by platform and GPU back-end.
 
-        @param context                GPU context
+        If context is nullptr, a raster SkImage is converted on the CPU instead. This requires
+        Y, U, V, and optional A in separate single-channel 8-bit pixmaps; U and V may be
+        subsampled by two. buildMips and limitToMaxTextureSize are ignored.
+
+        @param context                GPU context; may be nullptr
         @param yuvColorSpace          How the YUV values are converted to RGB
         @param yuvaPixmaps            array of (up to four) SkPixmap which contain the,
                                       possibly interleaved, YUVA planes
@@ -19,24 +19,55 @@ public:
      *  Encode |numRows| rows of input.  If the caller requests more rows than are remaining
      *  in the src, this will encode all of the remaining rows.  |numRows| must be greater
      *  than zero.
+     *
+     *  Returns false for encoders created from an SkImageInfo, which have no src pixels; those
+     *  are given their rows with encodeRows(const SkPixmap&).
      */
     bool encodeRows(int numRows);
 
+    /**
+     *  For encoders created from an SkImageInfo rather than an SkPixmap, encode the next
+     *  |rows|.height() rows of the image from |rows|.  |rows| must have the same width, color
+     *  type, alpha type and color space as the image.  If it has more rows than are remaining in
+     *  the image, the extra rows are ignored.
+     *
+     *  |rows| is not used after this returns, so only a strip of the image needs to be in
+     *  memory at once.
+     *
+     *  Returns false if |rows| does not match the image, or if encoding fails.
+     */
+    bool encodeRows(const SkPixmap& rows);
+
     virtual ~SkEncoder() {}
 
 protected:
 
     virtual bool onEncodeRows(int numRows) = 0;
 
+    /**
+     *  |src| describes the image.  Its pixels are nullptr for encoders that are given the image
+     *  a strip at a time with encodeRows(const SkPixmap&).
+     */
     SkEncoder(const SkPixmap& src, size_t storageBytes)
         : fSrc(src)
         , fCurrRow(0)
         , fStorage(storageBytes)
     {}
 
-    const SkPixmap&        fSrc;
+    /**
+     *  Returns the address of row |y| of the image, which must be one of the rows passed to
+     *  onEncodeRows().
+     */
+    const void* srcRow(int y) const;
+
+    const SkPixmap         fSrc;
     int                    fCurrRow;
     SkAutoTMalloc<uint8_t> fStorage;
+
+private:
+    // The rows being encoded by encodeRows(const SkPixmap&), starting at row fRowsTop.
+    SkPixmap               fRows;
+    int                    fRowsTop = 0;
 };
 
 #endif
@@ -11,6 +11,7 @@
 #include "include/core/SkDataTable.h"
 #include "include/encode/SkEncoder.h"
 
+class SkExecutor;
 class SkPngEncoderMgr;
 class SkWStream;
 
@@ -59,6 +60,16 @@ public:
          *  and the (2i + 1)-th entry is the text for the i-th comment.
          */
         sk_sp<SkDataTable> fComments;
+
+        /**
+         *  If set, Encode() splits the image into horizontal strips, then filters and deflates
+         *  the strips in parallel on this executor and joins them into a single zlib stream.
+         *
+         *  The output does not depend on the executor or how many threads it has, but it is not
+         *  byte-identical to (and is slightly larger than) the output of a serial encode.
+         *  Encoders returned by Make() ignore this and always encode serially.
+         */
+        SkExecutor* fExecutor = nullptr;
     };
 
     /**
@@ -80,11 +91,27 @@ public:
     static std::unique_ptr<SkEncoder> Make(SkWStream* dst, const SkPixmap& src,
                                            const Options& options);
 
+    /**
+     *  Create a png encoder for an image described by |info|, which will encode the rows passed
+     *  to SkEncoder::encodeRows(const SkPixmap&) to the |dst| stream as they arrive.
+     *  |options| may be used to control the encoding behavior, except for fExecutor, which is
+     *  ignored.
+     *
+     *  |dst| is unowned but must remain valid for the lifetime of the object.
+     *
+     *  This returns nullptr on an invalid or unsupported |info|.
+     */
+    static std::unique_ptr<SkEncoder> Make(SkWStream* dst, const SkImageInfo& info,
+                                           const Options& options);
+
     ~SkPngEncoder() override;
 
 protected:
     bool onEncodeRows(int numRows) override;
 
+    static std::unique_ptr<SkEncoder> MakeEncoder(SkWStream* dst, const SkPixmap& src,
+                                                  const Options& options);
+
     SkPngEncoder(std::unique_ptr<SkPngEncoderMgr>, const SkPixmap& src);
 
     std::unique_ptr<SkPngEncoderMgr> fEncoderMgr;
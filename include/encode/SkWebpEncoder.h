@@ -19,6 +19,18 @@ namespace SkWebpEncoder {
         kLossless,
     };
 
+    /**
+     *  Trades encoding time against the size of the encoded image, by choosing libwebp's
+     *  compression method.
+     */
+    enum class Effort {
+        kDefault,   // Matches Chrome: method 3 for lossy and method 0 for lossless.
+        kFastest,   // Method 0.
+        kFast,      // Method 2.
+        kBalanced,  // Method 4, libwebp's own default.
+        kSmallest,  // Method 6.
+    };
+
     struct SK_API Options {
         /**
          *  |fCompression| determines whether we will use webp lossy or lossless compression.
@@ -34,6 +46,18 @@ namespace SkWebpEncoder {
          */
         Compression fCompression = Compression::kLossy;
         float fQuality = 100.0f;
+
+        /**
+         *  |fEffort| chooses how hard libwebp works to make the encoded image smaller.  Slower
+         *  efforts give smaller images.  For kLossless this is in addition to |fQuality|.
+         */
+        Effort fEffort = Effort::kDefault;
+
+        /**
+         *  If |fMultithreaded| is true, libwebp may use additional threads for the encode.  This
+         *  lowers the latency of a single encode at the cost of more total CPU time.
+         */
+        bool fMultithreaded = false;
     };
 
     /**
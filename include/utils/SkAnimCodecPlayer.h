@@ -10,11 +10,20 @@
 
 #include "include/codec/SkCodec.h"
 
+class SkAnimFrameDecoder;
 class SkImage;
 
 class SkAnimCodecPlayer {
 public:
     SkAnimCodecPlayer(std::unique_ptr<SkCodec> codec);
+
+    /**
+     *  Plays the frames of decoder, which may be shared with other players.  Frames are decoded
+     *  through its cache, and the next few frames are prefetched whenever seek() moves to a new
+     *  frame.
+     */
+    SkAnimCodecPlayer(sk_sp<SkAnimFrameDecoder> decoder);
+
     ~SkAnimCodecPlayer();
 
     /**
@@ -47,6 +56,7 @@ public:
 
 private:
     std::unique_ptr<SkCodec>        fCodec;
+    sk_sp<SkAnimFrameDecoder>       fDecoder;
     SkImageInfo                     fImageInfo;
     std::vector<SkCodec::FrameInfo> fFrameInfos;
     std::vector<sk_sp<SkImage> >    fImages;
@@ -54,6 +64,7 @@ private:
     uint32_t                        fTotalDuration;
 
     sk_sp<SkImage> getFrameAt(int index);
+    void computeDuration();
 };
 
 #endif
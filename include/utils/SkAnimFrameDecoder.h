@@ -0,0 +1,115 @@
+/*
+ * Copyright 2020 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkAnimFrameDecoder_DEFINED
+#define SkAnimFrameDecoder_DEFINED
+
+#include "include/codec/SkCodec.h"
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkRefCnt.h"
+#include "include/private/SkMutex.h"
+
+#include <memory>
+#include <vector>
+
+class SkData;
+class SkExecutor;
+class SkImage;
+
+/**
+ *  Decodes the frames of an animated image on demand, and may be used from any thread.
+ *
+ *  A frame is decoded starting from the nearest frame it depends on that is still cached, so
+ *  frames that do not depend on each other (e.g. those following different independent frames)
+ *  are decoded concurrently when requested from several threads or prefetched.  Decoded frames
+ *  are kept under a byte budget; frames that other frames are decoded from are purged last.
+ */
+class SK_API SkAnimFrameDecoder : public SkRefCnt {
+public:
+    static constexpr size_t kDefaultCacheBudget = 32 * 1024 * 1024;
+
+    /**
+     *  Returns nullptr if data is not an image we know how to decode.
+     *
+     *  @param executor    If not null, prefetch() decodes frames on it.  It must outlive any
+     *                     prefetches that are still pending.
+     *  @param cacheBudget How many bytes of decoded frames to keep.  The most recently decoded
+     *                     frame is always kept.
+     */
+    static sk_sp<SkAnimFrameDecoder> Make(sk_sp<SkData> data, SkExecutor* executor = nullptr,
+                                          size_t cacheBudget = kDefaultCacheBudget);
+
+    ~SkAnimFrameDecoder() override;
+
+    const SkImageInfo& imageInfo() const { return fImageInfo; }
+
+    /**
+     *  Info for every frame.  A still image has a single frame with no required frame and a
+     *  duration of zero.
+     */
+    const std::vector<SkCodec::FrameInfo>& frameInfos() const { return fFrameInfos; }
+
+    int frameCount() const { return (int)fFrameInfos.size(); }
+
+    /**
+     *  Returns the frame at index, decoding it and any uncached frames it depends on on this
+     *  thread.  Returns nullptr if index is out of range or the frame could not be decoded.
+     */
+    sk_sp<SkImage> getFrame(int index);
+
+    /**
+     *  Queues count frames starting at index, wrapping around to the first frame, to be decoded
+     *  on the executor so that getFrame() finds them cached.  Frames that are cached or already
+     *  queued are skipped, as are frames that would not fit in the cache budget.  Does nothing
+     *  without an executor.
+     */
+    void prefetch(int index, int count);
+
+    /**
+     *  Returns the number of bytes of decoded frames in the cache.
+     */
+    size_t cachedBytes() const;
+
+private:
+    SkAnimFrameDecoder(sk_sp<SkData>, std::unique_ptr<SkCodec>, SkExecutor*, size_t cacheBudget);
+
+    sk_sp<SkImage> decodeFrame(int index, sk_sp<SkImage> prior);
+
+    // These require fMutex.
+    sk_sp<SkImage> lookup(int index);
+    void purgeAsNeeded(int keep);
+
+    struct Frame {
+        // Held while the frame is decoded, so that it is only decoded once at a time.
+        SkMutex        fDecodeMutex;
+
+        // The rest are guarded by fMutex.
+        sk_sp<SkImage> fImage;
+        uint64_t       fLastUse = 0;
+        bool           fQueued = false;
+
+        // Whether other frames are decoded from this one.
+        bool           fIsReference = false;
+    };
+
+    const sk_sp<SkData>             fData;
+    SkExecutor*                     fExecutor;
+    const size_t                    fCacheBudget;
+    SkImageInfo                     fImageInfo;
+    size_t                          fFrameBytes;
+    std::vector<SkCodec::FrameInfo> fFrameInfos;
+    std::unique_ptr<Frame[]>        fFrames;
+
+    mutable SkMutex                       fMutex;
+    std::vector<std::unique_ptr<SkCodec>> fIdleCodecs;
+    size_t                                fCachedBytes = 0;
+    uint64_t                              fUseCount = 0;
+
+    typedef SkRefCnt INHERITED;
+};
+
+#endif
@@ -0,0 +1,67 @@
+/*
+ * Copyright 2020 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkCompressedPicture_DEFINED
+#define SkCompressedPicture_DEFINED
+
+#include "include/core/SkPicture.h"
+
+class SkData;
+class SkStream;
+class SkWStream;
+struct SkDeserialProcs;
+struct SkSerialProcs;
+
+/**
+ *  Optional compressed framing for serialized SkPictures.
+ *
+ *  The picture is serialized as usual, then split into fixed size chunks that are deflated
+ *  independently, so decompression can run on several threads (see SkExecutor::SetDefault())
+ *  and a reader never needs more than the compressed and uncompressed bytes in memory.
+ *
+ *  Pictures that serialize to fewer than fMinCompressedSize bytes are written as a plain SKP.
+ *  The readers below accept both forms, so they can replace SkPicture::MakeFromStream() and
+ *  SkPicture::MakeFromData() for any mix of compressed and uncompressed files.
+ *
+ *  If Skia is built without zlib, Serialize() always writes plain SKPs and the readers
+ *  reject compressed ones.
+ */
+namespace SkCompressedPicture {
+
+struct Options {
+    /** zlib compression level: 0 is no compression, 1 is best speed, 9 is best compression.
+        -1 uses zlib's default. */
+    int fCompressionLevel = -1;
+
+    /** Uncompressed bytes per chunk.  Smaller chunks decompress in parallel more readily;
+        larger ones compress slightly better. */
+    size_t fChunkSize = 256 * 1024;
+
+    /** Pictures smaller than this (serialized) are written uncompressed. */
+    size_t fMinCompressedSize = 4096;
+};
+
+/**
+ *  Serializes picture into stream, compressed according to options.
+ *  Returns false if writing to the stream failed.
+ */
+SK_API bool Serialize(const SkPicture* picture, SkWStream* stream,
+                      const Options& options = Options(),
+                      const SkSerialProcs* procs = nullptr);
+
+/**
+ *  Recreates a picture written by Serialize() or SkPicture::serialize().
+ *  Returns nullptr if the data is not a valid (compressed or plain) SKP.
+ */
+SK_API sk_sp<SkPicture> MakeFromData(const SkData* data,
+                                     const SkDeserialProcs* procs = nullptr);
+SK_API sk_sp<SkPicture> MakeFromStream(SkStream* stream,
+                                       const SkDeserialProcs* procs = nullptr);
+
+}  // namespace SkCompressedPicture
+
+#endif
@@ -0,0 +1,65 @@
+/*
+ * Copyright 2020 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkImageDecodeAhead_DEFINED
+#define SkImageDecodeAhead_DEFINED
+
+#include "include/core/SkFilterQuality.h"
+#include "include/core/SkImage.h"
+#include "include/core/SkMatrix.h"
+#include "include/core/SkRect.h"
+
+#include <vector>
+
+class SkExecutor;
+class SkPicture;
+
+/**
+ *  Decodes lazy images (e.g. SkImage::MakeFromEncoded) into the resource cache ahead of drawing
+ *  them to a raster canvas, so that the draw finds them decoded instead of decoding them on the
+ *  drawing thread.
+ *
+ *  A raster draw needs an image's full size pixels, plus its mipmaps if the image is drawn
+ *  scaled down with kMedium_SkFilterQuality or better.  Both are built here, from the matrix and
+ *  filter quality each image will be drawn with.
+ */
+class SK_API SkImageDecodeAhead {
+public:
+    struct Request {
+        sk_sp<SkImage>  fImage;
+
+        /** Maps the image's pixels to device space, as the image will be drawn. */
+        SkMatrix        fMatrix = SkMatrix::I();
+
+        SkFilterQuality fQuality = kNone_SkFilterQuality;
+    };
+
+    /**
+     *  Returns a Request for each lazy image that drawing picture with matrix would draw inside
+     *  clip, in device space.  This includes images drawn by image shaders and by nested
+     *  pictures and drawables.  An image drawn more than once gets a single Request, for a draw
+     *  that needs its mipmaps if any does.
+     */
+    static std::vector<Request> FindImages(const SkPicture* picture, const SkMatrix& matrix,
+                                           const SkIRect& clip);
+
+    /**
+     *  Decodes the images of count requests, concurrently on executor if it is not null, and
+     *  returns when they are done.  Requests for images that are not lazy are skipped.
+     *
+     *  Returns how many images were decoded, or were already in the cache.
+     */
+    static int Decode(const Request requests[], int count, SkExecutor* executor = nullptr);
+
+    /**
+     *  Decodes the images FindImages() returns for picture.
+     */
+    static int DecodePicture(const SkPicture* picture, const SkMatrix& matrix,
+                             const SkIRect& clip, SkExecutor* executor = nullptr);
+};
+
+#endif
@@ -53,6 +53,22 @@ public:
     static std::unique_ptr<SkShaper> MakeShaperDrivenWrapper(sk_sp<SkFontMgr> = nullptr);
     static std::unique_ptr<SkShaper> MakeShapeThenWrap(sk_sp<SkFontMgr> = nullptr);
     static std::unique_ptr<SkShaper> MakeShapeDontWrapOrReorder(sk_sp<SkFontMgr> = nullptr);
+
+    /** The HarfBuzz shapers remember the glyphs and positions of recently shaped runs, and reuse
+     *  them when a run is shaped again with the same text, font, features, direction, script and
+     *  language. The cache is shared by every shaper, and the least recently used runs are
+     *  dropped to keep it under a limit in bytes.
+     */
+    struct ShapingCacheStats {
+        uint64_t fHits = 0;
+        uint64_t fMisses = 0;
+        size_t   fBytesUsed = 0;
+        int      fRunCount = 0;
+    };
+    static ShapingCacheStats GetShapingCacheStats();
+    /** Returns the previous limit. A limit of 0 turns the cache off. */
+    static size_t SetShapingCacheLimit(size_t bytes);
+    static void PurgeShapingCache();
     #endif
     // Returns nullptr if not supported
     static std::unique_ptr<SkShaper> MakeCoreText();
@@ -20,13 +20,17 @@
 #include "include/core/SkTypes.h"
 #include "include/private/SkBitmaskEnum.h"
 #include "include/private/SkMalloc.h"
+#include "include/private/SkMutex.h"
 #include "include/private/SkTArray.h"
 #include "include/private/SkTFitsIn.h"
 #include "include/private/SkTemplates.h"
 #include "include/private/SkTo.h"
 #include "modules/skshaper/include/SkShaper.h"
+#include "src/core/SkLRUCache.h"
+#include "src/core/SkOpts.h"
 #include "src/core/SkSpan.h"
 #include "src/core/SkTDPQueue.h"
+#include "src/core/SkTLazy.h"
 #include "src/utils/SkUTF.h"
 
 #include <hb.h>
@@ -41,10 +45,12 @@
 #include <unicode/utext.h>
 #include <unicode/utypes.h>
 
+#include <algorithm>
 #include <cstring>
 #include <memory>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #if defined(SK_USING_THIRD_PARTY_ICU)
 #include "SkLoadICU.h"
@@ -510,6 +516,190 @@ struct ShapedLine {
     SkVector fAdvance = { 0, 0 };
 };
 
+// HarfBuzz looks at no more than this many code points either side of the text it shapes
+// (HB_BUFFER_CONTEXT_LENGTH).
+constexpr int kShapingContextLength = 5;
+
+// Everything which can change the glyphs and positions HarfBuzz makes for a run.
+struct ShapeCacheKey {
+    ShapeCacheKey(const char* utf8, size_t utf8Bytes, const char* utf8Start, const char* utf8End,
+                  const SkFont& font, UBiDiLevel level, SkFourByteTag script,
+                  const char* language, SkSpan<const hb_feature_t> features)
+        : fFont(font), fLevel(level), fScript(script), fLanguage(language)
+    {
+        const char* contextStart = utf8Start;
+        for (int i = 0; i < kShapingContextLength && utf8 < contextStart; ++i) {
+            do {
+                --contextStart;
+            } while (utf8 < contextStart && (*contextStart & 0xC0) == 0x80);
+        }
+        const char* contextEnd = utf8End;
+        for (int i = 0; i < kShapingContextLength && contextEnd < utf8 + utf8Bytes; ++i) {
+            utf8_next(&contextEnd, utf8 + utf8Bytes);
+        }
+        fText.set(contextStart, contextEnd - contextStart);
+        fRunStart = utf8Start - contextStart;
+        fRunEnd = utf8End - contextStart;
+
+        // Make the feature ranges relative to the run, so the same run found in other text
+        // has the same key.
+        const size_t runStart = utf8Start - utf8;
+        const size_t runEnd = utf8End - utf8;
+        for (hb_feature_t feature : features) {
+            if (feature.start != HB_FEATURE_GLOBAL_START || feature.end != HB_FEATURE_GLOBAL_END) {
+                feature.start = std::max<size_t>(feature.start, runStart) - runStart;
+                feature.end = std::min<size_t>(feature.end, runEnd) - runStart;
+            }
+            fFeatures.push_back(feature);
+        }
+
+        uint32_t hash = SkOpts::hash(fText.c_str(), fText.size(), fRunStart);
+        hash = SkOpts::hash(fLanguage.c_str(), fLanguage.size(), hash);
+        hash = SkOpts::hash(fFeatures.data(), fFeatures.size() * sizeof(hb_feature_t), hash);
+        const SkScalar fontScalars[] = { font.getSize(), font.getScaleX(), font.getSkewX() };
+        hash = SkOpts::hash(fontScalars, sizeof(fontScalars), hash);
+        const uint32_t fontAndRun[] = {
+            SkTypeface::UniqueID(font.getTypeface()),
+            (uint32_t)font.getEdging() << 8 | (uint32_t)font.getHinting(),
+            (uint32_t)fLevel, fScript, (uint32_t)fRunEnd,
+        };
+        fHash = SkOpts::hash(fontAndRun, sizeof(fontAndRun), hash);
+    }
+
+    bool operator==(const ShapeCacheKey& that) const {
+        return fHash == that.fHash &&
+               fRunStart == that.fRunStart &&
+               fRunEnd == that.fRunEnd &&
+               fLevel == that.fLevel &&
+               fScript == that.fScript &&
+               fFont == that.fFont &&
+               fText == that.fText &&
+               fLanguage == that.fLanguage &&
+               fFeatures.size() == that.fFeatures.size() &&
+               0 == memcmp(fFeatures.data(), that.fFeatures.data(),
+                           fFeatures.size() * sizeof(hb_feature_t));
+    }
+
+    size_t bytesUsed() const {
+        return sizeof(*this) + fText.size() + fLanguage.size() +
+               fFeatures.size() * sizeof(hb_feature_t);
+    }
+
+    struct Hash {
+        uint32_t operator()(const ShapeCacheKey& key) const { return key.fHash; }
+    };
+
+    SkString fText;  // The run and its context.
+    size_t fRunStart;
+    size_t fRunEnd;
+    SkFont fFont;
+    UBiDiLevel fLevel;
+    SkFourByteTag fScript;
+    SkString fLanguage;
+    std::vector<hb_feature_t> fFeatures;
+    uint32_t fHash;
+};
+
+struct ShapeCacheValue {
+    std::unique_ptr<ShapedGlyph[]> fGlyphs;  // With clusters relative to the start of the run.
+    size_t fNumGlyphs;
+    SkVector fAdvance;
+    size_t fBytesUsed;
+};
+
+class ShapeCache {
+public:
+    static ShapeCache& Get() {
+        static ShapeCache* cache = new ShapeCache;
+        return *cache;
+    }
+
+    // If the run has been shaped before, sets the glyphs and advance of run and returns true.
+    bool find(const ShapeCacheKey& key, ShapedRun* run) {
+        SkAutoMutexExclusive lock(fMutex);
+        ShapeCacheValue* value = fCache.find(key);
+        if (!value) {
+            fMisses++;
+            return false;
+        }
+        fHits++;
+        run->fGlyphs.reset(new ShapedGlyph[value->fNumGlyphs]);
+        run->fNumGlyphs = value->fNumGlyphs;
+        run->fAdvance = value->fAdvance;
+        for (size_t i = 0; i < value->fNumGlyphs; ++i) {
+            run->fGlyphs[i] = value->fGlyphs[i];
+            run->fGlyphs[i].fCluster += run->fUtf8Range.begin();
+        }
+        return true;
+    }
+
+    void add(const ShapeCacheKey& key, const ShapedRun& run) {
+        ShapeCacheValue value;
+        value.fGlyphs.reset(new ShapedGlyph[run.fNumGlyphs]);
+        value.fNumGlyphs = run.fNumGlyphs;
+        value.fAdvance = run.fAdvance;
+        value.fBytesUsed = key.bytesUsed() + sizeof(value) + run.fNumGlyphs * sizeof(ShapedGlyph);
+        for (size_t i = 0; i < run.fNumGlyphs; ++i) {
+            value.fGlyphs[i] = run.fGlyphs[i];
+            value.fGlyphs[i].fCluster -= run.fUtf8Range.begin();
+        }
+
+        SkAutoMutexExclusive lock(fMutex);
+        if (value.fBytesUsed > fLimit || fCache.find(key)) {
+            return;
+        }
+        fBytesUsed += value.fBytesUsed;
+        fCache.insert(key, std::move(value));
+        this->purgeTo(fLimit);
+    }
+
+    SkShaper::ShapingCacheStats stats() {
+        SkAutoMutexExclusive lock(fMutex);
+        SkShaper::ShapingCacheStats stats;
+        stats.fHits = fHits;
+        stats.fMisses = fMisses;
+        stats.fBytesUsed = fBytesUsed;
+        stats.fRunCount = fCache.count();
+        return stats;
+    }
+
+    size_t setLimit(size_t bytes) {
+        SkAutoMutexExclusive lock(fMutex);
+        size_t previous = fLimit;
+        fLimit = bytes;
+        this->purgeTo(fLimit);
+        return previous;
+    }
+
+    void purge() {
+        SkAutoMutexExclusive lock(fMutex);
+        this->purgeTo(0);
+    }
+
+    bool enabled() {
+        SkAutoMutexExclusive lock(fMutex);
+        return fLimit > 0;
+    }
+
+private:
+    static constexpr size_t kDefaultLimit = 4 * 1024 * 1024;
+
+    void purgeTo(size_t bytes) {
+        fMutex.assertHeld();
+        while (fBytesUsed > bytes) {
+            fBytesUsed -= fCache.lru()->fBytesUsed;
+            fCache.removeLRU();
+        }
+    }
+
+    SkMutex fMutex;
+    SkLRUCache<ShapeCacheKey, ShapeCacheValue, ShapeCacheKey::Hash> fCache{SK_MaxS32};
+    size_t fLimit = kDefaultLimit;
+    size_t fBytesUsed = 0;
+    uint64_t fHits = 0;
+    uint64_t fMisses = 0;
+};
+
 constexpr bool is_LTR(UBiDiLevel level) {
     return (level & 1) == 0;
 }
@@ -1288,6 +1478,36 @@ ShapedRun ShaperHarfBuzz::shape(char const * const utf8,
     ShapedRun run(RunHandler::Range(utf8Start - utf8, utf8runLength),
                   font.currentFont(), bidi.currentLevel(), nullptr, 0);
 
+    SkSTArray<32, hb_feature_t> hbFeatures;
+    for (const auto& feature : SkMakeSpan(features, featuresSize)) {
+        if (feature.end < SkTo<size_t>(utf8Start - utf8) ||
+                          SkTo<size_t>(utf8End   - utf8)  <= feature.start)
+        {
+            continue;
+        }
+        if (feature.start <= SkTo<size_t>(utf8Start - utf8) &&
+                             SkTo<size_t>(utf8End   - utf8) <= feature.end)
+        {
+            hbFeatures.push_back({ (hb_tag_t)feature.tag, feature.value,
+                                   HB_FEATURE_GLOBAL_START, HB_FEATURE_GLOBAL_END});
+        } else {
+            hbFeatures.push_back({ (hb_tag_t)feature.tag, feature.value,
+                                   SkTo<unsigned>(feature.start), SkTo<unsigned>(feature.end)});
+        }
+    }
+
+    ShapeCache& cache = ShapeCache::Get();
+    SkTLazy<ShapeCacheKey> cacheKey;
+    if (cache.enabled()) {
+        cacheKey.init(utf8, utf8Bytes, utf8Start, utf8End,
+                      font.currentFont(), bidi.currentLevel(), script.currentScript(),
+                      language.currentLanguage(),
+                      SkMakeSpan(hbFeatures.begin(), hbFeatures.count()));
+        if (cache.find(*cacheKey, &run)) {
+            return run;
+        }
+    }
+
     hb_buffer_t* buffer = fBuffer.get();
     SkAutoTCallVProc<hb_buffer_t, hb_buffer_clear_contents> autoClearBuffer(buffer);
     hb_buffer_set_content_type(buffer, HB_BUFFER_CONTENT_TYPE_UNICODE);
@@ -1324,24 +1544,6 @@ ShapedRun ShaperHarfBuzz::shape(char const * const utf8,
         return run;
     }
 
-    SkSTArray<32, hb_feature_t> hbFeatures;
-    for (const auto& feature : SkMakeSpan(features, featuresSize)) {
-        if (feature.end < SkTo<size_t>(utf8Start - utf8) ||
-                          SkTo<size_t>(utf8End   - utf8)  <= feature.start)
-        {
-            continue;
-        }
-        if (feature.start <= SkTo<size_t>(utf8Start - utf8) &&
-                             SkTo<size_t>(utf8End   - utf8) <= feature.end)
-        {
-            hbFeatures.push_back({ (hb_tag_t)feature.tag, feature.value,
-                                   HB_FEATURE_GLOBAL_START, HB_FEATURE_GLOBAL_END});
-        } else {
-            hbFeatures.push_back({ (hb_tag_t)feature.tag, feature.value,
-                                   SkTo<unsigned>(feature.start), SkTo<unsigned>(feature.end)});
-        }
-    }
-
     hb_shape(hbFont.get(), buffer, hbFeatures.data(), hbFeatures.size());
     unsigned len = hb_buffer_get_length(buffer);
     if (len == 0) {
@@ -1389,6 +1591,9 @@ ShapedRun ShaperHarfBuzz::shape(char const * const utf8,
     }
     run.fAdvance = runAdvance;
 
+    if (cacheKey.isValid()) {
+        cache.add(*cacheKey, run);
+    }
     return run;
 }
 
@@ -1439,6 +1644,16 @@ SkShaper::MakeHbIcuScriptRunIterator(const char* utf8, size_t utf8Bytes) {
     return std::make_unique<HbIcuScriptRunIterator>(utf8, utf8Bytes);
 }
 
+SkShaper::ShapingCacheStats SkShaper::GetShapingCacheStats() {
+    return ShapeCache::Get().stats();
+}
+size_t SkShaper::SetShapingCacheLimit(size_t bytes) {
+    return ShapeCache::Get().setLimit(bytes);
+}
+void SkShaper::PurgeShapingCache() {
+    ShapeCache::Get().purge();
+}
+
 std::unique_ptr<SkShaper> SkShaper::MakeShaperDrivenWrapper(sk_sp<SkFontMgr> fontmgr) {
     return MakeHarfBuzz(std::move(fontmgr), true);
 }
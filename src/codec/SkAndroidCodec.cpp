@@ -8,10 +8,14 @@
 #include "include/codec/SkAndroidCodec.h"
 #include "include/codec/SkCodec.h"
 #include "include/core/SkPixmap.h"
+#include "include/private/SkMutex.h"
 #include "src/codec/SkAndroidCodecAdapter.h"
 #include "src/codec/SkCodecPriv.h"
 #include "src/codec/SkSampledCodec.h"
 #include "src/core/SkPixmapPriv.h"
+#include "src/core/SkTaskGroup.h"
+
+#include <vector>
 
 static bool is_valid_sample_size(int sampleSize) {
     // FIXME: As Leon has mentioned elsewhere, surely there is also a maximum sampleSize?
@@ -413,3 +417,60 @@ SkCodec::Result SkAndroidCodec::getAndroidPixels(const SkImageInfo& info, void*
         size_t rowBytes) {
     return this->getAndroidPixels(info, pixels, rowBytes, nullptr);
 }
+
+bool SkAndroidCodec::DecodeRegions(sk_sp<SkData> data, int sampleSize, Region regions[],
+                                   int count, SkExecutor* executor) {
+    std::unique_ptr<SkAndroidCodec> firstCodec = MakeFromData(data);
+    if (!firstCodec) {
+        return false;
+    }
+
+    // Codecs that are not decoding a region.
+    SkMutex mutex;
+    std::vector<std::unique_ptr<SkAndroidCodec>> idleCodecs;
+    idleCodecs.push_back(std::move(firstCodec));
+
+    auto decode_region = [&](int i) {
+        std::unique_ptr<SkAndroidCodec> codec;
+        {
+            SkAutoMutexExclusive lock(mutex);
+            if (!idleCodecs.empty()) {
+                codec = std::move(idleCodecs.back());
+                idleCodecs.pop_back();
+            }
+        }
+        if (!codec) {
+            codec = MakeFromData(data);
+        }
+
+        Region& region = regions[i];
+        if (!codec) {
+            region.fResult = SkCodec::kInternalError;
+            return;
+        }
+        if (region.fDst.dimensions() !=
+                codec->getSampledSubsetDimensions(sampleSize, region.fSubset)) {
+            region.fResult = SkCodec::kInvalidParameters;
+        } else {
+            SkIRect subset = region.fSubset;
+            AndroidOptions options;
+            options.fSubset = &subset;
+            options.fSampleSize = sampleSize;
+            region.fResult = codec->getAndroidPixels(region.fDst.info(),
+                                                     region.fDst.writable_addr(),
+                                                     region.fDst.rowBytes(), &options);
+        }
+
+        SkAutoMutexExclusive lock(mutex);
+        idleCodecs.push_back(std::move(codec));
+    };
+
+    if (executor) {
+        SkTaskGroup(*executor).batch(count, decode_region);
+    } else {
+        for (int i = 0; i < count; i++) {
+            decode_region(i);
+        }
+    }
+    return true;
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright 2020 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/private/SkNx.h"
+#include "src/codec/SkAreaResampler.h"
+
+#include <algorithm>
+
+// Source pixel i covers [i * dstSize, (i + 1) * dstSize) in units where each destination pixel
+// is srcSize wide, so that all the arithmetic is exact.  Returns the destination pixel it starts
+// in, and sets *units to how much of it lands there.  The rest lands in the next one.
+static int source_to_destination(int i, int srcSize, int dstSize, int64_t* units) {
+    const int64_t start = (int64_t)i * dstSize;
+    const int dst = (int)(start / srcSize);
+    *units = std::min(start + dstSize, (int64_t)(dst + 1) * srcSize) - start;
+    return dst;
+}
+
+SkAreaResampler::SkAreaResampler(SkISize srcDimensions, const SkPixmap& dst)
+    : fSrcDimensions(srcDimensions)
+    , fDst(dst)
+    , fUnpremul(kUnpremul_SkAlphaType == dst.alphaType())
+    , fDstX(srcDimensions.width())
+    , fWeightX(srcDimensions.width())
+    , fNextWeightX(srcDimensions.width())
+    , fRow(4 * (dst.width() + 1))
+    , fAccum(4 * dst.width())
+{
+    SkASSERT(4 == dst.info().bytesPerPixel());
+    SkASSERT(dst.width()  > 0 && dst.width()  <= srcDimensions.width());
+    SkASSERT(dst.height() > 0 && dst.height() <= srcDimensions.height());
+
+    for (int x = 0; x < srcDimensions.width(); x++) {
+        int64_t units;
+        fDstX[x] = source_to_destination(x, srcDimensions.width(), dst.width(), &units);
+        fWeightX[x]     = (float)units                 / srcDimensions.width();
+        fNextWeightX[x] = (float)(dst.width() - units) / srcDimensions.width();
+    }
+    sk_bzero(fAccum.get(), 4 * dst.width() * sizeof(float));
+}
+
+void SkAreaResampler::addRow(const uint32_t* row) {
+    if (fSrcY >= fSrcDimensions.height()) {
+        SkASSERT(false);
+        return;
+    }
+
+    // fRow has an extra entry so the last source column needs no special case.
+    const int dstWidth = fDst.width();
+    float* resampled = fRow.get();
+    sk_bzero(resampled, 4 * (dstWidth + 1) * sizeof(float));
+    for (int x = 0; x < fSrcDimensions.width(); x++) {
+        const Sk4f pixel = SkNx_cast<float>(Sk4b::Load(row + x));
+        float* dst = resampled + 4 * fDstX[x];
+        (Sk4f::Load(dst    ) + pixel * fWeightX[x]    ).store(dst    );
+        (Sk4f::Load(dst + 4) + pixel * fNextWeightX[x]).store(dst + 4);
+    }
+
+    int64_t units;
+    SkDEBUGCODE(int dy =) source_to_destination(fSrcY, fSrcDimensions.height(), fDst.height(),
+                                                &units);
+    SkASSERT(dy == fDstY);
+    const float weight = (float)units / fSrcDimensions.height();
+    for (int x = 0; x < dstWidth; x++) {
+        float* accum = fAccum.get() + 4 * x;
+        (Sk4f::Load(accum) + Sk4f::Load(resampled + 4 * x) * weight).store(accum);
+    }
+    fSrcY++;
+
+    // The destination row is done once the source rows reach its bottom edge.  The rest of
+    // this source row then belongs to the next destination row.
+    if ((int64_t)fSrcY * fDst.height() >= (int64_t)(fDstY + 1) * fSrcDimensions.height()) {
+        this->storeRow(fDstY++);
+        const float nextWeight = (float)(fDst.height() - units) / fSrcDimensions.height();
+        for (int x = 0; x < dstWidth; x++) {
+            (Sk4f::Load(resampled + 4 * x) * nextWeight).store(fAccum.get() + 4 * x);
+        }
+    }
+}
+
+void SkAreaResampler::storeRow(int y) {
+    uint32_t* dst = fDst.writable_addr32(0, y);
+    for (int x = 0; x < fDst.width(); x++) {
+        Sk4f pixel = Sk4f::Load(fAccum.get() + 4 * x);
+        if (fUnpremul) {
+            const float alpha = pixel[3];
+            const float scale = alpha > 0 ? 255 / alpha : 0;
+            pixel = Sk4f(pixel[0] * scale, pixel[1] * scale, pixel[2] * scale, alpha);
+        }
+        SkNx_cast<uint8_t>(Sk4f::Min(pixel + 0.5f, 255)).store(dst + x);
+    }
+}
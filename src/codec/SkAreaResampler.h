@@ -0,0 +1,62 @@
+/*
+ * Copyright 2020 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkAreaResampler_DEFINED
+#define SkAreaResampler_DEFINED
+
+#include "include/core/SkPixmap.h"
+#include "include/core/SkSize.h"
+#include "include/private/SkTemplates.h"
+
+/**
+ *  Downscales 32-bit pixels by averaging the area of the source under each destination pixel,
+ *  a row at a time as the source rows are decoded.  Only a few rows of the destination's width
+ *  are kept in memory.
+ *
+ *  The four channels are averaged independently, so the destination may be any 8888 format
+ *  that matches the source rows, with alpha last.  Averaging unpremultiplied colors would let
+ *  the colors of transparent pixels bleed into their neighbors, so if the destination is
+ *  unpremultiplied the source rows must be premultiplied, and are unpremultiplied as each
+ *  destination row is stored.
+ */
+class SkAreaResampler {
+public:
+    /**
+     *  |dst| must be no larger than |srcDimensions| in either direction, and have four bytes
+     *  per pixel.
+     */
+    SkAreaResampler(SkISize srcDimensions, const SkPixmap& dst);
+
+    /**
+     *  Adds the next row of the source, which is srcDimensions.width() pixels long.  Rows of
+     *  the destination are written as soon as all the source rows covering them are added.
+     */
+    void addRow(const uint32_t* row);
+
+private:
+    void storeRow(int y);
+
+    const SkISize    fSrcDimensions;
+    const SkPixmap   fDst;
+    const bool       fUnpremul;
+
+    // For each source column, the destination column it starts in, and the weights it has
+    // there and in the next column.
+    SkAutoTMalloc<int>      fDstX;
+    SkAutoTMalloc<float>    fWeightX;
+    SkAutoTMalloc<float>    fNextWeightX;
+
+    // The current source row, resampled horizontally, and the destination row being summed,
+    // with four floats per pixel.
+    SkAutoTMalloc<float>    fRow;
+    SkAutoTMalloc<float>    fAccum;
+
+    int                     fSrcY = 0;
+    int                     fDstY = 0;
+};
+
+#endif  // SkAreaResampler_DEFINED
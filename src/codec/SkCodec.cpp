@@ -9,6 +9,7 @@
 #include "include/core/SkColorSpace.h"
 #include "include/core/SkData.h"
 #include "include/private/SkHalf.h"
+#include "src/codec/SkAreaResampler.h"
 #include "src/codec/SkBmpCodec.h"
 #include "src/codec/SkCodecPriv.h"
 #include "src/codec/SkFrameHolder.h"
@@ -24,6 +25,7 @@
 #include "src/codec/SkRawCodec.h"
 #include "src/codec/SkWbmpCodec.h"
 #include "src/codec/SkWebpCodec.h"
+#include "src/core/SkAutoPixmapStorage.h"
 #ifdef SK_HAS_WUFFS_LIBRARY
 #include "src/codec/SkWuffsCodec.h"
 #elif defined(SK_USE_LIBGIFCODEC)
@@ -400,6 +402,81 @@ SkCodec::Result SkCodec::getPixels(const SkImageInfo& info, void* pixels, size_t
     return result;
 }
 
+// Returns the smallest size the codec can decode to natively that covers dstSize.
+static SkISize decode_size_for(const SkCodec& codec, SkISize dstSize) {
+    float scale = std::max((float)dstSize.width()  / codec.dimensions().width(),
+                           (float)dstSize.height() / codec.dimensions().height());
+    while (scale < 1.0f) {
+        SkISize size = codec.getScaledDimensions(scale);
+        if (size.width() >= dstSize.width() && size.height() >= dstSize.height()) {
+            return size;
+        }
+        scale += 1.0f / 32;
+    }
+    return codec.dimensions();
+}
+
+SkCodec::Result SkCodec::getResizedPixels(const SkPixmap& dst, const Options* options) {
+    if (kRGBA_8888_SkColorType != dst.colorType() && kBGRA_8888_SkColorType != dst.colorType()) {
+        return kInvalidConversion;
+    }
+    if (!dst.addr() || dst.width() <= 0 || dst.height() <= 0 ||
+        dst.rowBytes() < dst.info().minRowBytes()) {
+        return kInvalidParameters;
+    }
+    if (dst.width() > this->dimensions().width() || dst.height() > this->dimensions().height()) {
+        return kInvalidScale;
+    }
+
+    Options decodeOptions;
+    if (options) {
+        if (options->fSubset) {
+            return kUnimplemented;
+        }
+        decodeOptions = *options;
+    }
+    // The decoded rows are not dst, so they are never zero initialized.
+    decodeOptions.fZeroInitialized = kNo_ZeroInitialized;
+
+    const SkISize decodeSize = decode_size_for(*this, dst.dimensions());
+    if (decodeSize == dst.dimensions()) {
+        return this->getPixels(dst, &decodeOptions);
+    }
+
+    // Averaging needs premultiplied colors; the resampler unpremultiplies if dst is unpremul.
+    SkImageInfo decodeInfo = dst.info().makeDimensions(decodeSize);
+    if (kUnpremul_SkAlphaType == decodeInfo.alphaType()) {
+        decodeInfo = decodeInfo.makeAlphaType(kPremul_SkAlphaType);
+    }
+    SkAreaResampler resampler(decodeSize, dst);
+    Result result = this->startScanlineDecode(decodeInfo, &decodeOptions);
+    if (kSuccess == result && kTopDown_SkScanlineOrder == this->getScanlineOrder()) {
+        SkAutoTMalloc<uint32_t> row(decodeSize.width());
+        for (int y = 0; y < decodeSize.height(); y++) {
+            // getScanlines() fills in any rows it cannot decode, so dst is always filled.
+            if (1 != this->getScanlines(row.get(), 1, decodeInfo.minRowBytes())) {
+                result = kIncompleteInput;
+            }
+            resampler.addRow(row.get());
+        }
+        return result;
+    }
+
+    // Otherwise decode the whole image at decodeSize first.
+    SkAutoPixmapStorage decoded;
+    if (!decoded.tryAlloc(decodeInfo)) {
+        return kInternalError;
+    }
+    result = this->getPixels(decoded, &decodeOptions);
+    if (kSuccess != result && kIncompleteInput != result && kErrorInInput != result) {
+        return result;
+    }
+    for (int y = 0; y < decodeSize.height(); y++) {
+        resampler.addRow(decoded.addr32(0, y));
+    }
+    return result;
+}
+
 SkCodec::Result SkCodec::startIncrementalDecode(const SkImageInfo& info, void* pixels,
         size_t rowBytes, const SkCodec::Options* options) {
     fStartedIncrementalDecode = false;
@@ -16,8 +16,12 @@
 #include "src/codec/SkCodecPriv.h"
 #include "src/codec/SkJpegDecoderMgr.h"
 #include "src/codec/SkParseEncodedOrigin.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/pdf/SkJpegInfo.h"
 
+#include <atomic>
+#include <vector>
+
 // stdio is needed for libjpeg-turbo
 #include <stdio.h>
 #include "src/codec/SkJpegUtility.h"
@@ -502,6 +506,241 @@ int SkJpegCodec::readRows(const SkImageInfo& dstInfo, void* dst, size_t rowBytes
     return count;
 }
 
+namespace {
+
+// The entropy coded data of a single scan jpeg, split at its restart markers.
+struct JpegRestartIntervals {
+    size_t              fHeightOffset;  // Offset of the image height in the SOF segment.
+    size_t              fHeaderSize;    // Everything up to the end of the SOS segment.
+    std::vector<size_t> fStarts;        // Offset of the data of each interval.
+    std::vector<size_t> fEnds;          // Offset of the RST marker (or EOI) after each interval.
+};
+
+}  // namespace
+
+// Marker codes from ITU T.81 table B.1 that jpeglib.h does not define.
+static constexpr uint8_t kSOF0  = 0xC0;
+static constexpr uint8_t kSOF1  = 0xC1;
+static constexpr uint8_t kDHT   = 0xC4;
+static constexpr uint8_t kJPG   = 0xC8;
+static constexpr uint8_t kDAC   = 0xCC;
+static constexpr uint8_t kSOF15 = 0xCF;
+static constexpr uint8_t kRST7  = 0xD7;
+static constexpr uint8_t kSOS   = 0xDA;
+
+static bool find_restart_intervals(const uint8_t* data, size_t size, JpegRestartIntervals* out) {
+    auto read_u16 = [data](size_t offset) { return (data[offset] << 8) | data[offset + 1]; };
+
+    // Walk the marker segments up to the start of the scan.
+    out->fHeightOffset = 0;
+    size_t offset = 2;
+    while (true) {
+        while (offset + 1 < size && 0xFF == data[offset] && 0xFF == data[offset + 1]) {
+            offset++;
+        }
+        if (offset + 4 > size || 0xFF != data[offset]) {
+            return false;
+        }
+        uint8_t marker = data[offset + 1];
+        size_t length = read_u16(offset + 2);
+        if (length < 2 || offset + 2 + length > size) {
+            return false;
+        }
+        if (marker >= kSOF0 && marker <= kSOF15 && marker != kDHT && marker != kJPG &&
+            marker != kDAC) {
+            // Only baseline and extended sequential huffman coded images can be split.
+            if ((kSOF0 != marker && kSOF1 != marker) || length < 8) {
+                return false;
+            }
+            out->fHeightOffset = offset + 5;
+        }
+        offset += 2 + length;
+        if (kSOS == marker) {
+            break;
+        }
+    }
+    if (!out->fHeightOffset) {
+        return false;
+    }
+    out->fHeaderSize = offset;
+
+    // Find the restart markers in the scan. Any other marker (e.g. another scan, or DNL) means
+    // the image can't be split.
+    out->fStarts.assign(1, offset);
+    out->fEnds.clear();
+    while (true) {
+        const uint8_t* ff = (const uint8_t*)memchr(data + offset, 0xFF, size - offset);
+        if (!ff || ff + 1 >= data + size) {
+            return false;
+        }
+        offset = ff - data;
+        uint8_t marker = data[offset + 1];
+        if (0x00 == marker) {
+            offset += 2;
+        } else if (0xFF == marker) {
+            offset += 1;
+        } else if (marker >= JPEG_RST0 && marker <= kRST7) {
+            if (marker != JPEG_RST0 + (out->fEnds.size() & 7)) {
+                return false;
+            }
+            out->fEnds.push_back(offset);
+            offset += 2;
+            out->fStarts.push_back(offset);
+        } else if (JPEG_EOI == marker) {
+            out->fEnds.push_back(offset);
+            return true;
+        } else {
+            return false;
+        }
+    }
+}
+
+static uint64_t gcd(uint64_t a, uint64_t b) {
+    while (b) {
+        uint64_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+bool SkJpegCodec::decodeInParallel(const SkImageInfo& dstInfo, void* dst, size_t rowBytes,
+                                   const Options& options) {
+    // At most this many parts. Each part also decodes a group of rows on either side of it.
+    static constexpr int kMaxParts = 16;
+    static constexpr int kMinMCURowsPerPart = 8;
+
+    jpeg_decompress_struct* dinfo = fDecoderMgr->dinfo();
+    if (!dinfo->restart_interval || dinfo->progressive_mode ||
+        dinfo->comps_in_scan != dinfo->num_components || dinfo->scale_num != dinfo->scale_denom) {
+        return false;
+    }
+
+    SkStream* stream = this->stream();
+    const uint8_t* data = (const uint8_t*)stream->getMemoryBase();
+    if (!data || !stream->hasLength() || !IsJpeg(data, stream->getLength())) {
+        return false;
+    }
+    JpegRestartIntervals intervals;
+    if (!find_restart_intervals(data, stream->getLength(), &intervals)) {
+        return false;
+    }
+
+    int maxH = 1,
+        maxV = 1;
+    if (dinfo->num_components > 1) {
+        for (int i = 0; i < dinfo->num_components; i++) {
+            maxH = SkTMax(maxH, dinfo->comp_info[i].h_samp_factor);
+            maxV = SkTMax(maxV, dinfo->comp_info[i].v_samp_factor);
+        }
+    }
+    const int width = dinfo->image_width,
+              height = dinfo->image_height,
+              mcuHeight = maxV * DCTSIZE;
+    const uint64_t mcusPerRow = (width + maxH * DCTSIZE - 1) / (maxH * DCTSIZE),
+                   mcuRows = (height + mcuHeight - 1) / mcuHeight,
+                   interval = dinfo->restart_interval;
+    if (intervals.fStarts.size() != (mcusPerRow * mcuRows + interval - 1) / interval) {
+        return false;
+    }
+
+    // The image can only be split where a restart marker falls at the start of a row of MCUs,
+    // i.e. into groups of rows that each start a new interval.
+    const uint64_t groupMCUs = mcusPerRow / gcd(mcusPerRow, interval) * interval;
+    const int groupRows = SkToInt(groupMCUs / mcusPerRow),
+              intervalsPerGroup = SkToInt(groupMCUs / interval),
+              groups = SkToInt((mcuRows + groupRows - 1) / groupRows),
+              groupsPerPart = SkTMax((groups + kMaxParts - 1) / kMaxParts,
+                                     (kMinMCURowsPerPart + groupRows - 1) / groupRows),
+              parts = (groups + groupsPerPart - 1) / groupsPerPart;
+    if (parts < 2) {
+        return false;
+    }
+
+    const J_COLOR_SPACE outColorSpace = dinfo->out_color_space;
+    const J_DITHER_MODE ditherMode = dinfo->dither_mode;
+    const int intervalCount = SkToInt(intervals.fStarts.size());
+    const bool needsXformBuffer = this->colorXform() && sizeof(uint32_t) != dstInfo.bytesPerPixel();
+
+    // Each part is decoded from a jpeg of its own, made of the original header (with the height
+    // changed) and the part's intervals (with their restart markers renumbered). Upsampling
+    // looks at neighbouring rows, so each part also decodes the group of rows above and below
+    // it and discards them.
+    auto decode_part = [&](int part) {
+        const int firstGroup = part * groupsPerPart,
+                  endGroup = SkTMin(groups, firstGroup + groupsPerPart),
+                  decodeFirstGroup = SkTMax(0, firstGroup - 1),
+                  decodeEndGroup = SkTMin(groups, endGroup + 1),
+                  firstInterval = decodeFirstGroup * intervalsPerGroup,
+                  endInterval = SkTMin(intervalCount, decodeEndGroup * intervalsPerGroup);
+        const int top = decodeFirstGroup * groupRows * mcuHeight,
+                  bottom = SkTMin(height, decodeEndGroup * groupRows * mcuHeight),
+                  dstTop = firstGroup * groupRows * mcuHeight,
+                  dstBottom = SkTMin(height, endGroup * groupRows * mcuHeight);
+
+        const size_t start = intervals.fStarts[firstInterval],
+                     end = intervals.fEnds[endInterval - 1];
+        std::vector<uint8_t> jpeg(intervals.fHeaderSize + (end - start) + 2);
+        memcpy(jpeg.data(), data, intervals.fHeaderSize);
+        jpeg[intervals.fHeightOffset + 0] = (bottom - top) >> 8;
+        jpeg[intervals.fHeightOffset + 1] = (bottom - top) & 0xFF;
+        uint8_t* scan = jpeg.data() + intervals.fHeaderSize;
+        memcpy(scan, data + start, end - start);
+        for (int i = firstInterval; i < endInterval - 1; i++) {
+            scan[intervals.fEnds[i] - start + 1] = JPEG_RST0 + ((i - firstInterval) & 7);
+        }
+        jpeg[jpeg.size() - 2] = 0xFF;
+        jpeg[jpeg.size() - 1] = JPEG_EOI;
+
+        SkMemoryStream partStream(jpeg.data(), jpeg.size(), false);
+        JpegDecoderMgr decoderMgr(&partStream);
+        SkAutoTMalloc<uint8_t> storage(needsXformBuffer ? width * sizeof(uint32_t)
+                                                        : dstInfo.minRowBytes());
+
+        skjpeg_error_mgr::AutoPushJmpBuf jmp(decoderMgr.errorMgr());
+        if (setjmp(jmp)) {
+            return false;
+        }
+        decoderMgr.init();
+        jpeg_decompress_struct* partInfo = decoderMgr.dinfo();
+        if (JPEG_HEADER_OK != jpeg_read_header(partInfo, true)) {
+            return false;
+        }
+        partInfo->out_color_space = outColorSpace;
+        partInfo->dither_mode = ditherMode;
+        if (!jpeg_start_decompress(partInfo)) {
+            return false;
+        }
+
+        JSAMPLE* discard = (JSAMPLE*)storage.get();
+        for (int y = top; y < dstTop; y++) {
+            if (1 != jpeg_read_scanlines(partInfo, &discard, 1)) {
+                return false;
+            }
+        }
+        for (int y = dstTop; y < dstBottom; y++) {
+            void* dstRow = SkTAddOffset<void>(dst, y * rowBytes);
+            JSAMPLE* decodeDst = needsXformBuffer ? (JSAMPLE*)storage.get() : (JSAMPLE*)dstRow;
+            if (1 != jpeg_read_scanlines(partInfo, &decodeDst, 1)) {
+                return false;
+            }
+            if (this->colorXform()) {
+                this->applyColorXform(dstRow, decodeDst, width);
+            }
+        }
+        jpeg_abort_decompress(partInfo);
+        return true;
+    };
+
+    std::atomic<bool> success{true};
+    SkTaskGroup(*options.fExecutor).batch(parts, [&](int part) {
+        if (!decode_part(part)) {
+            success = false;
+        }
+    });
+    return success;
+}
+
 /*
  * This is a bit tricky.  We only need the swizzler to do format conversion if the jpeg is
  * encoded as CMYK.
@@ -534,6 +773,15 @@ SkCodec::Result SkJpegCodec::onGetPixels(const SkImageInfo& dstInfo,
     // Get a pointer to the decompress info since we will use it quite frequently
     jpeg_decompress_struct* dinfo = fDecoderMgr->dinfo();
 
+    // If a part fails to decode, fall back to decoding serially, which reports how far it got.
+    if (options.fExecutor &&
+        !needs_swizzler_to_convert_from_cmyk(dinfo->out_color_space,
+                                             this->getEncodedInfo().profile(),
+                                             this->colorXform()) &&
+        this->decodeInParallel(dstInfo, dst, dstRowBytes, options)) {
+        return kSuccess;
+    }
+
     // Set the jump location for libjpeg errors
     skjpeg_error_mgr::AutoPushJmpBuf jmp(fDecoderMgr->errorMgr());
     if (setjmp(jmp)) {
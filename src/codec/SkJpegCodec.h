@@ -109,6 +109,14 @@ private:
     void allocateStorage(const SkImageInfo& dstInfo);
     int readRows(const SkImageInfo& dstInfo, void* dst, size_t rowBytes, int count, const Options&);
 
+    /*
+     * Splits the image at its restart markers and decodes the parts on options.fExecutor.
+     * Returns false if the image cannot be split, or if any part fails to decode, in which
+     * case the caller should decode serially.
+     */
+    bool decodeInParallel(const SkImageInfo& dstInfo, void* dst, size_t rowBytes,
+                          const Options& options);
+
     /*
      * Scanline decoding.
      */
@@ -213,6 +213,83 @@ bool SkWebpCodec::onGetValidSubset(SkIRect* desiredSubset) const {
     return true;
 }
 
+bool SkWebpCodec::onQueryYUV8(SkYUVASizeInfo* sizeInfo, SkYUVColorSpace* colorSpace) const {
+    // Lossy WebP is stored as 4:2:0 YUV, so an opaque, still image can be handed out without
+    // converting to RGB.  Lossless images are RGB, and alpha would need a fourth plane.
+    if (SkEncodedInfo::kYUV_Color != this->getEncodedInfo().color() ||
+            (WebPDemuxGetI(fDemux.get(), WEBP_FF_FORMAT_FLAGS) & ANIMATION_FLAG)) {
+        return false;
+    }
+
+    const int width  = this->dimensions().width(),
+              height = this->dimensions().height();
+    sizeInfo->fSizes[0].set(width, height);
+    sizeInfo->fSizes[1].set((width + 1) / 2, (height + 1) / 2);
+    sizeInfo->fSizes[2] = sizeInfo->fSizes[1];
+    for (int i = 0; i < 3; ++i) {
+        sizeInfo->fWidthBytes[i] = SkAlign8(sizeInfo->fSizes[i].width());
+    }
+    sizeInfo->fSizes[3].fHeight = sizeInfo->fSizes[3].fWidth = sizeInfo->fWidthBytes[3] = 0;
+
+    sizeInfo->fOrigin = this->getOrigin();
+
+    if (colorSpace) {
+        // VP8 uses the BT.601 "studio swing" coefficients.
+        *colorSpace = kRec601_SkYUVColorSpace;
+    }
+
+    return true;
+}
+
+SkCodec::Result SkWebpCodec::onGetYUV8Planes(const SkYUVASizeInfo& sizeInfo,
+                                             void* planes[SkYUVASizeInfo::kMaxCount]) {
+    SkYUVASizeInfo defaultInfo;
+    if (!this->onQueryYUV8(&defaultInfo, nullptr) ||
+            sizeInfo.fSizes[0] != defaultInfo.fSizes[0] ||
+            sizeInfo.fSizes[1] != defaultInfo.fSizes[1] ||
+            sizeInfo.fSizes[2] != defaultInfo.fSizes[2] ||
+            sizeInfo.fWidthBytes[0] < defaultInfo.fWidthBytes[0] ||
+            sizeInfo.fWidthBytes[1] < defaultInfo.fWidthBytes[1] ||
+            sizeInfo.fWidthBytes[2] < defaultInfo.fWidthBytes[2]) {
+        return kInvalidInput;
+    }
+
+    WebPDecoderConfig config;
+    if (0 == WebPInitDecoderConfig(&config)) {
+        // ABI mismatch.
+        return kInvalidInput;
+    }
+
+    // Free any memory associated with the buffer. Must be called last, so we declare it first.
+    SkAutoTCallVProc<WebPDecBuffer, WebPFreeDecBuffer> autoFree(&(config.output));
+
+    WebPIterator frame;
+    SkAutoTCallVProc<WebPIterator, WebPDemuxReleaseIterator> autoFrame(&frame);
+    if (!WebPDemuxGetFrame(fDemux, 1, &frame)) {
+        return kInvalidInput;
+    }
+
+    // libwebp writes straight into the client's planes.
+    config.output.colorspace = MODE_YUV;
+    config.output.is_external_memory = 1;
+    WebPYUVABuffer& yuv = config.output.u.YUVA;
+    yuv.y = reinterpret_cast<uint8_t*>(planes[0]);
+    yuv.u = reinterpret_cast<uint8_t*>(planes[1]);
+    yuv.v = reinterpret_cast<uint8_t*>(planes[2]);
+    yuv.y_stride = SkToInt(sizeInfo.fWidthBytes[0]);
+    yuv.u_stride = SkToInt(sizeInfo.fWidthBytes[1]);
+    yuv.v_stride = SkToInt(sizeInfo.fWidthBytes[2]);
+    yuv.y_size = sizeInfo.fWidthBytes[0] * sizeInfo.fSizes[0].height();
+    yuv.u_size = sizeInfo.fWidthBytes[1] * sizeInfo.fSizes[1].height();
+    yuv.v_size = sizeInfo.fWidthBytes[2] * sizeInfo.fSizes[2].height();
+
+    // FIXME: Handle incomplete YUV decodes without signalling an error.
+    if (VP8_STATUS_OK != WebPDecode(frame.fragment.bytes, frame.fragment.size, &config)) {
+        return kInvalidInput;
+    }
+    return kSuccess;
+}
+
 int SkWebpCodec::onGetRepetitionCount() {
     auto flags = WebPDemuxGetI(fDemux.get(), WEBP_FF_FORMAT_FLAGS);
     if (!(flags & ANIMATION_FLAG)) {
@@ -10,6 +10,7 @@
 #include "include/core/SkTypeface.h"
 #include "include/private/SkTemplates.h"
 #include "include/private/SkTo.h"
+#include "include/private/SkVx.h"
 #include "src/core/SkDraw.h"
 #include "src/core/SkFontPriv.h"
 #include "src/core/SkPaintDefaults.h"
@@ -161,16 +162,42 @@ public:
                 uni = fStorage.reset(byteLength);
                 const char* ptr = (const char*)text;
                 const char* end = ptr + byteLength;
-                for (int i = 0; ptr < end; ++i) {
-                    fStorage[i] = SkUTF::NextUTF8(&ptr, end);
+                const char* nextBlock = ptr;
+                SkUnichar* dst = fStorage.get();
+                while (ptr < end) {
+                    // Widen ASCII 16 bytes at a time. Other blocks are decoded one at a time.
+                    if (ptr >= nextBlock && end - ptr >= 16) {
+                        auto bytes = skvx::Vec<16, uint8_t>::Load(ptr);
+                        if (!any(bytes & 0x80)) {
+                            skvx::cast<SkUnichar>(bytes).store(dst);
+                            ptr += 16;
+                            dst += 16;
+                            continue;
+                        }
+                        nextBlock = ptr + 16;
+                    }
+                    *dst++ = SkUTF::NextUTF8(&ptr, end);
                 }
             } break;
             case SkTextEncoding::kUTF16: {
                 uni = fStorage.reset(byteLength);
                 const uint16_t* ptr = (const uint16_t*)text;
                 const uint16_t* end = ptr + (byteLength >> 1);
-                for (int i = 0; ptr < end; ++i) {
-                    fStorage[i] = SkUTF::NextUTF16(&ptr, end);
+                const uint16_t* nextBlock = ptr;
+                SkUnichar* dst = fStorage.get();
+                while (ptr < end) {
+                    // Widen 16 code units at a time if none are surrogates.
+                    if (ptr >= nextBlock && end - ptr >= 16) {
+                        auto units = skvx::Vec<16, uint16_t>::Load(ptr);
+                        if (!any((units & 0xF800) == 0xD800)) {
+                            skvx::cast<SkUnichar>(units).store(dst);
+                            ptr += 16;
+                            dst += 16;
+                            continue;
+                        }
+                        nextBlock = ptr + 16;
+                    }
+                    *dst++ = SkUTF::NextUTF16(&ptr, end);
                 }
             } break;
             case SkTextEncoding::kUTF32:
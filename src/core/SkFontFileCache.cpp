@@ -0,0 +1,110 @@
+/*
+ * Copyright 2020 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/core/SkFontFileCache.h"
+
+#include "include/core/SkString.h"
+#include "include/private/SkMutex.h"
+#include "include/private/SkTArray.h"
+#include "include/private/SkTHash.h"
+#include "src/core/SkOSFile.h"
+
+namespace {
+
+struct Mapping {
+    SkFileStamp   fStamp;
+    sk_sp<SkData> fData;
+};
+
+// How many files no typeface is using may stay mapped.
+constexpr int kMaxUnusedMappings = 32;
+
+struct Cache {
+    SkMutex                       fMutex;
+    SkTHashMap<SkString, Mapping> fMappings;
+
+    void purgeUnused(int keep) {
+        fMutex.assertHeld();
+        int unused = 0;
+        fMappings.foreach([&](const SkString&, Mapping* mapping) {
+            unused += mapping->fData->unique();
+        });
+        if (unused <= keep) {
+            return;
+        }
+        SkTArray<SkString> purge;
+        fMappings.foreach([&](const SkString& path, Mapping* mapping) {
+            if (unused > keep && mapping->fData->unique()) {
+                purge.push_back(path);
+                unused--;
+            }
+        });
+        for (const SkString& path : purge) {
+            fMappings.remove(path);
+        }
+    }
+};
+
+Cache& cache() {
+    static Cache* cache = new Cache;
+    return *cache;
+}
+
+}  // namespace
+
+sk_sp<SkData> SkFontFileCache::Find(const char path[]) {
+    FILE* file = sk_fopen(path, kRead_SkFILE_Flag);
+    if (!file) {
+        return nullptr;
+    }
+    // Files replaced or rewritten in place get a new stamp, even within the same second.
+    SkFileStamp stamp;
+    const bool stamped = sk_fstamp(file, &stamp);
+    const size_t size = sk_fgetsize(file);
+
+    Cache& c = cache();
+    SkString key(path);
+    {
+        SkAutoMutexExclusive lock(c.fMutex);
+        if (Mapping* mapping = c.fMappings.find(key)) {
+            if (stamped && mapping->fStamp == stamp && mapping->fData->size() == size) {
+                sk_fclose(file);
+                return mapping->fData;
+            }
+        }
+    }
+
+    sk_sp<SkData> data = SkData::MakeFromFILE(file);
+    sk_fclose(file);
+    if (!data || !stamped) {
+        return data;
+    }
+
+    SkAutoMutexExclusive lock(c.fMutex);
+    // Another thread may have mapped the file while this one did; use the first mapping.
+    if (Mapping* mapping = c.fMappings.find(key)) {
+        if (mapping->fStamp == stamp && mapping->fData->size() == data->size()) {
+            return mapping->fData;
+        }
+    }
+    c.fMappings.set(std::move(key), Mapping{stamp, data});
+    c.purgeUnused(kMaxUnusedMappings);
+    return data;
+}
+
+std::unique_ptr<SkStreamAsset> SkFontFileCache::MakeStream(const char path[]) {
+    if (sk_sp<SkData> data = Find(path)) {
+        return std::make_unique<SkMemoryStream>(std::move(data));
+    }
+    return SkStream::MakeFromFile(path);
+}
+
+void SkFontFileCache::PurgeUnused() {
+    Cache& c = cache();
+    SkAutoMutexExclusive lock(c.fMutex);
+    c.purgeUnused(0);
+}
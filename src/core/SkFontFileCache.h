@@ -0,0 +1,38 @@
+/*
+ * Copyright 2020 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkFontFileCache_DEFINED
+#define SkFontFileCache_DEFINED
+
+#include "include/core/SkData.h"
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkStream.h"
+
+#include <memory>
+
+/**
+ *  A process wide cache of memory mapped font files.
+ *
+ *  Each file is mapped once and shared by every typeface opened on it, whichever SkFontMgr made
+ *  the typeface, for as long as the file keeps the same size and modification time. Mappings no
+ *  typeface is using are kept, up to a limit, so a font which is opened again is not remapped.
+ */
+class SkFontFileCache {
+public:
+    /** Returns the contents of the file at path, or nullptr if it cannot be mapped. */
+    static sk_sp<SkData> Find(const char path[]);
+
+    /** Returns a stream over the shared contents of the file at path if it can be mapped,
+     *  otherwise the same as SkStream::MakeFromFile.
+     */
+    static std::unique_ptr<SkStreamAsset> MakeStream(const char path[]);
+
+    /** Unmaps every file which is no longer in use. Called by SkGraphics::PurgeFontCache(). */
+    static void PurgeUnused();
+};
+
+#endif
@@ -9,6 +9,7 @@
 #include "src/core/SkAutoMalloc.h"
 #include "src/core/SkEndian.h"
 #include "src/core/SkFontStream.h"
+#include "src/core/SkUtils.h"
 
 struct SkSFNTHeader {
     uint32_t    fVersion;
@@ -209,3 +210,39 @@ size_t SkFontStream::GetTableData(SkStream* stream, int ttcIndex,
     }
     return 0;
 }
+
+bool SkFontStream::FindTable(const void* data, size_t size, int ttcIndex, SkFontTableTag tag,
+                             size_t* tableOffset, size_t* tableLength) {
+    // Other formats (such as WOFF) have a different directory, or none at all.
+    if (size < sizeof(uint32_t)) {
+        return false;
+    }
+    const uint32_t version = SkEndian_SwapBE32(sk_unaligned_load<uint32_t>(data));
+    if (version != 0x00010000 &&
+        version != SkSetFourByteTag('O', 'T', 'T', 'O') &&
+        version != SkSetFourByteTag('t', 'r', 'u', 'e') &&
+        version != SkSetFourByteTag('t', 't', 'c', 'f'))
+    {
+        return false;
+    }
+
+    SkMemoryStream stream(data, size, false);
+    SfntHeader  header;
+    if (!header.init(&stream, ttcIndex)) {
+        return false;
+    }
+
+    for (int i = 0; i < header.fCount; i++) {
+        if (SkEndian_SwapBE32(header.fDir[i].fTag) == tag) {
+            size_t offset = SkEndian_SwapBE32(header.fDir[i].fOffset);
+            size_t length = SkEndian_SwapBE32(header.fDir[i].fLength);
+            if (offset > size || length > size - offset) {
+                return false;
+            }
+            *tableOffset = offset;
+            *tableLength = length;
+            return true;
+        }
+    }
+    return false;
+}
@@ -44,6 +44,15 @@ public:
     static size_t GetTableSize(SkStream* stream, int ttcIndex, SkFontTableTag tag) {
         return GetTableData(stream, ttcIndex, tag, 0, ~0U, nullptr);
     }
+
+    /**
+     *  Finds a table in an sfnt held in memory, for sharing rather than copying it.
+     *
+     *  @param ttcIndex 0 for normal sfnts, or the index within a TTC sfnt.
+     *  @return false if there is no such table, or it is not entirely within the data.
+     */
+    static bool FindTable(const void* data, size_t size, int ttcIndex, SkFontTableTag tag,
+                          size_t* tableOffset, size_t* tableLength);
 };
 
 #endif
@@ -114,16 +114,20 @@ bool SkGlyph::setImage(SkArenaAlloc* alloc, const void* image) {
     return false;
 }
 
+void SkGlyph::setMetrics(const SkGlyph& from) {
+    fAdvanceX = from.fAdvanceX;
+    fAdvanceY = from.fAdvanceY;
+    fWidth = from.fWidth;
+    fHeight = from.fHeight;
+    fTop = from.fTop;
+    fLeft = from.fLeft;
+    fForceBW = from.fForceBW;
+    fMaskFormat = from.fMaskFormat;
+}
+
 bool SkGlyph::setMetricsAndImage(SkArenaAlloc* alloc, const SkGlyph& from) {
     if (fImage == nullptr) {
-        fAdvanceX = from.fAdvanceX;
-        fAdvanceY = from.fAdvanceY;
-        fWidth = from.fWidth;
-        fHeight = from.fHeight;
-        fTop = from.fTop;
-        fLeft = from.fLeft;
-        fForceBW = from.fForceBW;
-        fMaskFormat = from.fMaskFormat;
+        this->setMetrics(from);
 
         // From glyph may not have an image because the glyph is too large.
         return from.fImage != nullptr && this->setImage(alloc, from.image());
@@ -131,6 +135,15 @@ bool SkGlyph::setMetricsAndImage(SkArenaAlloc* alloc, const SkGlyph& from) {
     return false;
 }
 
+bool SkGlyph::setMetricsAndSharedImage(const SkGlyph& from) {
+    if (fImage == nullptr) {
+        this->setMetrics(from);
+        fImage = from.fImage;
+        return fImage != nullptr;
+    }
+    return false;
+}
+
 size_t SkGlyph::rowBytes() const {
     return format_rowbytes(fWidth, (SkMask::Format)fMaskFormat);
 }
@@ -219,6 +219,10 @@ public:
     // using the alloc.
     bool setMetricsAndImage(SkArenaAlloc* alloc, const SkGlyph& from);
 
+    // Like setMetricsAndImage, but use the from glyph's image in place instead of copying it. The
+    // owner of the image must keep it alive as long as this glyph.
+    bool setMetricsAndSharedImage(const SkGlyph& from);
+
     // Returns true if the image has been set.
     bool setImageHasBeenCalled() const {
         return fImage != nullptr || this->isEmpty() || this->imageTooLarge();
@@ -294,6 +298,7 @@ private:
     friend class SkScalerContext_DW;
     friend class SkScalerContext_GDI;
     friend class SkScalerContext_Mac;
+    friend class SkGlyphDiskCache;
     friend class SkStrikeClient;
     friend class SkStrikeServer;
     friend class SkTestScalerContext;
@@ -322,6 +327,9 @@ private:
 
     size_t allocImage(SkArenaAlloc* alloc);
 
+    // Copy everything but the ID, image and path from the from glyph.
+    void setMetrics(const SkGlyph& from);
+
     // path == nullptr indicates that there is no path.
     void installPath(SkArenaAlloc* alloc, const SkPath* path);
 
@@ -0,0 +1,436 @@
+/*
+ * Copyright 2020 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/core/SkGlyphDiskCache.h"
+
+#include "include/core/SkFontArguments.h"
+#include "include/core/SkMilestone.h"
+#include "include/core/SkPath.h"
+#include "include/core/SkStream.h"
+#include "include/core/SkTypeface.h"
+#include "include/private/SkSemaphore.h"
+#include "include/private/SkTo.h"
+#include "src/core/SkAutoMalloc.h"
+#include "src/core/SkDescriptor.h"
+#include "src/core/SkOSFile.h"
+#include "src/core/SkOpts.h"
+#include "src/core/SkStrike.h"
+#include "src/utils/SkOSPath.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <map>
+
+static const char     kMagic[] = { 's', 'k', 'g', 'l', 'y', 'p', 'h', 's' };
+static const uint32_t kVersion = 1;
+static const char     kSuffix[] = ".glyphs";
+
+using Header = SkGlyphDiskCache::FileHeader;
+using Glyph  = SkGlyphDiskCache::FileGlyph;
+
+static uint64_t now_ms() {
+    using namespace std::chrono;
+    return duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count();
+}
+
+// -- Entry ----------------------------------------------------------------------------------------
+auto SkGlyphDiskCache::Entry::find(SkPackedGlyphID id) const -> const FileGlyph* {
+    const Glyph* end = fGlyphs + fGlyphCount;
+    const Glyph* glyph = std::lower_bound(fGlyphs, end, id.value(),
+            [](const Glyph& g, uint32_t value) { return g.fID < value; });
+    return glyph != end && glyph->fID == id.value() ? glyph : nullptr;
+}
+
+bool SkGlyphDiskCache::Entry::metrics(SkPackedGlyphID id, SkGlyphPrototype* prototype) const {
+    const Glyph* glyph = this->find(id);
+    if (!glyph) {
+        return false;
+    }
+    prototype->id         = id;
+    prototype->advanceX   = glyph->fAdvanceX;
+    prototype->advanceY   = glyph->fAdvanceY;
+    prototype->width      = glyph->fWidth;
+    prototype->height     = glyph->fHeight;
+    prototype->left       = glyph->fLeft;
+    prototype->top        = glyph->fTop;
+    prototype->maskFormat = (SkMask::Format)glyph->fMaskFormat;
+    prototype->forceBW    = SkToBool(glyph->fFlags & Glyph::kForceBW);
+    return true;
+}
+
+const void* SkGlyphDiskCache::Entry::image(const SkGlyph& glyph) const {
+    const Glyph* saved = this->find(glyph.getPackedID());
+    if (!saved || !(saved->fFlags & Glyph::kImage) || saved->fImageSize != glyph.imageSize()) {
+        return nullptr;
+    }
+    return fData->bytes() + saved->fImageOffset;
+}
+
+bool SkGlyphDiskCache::Entry::path(SkPackedGlyphID id, bool* hasPath, SkPath* path) const {
+    const Glyph* saved = this->find(id);
+    if (!saved || !(saved->fFlags & Glyph::kPathAsked)) {
+        return false;
+    }
+    *hasPath = false;
+    if (saved->fFlags & Glyph::kPath) {
+        if (path->readFromMemory(fData->bytes() + saved->fPathOffset, saved->fPathSize) == 0) {
+            return false;
+        }
+        *hasPath = true;
+    }
+    return true;
+}
+
+// -- Lookup -------------------------------------------------------------------------------------
+SkGlyphDiskCache::Lookup::Lookup(std::unique_ptr<SkDescriptor> desc, sk_sp<SkTypeface> typeface)
+    : fDesc{std::move(desc)}
+    , fTypeface{std::move(typeface)} {}
+
+// -- SkGlyphDiskCache -----------------------------------------------------------------------------
+static SkMutex& disk_cache_mutex() {
+    static SkMutex& mutex = *(new SkMutex);
+    return mutex;
+}
+static sk_sp<SkGlyphDiskCache>* gDiskCache;
+
+sk_sp<SkGlyphDiskCache> SkGlyphDiskCache::Get() {
+    SkAutoMutexExclusive ac(disk_cache_mutex());
+    return gDiskCache ? *gDiskCache : nullptr;
+}
+
+bool SkGlyphDiskCache::SetDirectory(const char path[], size_t maxBytes) {
+    sk_sp<SkGlyphDiskCache> cache;
+    bool ok = true;
+    if (path && maxBytes > 0) {
+        ok = sk_isdir(path) || sk_mkdir(path);
+        if (ok) {
+            cache = sk_make_sp<SkGlyphDiskCache>(path, maxBytes);
+        }
+    }
+
+    {
+        SkAutoMutexExclusive ac(disk_cache_mutex());
+        if (!gDiskCache) {
+            gDiskCache = new sk_sp<SkGlyphDiskCache>;
+        }
+        std::swap(*gDiskCache, cache);
+    }
+    // Wait for the old cache's writes without holding up Get().
+    if (cache) {
+        cache->flush();
+    }
+    return ok;
+}
+
+SkGlyphDiskCache::SkGlyphDiskCache(const char path[], size_t maxBytes)
+    : fPath{path}
+    , fMaxBytes{maxBytes}
+    , fThread{SkExecutor::MakeFIFOThreadPool(1)} {}
+
+SkGlyphDiskCache::~SkGlyphDiskCache() {
+    // Finish reading and writing before anything the queued work uses goes away.
+    fThread.reset();
+}
+
+void SkGlyphDiskCache::runLater(std::function<void(void)> work) {
+    fThread->add(std::move(work));
+}
+
+void SkGlyphDiskCache::flush() {
+    // There is only one thread, so work runs in the order it was queued.
+    SkSemaphore done;
+    fThread->add([&done] { done.signal(); });
+    done.wait();
+}
+
+sk_sp<SkGlyphDiskCache::Lookup> SkGlyphDiskCache::findLater(const SkDescriptor& desc,
+                                                            const SkTypeface& typeface) {
+    sk_sp<Lookup> lookup(new Lookup{desc.copy(), sk_ref_sp(&typeface)});
+    this->runLater([this, lookup] {
+        lookup->fEntry = this->find(*lookup->fDesc, *lookup->fTypeface);
+        lookup->fDesc = nullptr;
+        lookup->fTypeface = nullptr;
+        lookup->fDone.store(true, std::memory_order_release);
+    });
+    return lookup;
+}
+
+std::vector<uint8_t> SkGlyphDiskCache::MakeKey(const SkDescriptor& desc,
+                                               const SkTypeface& typeface) {
+    // The 'head' table has the font's checksum and creation and modification dates, which is
+    // as close to an identity as fonts have. Typefaces without one (like proxies for remote
+    // typefaces) aren't cached.
+    static constexpr SkFontTableTag kHead = SkSetFourByteTag('h', 'e', 'a', 'd');
+    const size_t headSize = typeface.getTableSize(kHead);
+    if (headSize == 0 || headSize > 1024) {
+        return {};
+    }
+    std::vector<uint8_t> key(headSize);
+    if (typeface.getTableData(kHead, 0, headSize, key.data()) != headSize) {
+        return {};
+    }
+
+    // Variable fonts share a 'head' table between instances.
+    const int axisCount = typeface.getVariationDesignPosition(nullptr, 0);
+    if (axisCount > 0) {
+        std::vector<SkFontArguments::VariationPosition::Coordinate> coords(axisCount);
+        if (typeface.getVariationDesignPosition(coords.data(), axisCount) == axisCount) {
+            const auto* bytes = reinterpret_cast<const uint8_t*>(coords.data());
+            key.insert(key.end(), bytes, bytes + axisCount * sizeof(coords[0]));
+        }
+    }
+
+    // The font ID differs between processes; the identity above replaces it.
+    std::unique_ptr<SkDescriptor> copy = desc.copy();
+    uint32_t recSize;
+    auto* rec = (SkScalerContextRec*)copy->findEntry(kRec_SkDescriptorTag, &recSize);
+    if (!rec) {
+        return {};
+    }
+    rec->fFontID = 0;
+    copy->computeChecksum();
+    const auto* bytes = reinterpret_cast<const uint8_t*>(copy.get());
+    key.insert(key.end(), bytes, bytes + copy->getLength());
+
+    key.resize(SkAlign4(key.size()));
+    return key;
+}
+
+SkString SkGlyphDiskCache::pathForKey(const std::vector<uint8_t>& key) const {
+    const uint32_t hi = SkOpts::hash(key.data(), key.size(), 0),
+                   lo = SkOpts::hash(key.data(), key.size(), 0x9e3779b9);
+    SkString name = SkStringPrintf("%08x%08x%s", hi, lo, kSuffix);
+    return SkOSPath::Join(fPath.c_str(), name.c_str());
+}
+
+sk_sp<SkGlyphDiskCache::Entry> SkGlyphDiskCache::find(const SkDescriptor& desc,
+                                                      const SkTypeface& typeface) const {
+    std::vector<uint8_t> key = MakeKey(desc, typeface);
+    if (key.empty()) {
+        return nullptr;
+    }
+    sk_sp<SkData> data = SkData::MakeFromFileName(this->pathForKey(key).c_str());
+    if (!data || data->size() < sizeof(Header)) {
+        return nullptr;
+    }
+
+    Header header;
+    memcpy(&header, data->data(), sizeof(header));
+    const size_t glyphsOffset = sizeof(Header) + header.fKeySize;
+    if (0 != memcmp(header.fMagic, kMagic, sizeof(kMagic)) ||
+        header.fVersion != kVersion ||
+        header.fMilestone != SK_MILESTONE ||
+        header.fKeySize != key.size() ||
+        data->size() < glyphsOffset ||
+        (data->size() - glyphsOffset) / sizeof(Glyph) < header.fGlyphCount ||
+        0 != memcmp(data->bytes() + sizeof(Header), key.data(), key.size())) {
+        return nullptr;
+    }
+
+    // Check everything up front, so lookups can trust the file.
+    const auto* glyphs = reinterpret_cast<const Glyph*>(data->bytes() + glyphsOffset);
+    auto in_file = [&](uint32_t offset, uint32_t size) {
+        return offset <= data->size() && size <= data->size() - offset;
+    };
+    for (uint32_t i = 0; i < header.fGlyphCount; i++) {
+        const Glyph& glyph = glyphs[i];
+        if ((i > 0 && glyphs[i - 1].fID >= glyph.fID) ||
+            glyph.fMaskFormat >= SkMask::kCountMaskFormats ||
+            !in_file(glyph.fImageOffset, glyph.fImageSize) ||
+            !in_file(glyph.fPathOffset, glyph.fPathSize)) {
+            return nullptr;
+        }
+    }
+
+    return sk_sp<Entry>(new Entry{std::move(data), glyphs, SkToInt(header.fGlyphCount)});
+}
+
+bool SkGlyphDiskCache::save(const SkStrike& strike) {
+    const SkTypeface* typeface = strike.getScalerContext()->getTypeface();
+    std::vector<uint8_t> key = MakeKey(strike.getDescriptor(), *typeface);
+    if (key.empty()) {
+        return false;
+    }
+
+    // Everything the strike has, plus anything it was created with but never used.
+    struct Source {
+        const SkGlyph* fGlyph = nullptr;
+        const Glyph*   fSaved = nullptr;
+    };
+    std::map<uint32_t, Source> sources;
+    strike.forEachGlyph([&](const SkGlyph& glyph) {
+        // Glyphs with only their advances are cheap, and can't be stored with full metrics.
+        if (glyph.maskFormat() != MASK_FORMAT_UNKNOWN) {
+            sources[glyph.getPackedID().value()].fGlyph = &glyph;
+        }
+    });
+    const Entry* entry = strike.diskCacheEntry();
+    if (entry) {
+        for (int i = 0; i < entry->fGlyphCount; i++) {
+            sources[entry->fGlyphs[i].fID].fSaved = &entry->fGlyphs[i];
+        }
+    }
+
+    SkDynamicMemoryWStream glyphData;
+    std::vector<Glyph> glyphs;
+    const size_t dataOffset = sizeof(Header) + key.size() + sources.size() * sizeof(Glyph);
+    for (const auto& [id, source] : sources) {
+        Glyph glyph;
+        memset(&glyph, 0, sizeof(glyph));
+        glyph.fID = id;
+
+        const void* image = nullptr;
+        size_t imageSize = 0;
+        bool pathAsked = false;
+        const SkPath* path = nullptr;
+        SkPath savedPath;
+        if (source.fGlyph) {
+            const SkGlyph& g = *source.fGlyph;
+            glyph.fAdvanceX   = g.advanceX();
+            glyph.fAdvanceY   = g.advanceY();
+            glyph.fWidth      = g.width();
+            glyph.fHeight     = g.height();
+            glyph.fLeft       = g.left();
+            glyph.fTop        = g.top();
+            glyph.fMaskFormat = g.maskFormat();
+            glyph.fFlags      = g.fForceBW ? Glyph::kForceBW : 0;
+            if (g.setImageHasBeenCalled()) {
+                image = g.image();
+            } else if (entry) {
+                image = entry->image(g);
+            }
+            imageSize = image ? g.imageSize() : 0;
+            if (g.setPathHasBeenCalled()) {
+                pathAsked = true;
+                path = g.path();
+            } else if (entry) {
+                bool hasPath;
+                pathAsked = entry->path(SkPackedGlyphID{id}, &hasPath, &savedPath);
+                path = pathAsked && hasPath ? &savedPath : nullptr;
+            }
+        } else {
+            // Saved before, and not used by this strike; copy it over.
+            const Glyph& saved = *source.fSaved;
+            glyph = saved;
+            glyph.fFlags &= Glyph::kForceBW;
+            glyph.fImageOffset = glyph.fImageSize = glyph.fPathOffset = glyph.fPathSize = 0;
+            if (saved.fFlags & Glyph::kImage) {
+                image = entry->fData->bytes() + saved.fImageOffset;
+                imageSize = saved.fImageSize;
+            }
+            bool hasPath;
+            pathAsked = entry->path(SkPackedGlyphID{id}, &hasPath, &savedPath);
+            path = pathAsked && hasPath ? &savedPath : nullptr;
+        }
+
+        if (image && imageSize > 0) {
+            glyph.fFlags |= Glyph::kImage;
+            glyph.fImageOffset = SkToU32(dataOffset + glyphData.bytesWritten());
+            glyph.fImageSize = SkToU32(imageSize);
+            glyphData.write(image, imageSize);
+            glyphData.padToAlign4();
+        }
+        if (pathAsked) {
+            glyph.fFlags |= Glyph::kPathAsked;
+        }
+        if (path) {
+            const size_t pathSize = path->writeToMemory(nullptr);
+            SkAutoMalloc storage(pathSize);
+            path->writeToMemory(storage.get());
+            glyph.fFlags |= Glyph::kPath;
+            glyph.fPathOffset = SkToU32(dataOffset + glyphData.bytesWritten());
+            glyph.fPathSize = SkToU32(pathSize);
+            glyphData.write(storage.get(), pathSize);
+            glyphData.padToAlign4();
+        }
+        glyphs.push_back(glyph);
+    }
+
+    const size_t fileSize = dataOffset + glyphData.bytesWritten();
+    if (fileSize > fMaxBytes || fileSize > UINT32_MAX) {
+        return false;
+    }
+
+    Header header;
+    memcpy(header.fMagic, kMagic, sizeof(kMagic));
+    header.fVersion    = kVersion;
+    header.fMilestone  = SK_MILESTONE;
+    header.fWriteTime  = now_ms();
+    header.fKeySize    = SkToU32(key.size());
+    header.fGlyphCount = SkToU32(glyphs.size());
+
+    // Write to a temporary file and rename it into place, so other processes never see a
+    // partial file. Processes that still map the old file keep their copy.
+    const SkString path = this->pathForKey(key);
+    const SkString temp = SkStringPrintf("%s.%p.%llx", path.c_str(), this,
+                                         (unsigned long long)header.fWriteTime);
+    {
+        SkFILEWStream file(temp.c_str());
+        if (!file.isValid() ||
+            !file.write(&header, sizeof(header)) ||
+            !file.write(key.data(), key.size()) ||
+            !file.write(glyphs.data(), glyphs.size() * sizeof(Glyph)) ||
+            !glyphData.writeToAndReset(&file)) {
+            remove(temp.c_str());
+            return false;
+        }
+    }
+    if (rename(temp.c_str(), path.c_str()) != 0) {
+        // Windows won't rename over an existing file.
+        remove(path.c_str());
+        if (rename(temp.c_str(), path.c_str()) != 0) {
+            remove(temp.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+void SkGlyphDiskCache::purge() {
+    SkAutoMutexExclusive ac(fPurgeMutex);
+
+    struct File {
+        SkString fPath;
+        size_t   fSize;
+        uint64_t fWriteTime;
+    };
+    std::vector<File> files;
+    size_t totalSize = 0;
+    SkOSFile::Iter iter(fPath.c_str(), kSuffix);
+    SkString name;
+    while (iter.next(&name)) {
+        File file{SkOSPath::Join(fPath.c_str(), name.c_str()), 0, 0};
+        if (FILE* f = sk_fopen(file.fPath.c_str(), kRead_SkFILE_Flag)) {
+            Header header;
+            file.fSize = sk_fgetsize(f);
+            if (sk_qread(f, &header, sizeof(header), 0) == sizeof(header)) {
+                file.fWriteTime = header.fWriteTime;
+            }
+            sk_fclose(f);
+        }
+        totalSize += file.fSize;
+        files.push_back(std::move(file));
+    }
+    if (totalSize <= fMaxBytes) {
+        return;
+    }
+
+    // Like the strike cache, don't bother with small purges: go down to three quarters.
+    std::sort(files.begin(), files.end(), [](const File& a, const File& b) {
+        return a.fWriteTime < b.fWriteTime;
+    });
+    const size_t target = fMaxBytes - (fMaxBytes >> 2);
+    for (const File& file : files) {
+        if (totalSize <= target) {
+            break;
+        }
+        if (remove(file.fPath.c_str()) == 0) {
+            totalSize -= file.fSize;
+        }
+    }
+}
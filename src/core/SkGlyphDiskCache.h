@@ -0,0 +1,171 @@
+/*
+ * Copyright 2020 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkGlyphDiskCache_DEFINED
+#define SkGlyphDiskCache_DEFINED
+
+#include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkString.h"
+#include "include/core/SkTypeface.h"
+#include "include/private/SkMutex.h"
+#include "src/core/SkDescriptor.h"
+#include "src/core/SkGlyph.h"
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+class SkPath;
+class SkStrike;
+
+/**
+ *  An optional cache of glyph metrics, images and paths on disk, shared by every process using
+ *  the same directory. See SkGraphics::SetFontCacheDirectory().
+ *
+ *  Each strike is kept in its own file, named for a hash of its descriptor and the identity of
+ *  its typeface (which, unlike the typeface's unique ID, is the same in every process). A strike
+ *  file is memory mapped when the strike is created and consulted before asking the scaler
+ *  context for anything, and rewritten when the strike is purged from the SkStrikeCache if new
+ *  glyphs were generated.
+ *
+ *  File I/O runs on a thread of the cache's own, so threads drawing text never wait on the disk:
+ *  a new strike uses its scaler context until its file is mapped, and purged strikes are written
+ *  behind.
+ */
+class SkGlyphDiskCache : public SkRefCnt {
+public:
+    // A strike file is laid out as
+    //
+    //     FileHeader
+    //     uint8_t   key[fKeySize]         typeface identity and descriptor, against collisions
+    //     FileGlyph glyphs[fGlyphCount]   sorted by fID
+    //     image and path data             referred to by offsets in the glyphs
+    //
+    // in native byte order; files are only shared by processes on one machine.
+    struct FileHeader {
+        char     fMagic[8];
+        uint32_t fVersion;
+        uint32_t fMilestone;   // Rasterization changes between releases, so don't share them.
+        uint64_t fWriteTime;   // Milliseconds since the epoch, to purge the oldest files first.
+        uint32_t fKeySize;
+        uint32_t fGlyphCount;
+    };
+
+    struct FileGlyph {
+        enum Flags : uint8_t {
+            kImage     = 1 << 0,
+            kPathAsked = 1 << 1,
+            kPath      = 1 << 2,
+            kForceBW   = 1 << 3,
+        };
+
+        uint32_t fID;
+        float    fAdvanceX, fAdvanceY;
+        uint16_t fWidth, fHeight;
+        int16_t  fLeft, fTop;
+        uint8_t  fMaskFormat;
+        uint8_t  fFlags;
+        uint16_t fPad;
+        uint32_t fImageOffset, fImageSize;
+        uint32_t fPathOffset, fPathSize;
+    };
+
+    /** The glyphs saved for one strike. Read only, so it can be used from any thread. */
+    class Entry : public SkNVRefCnt<Entry> {
+    public:
+        // Returns false if the glyph was not saved, otherwise fills in its metrics.
+        bool metrics(SkPackedGlyphID, SkGlyphPrototype*) const;
+
+        // Returns the saved image for glyph, or nullptr if there isn't one.
+        const void* image(const SkGlyph& glyph) const;
+
+        // Returns false if the glyph's path was never asked for. Otherwise sets *hasPath, and
+        // path if there is one.
+        bool path(SkPackedGlyphID, bool* hasPath, SkPath* path) const;
+
+    private:
+        friend class SkGlyphDiskCache;
+
+        Entry(sk_sp<SkData> data, const FileGlyph* glyphs, int glyphCount)
+            : fData{std::move(data)}, fGlyphs{glyphs}, fGlyphCount{glyphCount} {}
+
+        const FileGlyph* find(SkPackedGlyphID) const;
+
+        const sk_sp<SkData>    fData;
+        const FileGlyph* const fGlyphs;
+        const int              fGlyphCount;
+    };
+
+    /** A strike's file, found on the cache's thread. */
+    class Lookup : public SkNVRefCnt<Lookup> {
+    public:
+        /** The glyphs saved for the strike, or nullptr if there are none or they are not yet
+            found. Can be called from any thread. */
+        const Entry* entry() const {
+            return fDone.load(std::memory_order_acquire) ? fEntry.get() : nullptr;
+        }
+
+    private:
+        friend class SkGlyphDiskCache;
+
+        Lookup(std::unique_ptr<SkDescriptor> desc, sk_sp<SkTypeface> typeface);
+
+        // Only used by the cache's thread, until fDone is set.
+        std::unique_ptr<SkDescriptor> fDesc;
+        sk_sp<SkTypeface>             fTypeface;
+        sk_sp<Entry>                  fEntry;
+        std::atomic<bool>             fDone{false};
+    };
+
+    /** The cache set by SkGraphics::SetFontCacheDirectory(), if any. */
+    static sk_sp<SkGlyphDiskCache> Get();
+    // Returns false if path is not a directory and could not be created.
+    static bool SetDirectory(const char path[], size_t maxBytes);
+
+    SkGlyphDiskCache(const char path[], size_t maxBytes);
+    ~SkGlyphDiskCache() override;
+
+    /** Returns the glyphs saved for the strike with desc, or nullptr. */
+    sk_sp<Entry> find(const SkDescriptor& desc, const SkTypeface& typeface) const;
+
+    /** Like find(), but finds the glyphs on the cache's thread. */
+    sk_sp<Lookup> findLater(const SkDescriptor& desc, const SkTypeface& typeface);
+
+    /**
+     *  Saves the strike's glyphs, along with any it was created with, replacing its file.
+     *  Returns true if the file was written. Call purge() after saving a batch of strikes.
+     */
+    bool save(const SkStrike& strike);
+
+    /** Deletes the least recently written strike files until the directory is under budget. */
+    void purge();
+
+    /** Runs work on the cache's thread, after everything queued before it. */
+    void runLater(std::function<void(void)> work);
+
+    /** Waits for everything queued on the cache's thread. */
+    void flush();
+
+private:
+    // A key identifying a strike and its typeface across processes. Empty if the typeface
+    // cannot be identified, and its strikes are not cached.
+    static std::vector<uint8_t> MakeKey(const SkDescriptor& desc, const SkTypeface& typeface);
+
+    SkString pathForKey(const std::vector<uint8_t>& key) const;
+
+    const SkString fPath;
+    const size_t   fMaxBytes;
+    SkMutex        fPurgeMutex;
+
+    // Destroyed first, finishing the queued work while the rest of the cache is still alive.
+    std::unique_ptr<SkExecutor> fThread;
+};
+
+#endif  // SkGlyphDiskCache_DEFINED
@@ -20,6 +20,7 @@
 #endif
 
 #include "include/core/SkColorFilter.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkMaskFilter.h"
 #include "include/core/SkPathEffect.h"
 #include "include/private/SkTDArray.h"
@@ -33,9 +34,13 @@
 #include "src/core/SkStrikeCache.h"
 #include "src/core/SkStrikeForGPU.h"
 #include "src/core/SkStrikeSpec.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/core/SkTraceEvent.h"
 
+#include <algorithm>
 #include <climits>
+#include <utility>
+#include <vector>
 
 // -- SkGlyphRunListPainter ------------------------------------------------------------------------
 SkGlyphRunListPainter::SkGlyphRunListPainter(const SkSurfaceProps& props,
@@ -77,9 +82,38 @@ SkGlyphRunListPainter::SkGlyphRunListPainter(const GrRenderTargetContext& rtc)
 
 #endif
 
+// Per thread, so the executor is only used by draws within the scope that owns it.
+#if !defined(SK_BUILD_FOR_IOS)
+static thread_local SkExecutor* gBitmapDeviceExecutor = nullptr;
+#endif
+
+SkExecutor* SkGlyphRunListPainter::SwapBitmapDeviceExecutor(SkExecutor* executor) {
+#if !defined(SK_BUILD_FOR_IOS)
+    std::swap(gBitmapDeviceExecutor, executor);
+    return executor;
+#else
+    // iOS does not support thread_local until iOS 9.0.
+    return nullptr;
+#endif
+}
+
+const SkSurfaceProps& SkGlyphRunListPainter::bitmapDeviceProps(const SkPaint& runPaint) const {
+    // The bitmap blitters can only draw lcd text to a N32 bitmap in srcOver. Otherwise,
+    // convert the lcd text into A8 text. The props communicates this to the scaler.
+    return (kN32_SkColorType == fColorType && runPaint.isSrcOver())
+           ? fDeviceProps
+           : fBitmapFallbackProps;
+}
+
 void SkGlyphRunListPainter::drawForBitmapDevice(
         const SkGlyphRunList& glyphRunList, const SkMatrix& deviceMatrix,
         const BitmapDevicePainter* bitmapDevice) {
+#if !defined(SK_BUILD_FOR_IOS)
+    if (gBitmapDeviceExecutor != nullptr && glyphRunList.runCount() > 1) {
+        this->prepareForBitmapDevice(glyphRunList, deviceMatrix, gBitmapDeviceExecutor);
+    }
+#endif
+
     ScopedBuffers _ = this->ensureBuffers(glyphRunList);
 
     // TODO: fStrikeCache is only used for GPU, and some compilers complain about it during the no
@@ -87,11 +121,7 @@ void SkGlyphRunListPainter::drawForBitmapDevice(
     (void)fStrikeCache;
 
     const SkPaint& runPaint = glyphRunList.paint();
-    // The bitmap blitters can only draw lcd text to a N32 bitmap in srcOver. Otherwise,
-    // convert the lcd text into A8 text. The props communicates this to the scaler.
-    auto& props = (kN32_SkColorType == fColorType && runPaint.isSrcOver())
-                  ? fDeviceProps
-                  : fBitmapFallbackProps;
+    auto& props = this->bitmapDeviceProps(runPaint);
 
     SkPoint drawOrigin = glyphRunList.origin();
     for (auto& glyphRun : glyphRunList) {
@@ -134,6 +164,73 @@ void SkGlyphRunListPainter::drawForBitmapDevice(
     }
 }
 
+void SkGlyphRunListPainter::prepareForBitmapDevice(
+        const SkGlyphRunList& glyphRunList, const SkMatrix& deviceMatrix,
+        SkExecutor* executor) {
+    TRACE_EVENT0("skia", TRACE_FUNC);
+    ScopedBuffers _ = this->ensureBuffers(glyphRunList);
+
+    const SkPaint& runPaint = glyphRunList.paint();
+    auto& props = this->bitmapDeviceProps(runPaint);
+
+    // The glyphs needed from each strike. Runs with the same strike share a Batch, because only
+    // one task may use a strike at a time.
+    struct Batch {
+        SkExclusiveStrikePtr strike;
+        std::vector<SkPackedGlyphID> masks;
+        std::vector<SkGlyphID> paths;
+    };
+    std::vector<Batch> batches;
+    auto batchFor = [&](const SkStrikeSpec& strikeSpec) -> Batch& {
+        for (Batch& batch : batches) {
+            if (batch.strike->getDescriptor() == strikeSpec.descriptor()) {
+                return batch;
+            }
+        }
+        batches.push_back(Batch{strikeSpec.findOrCreateExclusiveStrike(), {}, {}});
+        return batches.back();
+    };
+
+    SkPoint drawOrigin = glyphRunList.origin();
+    for (auto& glyphRun : glyphRunList) {
+        const SkFont& runFont = glyphRun.font();
+
+        // Color glyphs and glyphs without paths in a path run are drawn as masks. They are rare
+        // enough to be left to drawForBitmapDevice.
+        if (SkStrikeSpec::ShouldDrawAsPath(runPaint, runFont, deviceMatrix)) {
+            Batch& batch = batchFor(SkStrikeSpec::MakePath(
+                    runFont, runPaint, props, fScalerContextFlags));
+            batch.paths.insert(
+                    batch.paths.end(), glyphRun.glyphsIDs().begin(), glyphRun.glyphsIDs().end());
+            continue;
+        }
+
+        Batch& batch = batchFor(SkStrikeSpec::MakeMask(
+                runFont, runPaint, props, fScalerContextFlags, deviceMatrix));
+        fDrawable.startDevice(
+                glyphRun.source(), drawOrigin, deviceMatrix, batch.strike->roundingSpec());
+        fDrawable.forEachGlyphID([&](size_t, SkPackedGlyphID packedID, SkPoint pos) {
+            if (SkScalarsAreFinite(pos.x(), pos.y())) {
+                batch.masks.push_back(packedID);
+            }
+        });
+    }
+
+    SkTaskGroup(*executor).batch(SkTo<int>(batches.size()), [&](int i) {
+        Batch& batch = batches[i];
+        std::sort(batch.masks.begin(), batch.masks.end());
+        batch.masks.erase(std::unique(batch.masks.begin(), batch.masks.end()), batch.masks.end());
+        std::sort(batch.paths.begin(), batch.paths.end());
+        batch.paths.erase(std::unique(batch.paths.begin(), batch.paths.end()), batch.paths.end());
+
+        std::vector<const SkGlyph*> results(std::max(batch.masks.size(), batch.paths.size()));
+        batch.strike->prepareImages(
+                SkMakeSpan(batch.masks.data(), batch.masks.size()), results.data());
+        batch.strike->preparePaths(
+                SkMakeSpan(batch.paths.data(), batch.paths.size()), results.data());
+    });
+}
+
 #if SK_SUPPORT_GPU
 void SkGlyphRunListPainter::processGlyphRunList(const SkGlyphRunList& glyphRunList,
                                                 const SkMatrix& drawMatrix,
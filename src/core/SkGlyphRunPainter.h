@@ -21,6 +21,7 @@ class GrColorInfo;
 class GrRenderTargetContext;
 #endif
 
+class SkExecutor;
 class SkGlyphRunPainterInterface;
 class SkStrikeSpec;
 
@@ -79,6 +80,20 @@ public:
             const SkGlyphRunList& glyphRunList, const SkMatrix& deviceMatrix,
             const BitmapDevicePainter* bitmapDevice);
 
+    // Generate the masks and paths drawForBitmapDevice will need for glyphRunList using
+    // executor. All the strikes are found first, then each strike's missing glyphs are generated
+    // by its own task. The glyphs of one strike share a scaler context, so they are generated in
+    // order, and strikes of one typeface share an FT_Face, so in practice only strikes of
+    // different typefaces are generated in parallel.
+    void prepareForBitmapDevice(
+            const SkGlyphRunList& glyphRunList, const SkMatrix& deviceMatrix,
+            SkExecutor* executor);
+
+    // Sets the executor drawForBitmapDevice calls prepareForBitmapDevice with, for glyph run
+    // lists with more than one run, on the calling thread only. Returns the previous one.
+    // Does not take ownership; see SkAutoFontRasterizationExecutor.
+    static SkExecutor* SwapBitmapDeviceExecutor(SkExecutor* executor);
+
 #if SK_SUPPORT_GPU
     // A nullptr for process means that the calls to the cache will be performed, but none of the
     // callbacks will be called.
@@ -102,6 +117,8 @@ private:
 
     ScopedBuffers SK_WARN_UNUSED_RESULT ensureBuffers(const SkGlyphRunList& glyphRunList);
 
+    const SkSurfaceProps& bitmapDeviceProps(const SkPaint& runPaint) const;
+
     // The props as on the actual device.
     const SkSurfaceProps fDeviceProps;
     // The props for when the bitmap device can't draw LCD text.
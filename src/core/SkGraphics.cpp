@@ -19,6 +19,9 @@
 #include "src/core/SkBlitter.h"
 #include "src/core/SkCpu.h"
 #include "src/core/SkGeometry.h"
+#include "src/core/SkFontFileCache.h"
+#include "src/core/SkGlyphDiskCache.h"
+#include "src/core/SkGlyphRunPainter.h"
 #include "src/core/SkImageFilter_Base.h"
 #include "src/core/SkOpts.h"
 #include "src/core/SkResourceCache.h"
@@ -131,4 +134,16 @@ int SkGraphics::SetFontCachePointSizeLimit(int limit) {
 void SkGraphics::PurgeFontCache() {
     SkStrikeCache::GlobalStrikeCache()->purgeAll();
     SkTypefaceCache::PurgeAll();
+    SkFontFileCache::PurgeUnused();
+}
+
+bool SkGraphics::SetFontCacheDirectory(const char path[], size_t maxBytes) {
+    return SkGlyphDiskCache::SetDirectory(path, maxBytes);
+}
+
+SkAutoFontRasterizationExecutor::SkAutoFontRasterizationExecutor(SkExecutor* executor)
+    : fPrevious{SkGlyphRunListPainter::SwapBitmapDeviceExecutor(executor)} {}
+
+SkAutoFontRasterizationExecutor::~SkAutoFontRasterizationExecutor() {
+    SkGlyphRunListPainter::SwapBitmapDeviceExecutor(fPrevious);
 }
@@ -91,4 +91,14 @@ void SkImage_unpinAsTexture(const SkImage*, GrContext*);
  */
 SkIRect SkImage_getSubset(const SkImage*);
 
+/**
+ *  The raster implementation of SkImage::MakeFromYUVAPixmaps.  Converts separate 8-bit Y, U, V
+ *  (and optionally A) planes, one byte per pixel, to an N32 image on the CPU.  U and V may be
+ *  subsampled by two in either direction; Y and A must be imageSize.  Returns nullptr for other
+ *  layouts (e.g. interleaved planes).
+ */
+sk_sp<SkImage> SkMakeRasterImageFromYUVAPixmaps(SkYUVColorSpace, const SkPixmap yuvaPixmaps[],
+                                                const SkYUVAIndex yuvaIndices[4], SkISize imageSize,
+                                                GrSurfaceOrigin, sk_sp<SkColorSpace>);
+
 #endif
@@ -69,6 +69,18 @@ public:
         return fMap.count();
     }
 
+    // Returns the least recently used value, or nullptr if the cache is empty.
+    V* lru() {
+        return fLRU.tail() ? &fLRU.tail()->fValue : nullptr;
+    }
+
+    // Removes the least recently used value, if any.
+    void removeLRU() {
+        if (fLRU.tail()) {
+            this->remove(fLRU.tail()->fKey);
+        }
+    }
+
     template <typename Fn>  // f(V*)
     void foreach(Fn&& fn) {
         typename SkTInternalLList<Entry>::Iter iter;
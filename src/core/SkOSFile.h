@@ -53,6 +53,21 @@ void    sk_fmunmap(const void* addr, size_t length);
 /** Returns true if the two point at the exact same filesystem object. */
 bool    sk_fidentical(FILE* a, FILE* b);
 
+/** Identifies one version of a file: the file system object and when it was last modified. */
+struct SkFileStamp {
+    uint64_t fVolume;
+    uint64_t fFile;
+    int64_t  fModified;  // In the finest units the platform reports, since an arbitrary epoch.
+
+    bool operator==(const SkFileStamp& that) const {
+        return fVolume == that.fVolume && fFile == that.fFile && fModified == that.fModified;
+    }
+    bool operator!=(const SkFileStamp& that) const { return !(*this == that); }
+};
+
+/** Sets stamp to identify the file's current version. Returns false on failure. */
+bool    sk_fstamp(FILE* f, SkFileStamp* stamp);
+
 /** Returns the underlying file descriptor for the given file.
  *  The return value will be < 0 on failure.
  */
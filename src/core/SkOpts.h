@@ -42,7 +42,24 @@ namespace SkOpts {
                            RGB_to_BGR1,     // i.e. swap RB and insert an opaque alpha
                            gray_to_RGB1,    // i.e. expand to color channels + an opaque alpha
                            grayA_to_RGBA,   // i.e. expand to color channels
-                           grayA_to_rgbA;   // i.e. expand to color channels and premultiply
+                           grayA_to_rgbA,   // i.e. expand to color channels and premultiply
+                           RGB16_to_RGB1,   // i.e. drop to 8 bits and insert an opaque alpha
+                           RGB16_to_BGR1,   // i.e. drop to 8 bits, swap RB and insert an alpha
+                           RGBA16_to_RGBA,  // i.e. drop to 8 bits
+                           RGBA16_to_BGRA,  // i.e. drop to 8 bits and swap RB
+                           RGBA16_to_rgbA,  // i.e. drop to 8 bits and premultiply
+                           RGBA16_to_bgrA;  // i.e. drop to 8 bits, swap RB and premultiply
+
+    // Look up 8-bit indices in a 256 entry color table.
+    typedef void (*Swizzle_8888_index)(uint32_t*, const uint8_t*, int, const uint32_t*);
+    extern Swizzle_8888_index index_to_8888;
+
+    // Convert rows of 8-bit Y, U and V planes to opaque RGBA with a YUV->RGB color matrix (see
+    // SkYUVMath.h).  U and V are horizontally subsampled by (1 << uvShift).
+    typedef void (*Swizzle_8888_yuv)(uint32_t*, const uint8_t* y, const uint8_t* u,
+                                     const uint8_t* v, int count, int uvShift,
+                                     const float matrix[20]);
+    extern Swizzle_8888_yuv YUV_to_RGB1;
 
     extern void (*memset16)(uint16_t[], uint16_t, int);
     extern void SK_SPI(*memset32)(uint32_t[], uint32_t, int);
@@ -0,0 +1,699 @@
+/*
+ * Copyright 2020 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkBBHFactory.h"
+#include "include/core/SkData.h"
+#include "include/core/SkImage.h"
+#include "include/core/SkPictureRecorder.h"
+#include "include/core/SkSerialProcs.h"
+#include "include/core/SkTypeface.h"
+#include "src/core/SkAutoMalloc.h"
+#include "src/core/SkBigPicture.h"
+#include "src/core/SkMD5.h"
+#include "src/core/SkOpts.h"
+#include "src/core/SkPaintPriv.h"
+#include "src/core/SkPictureDelta.h"
+#include "src/core/SkPicturePriv.h"
+#include "src/core/SkReadBuffer.h"
+#include "src/core/SkRecord.h"
+#include "src/core/SkRecordDraw.h"
+#include "src/core/SkRecorder.h"
+#include "src/core/SkTextBlobPriv.h"
+#include "src/core/SkWriteBuffer.h"
+#include "src/utils/SkPatchUtils.h"
+
+#include <type_traits>
+#include <vector>
+
+namespace {
+
+// The ops of any SkPicture, viewed as an SkRecord.
+class PictureOps {
+public:
+    explicit PictureOps(const SkPicture& picture) {
+        if (const SkBigPicture* big = SkPicturePriv::AsSkBigPicture(picture)) {
+            fRecord        = big->record();
+            fDrawablePicts = big->drawablePicts();
+            fDrawableCount = big->drawableCount();
+        } else {
+            // Mini and empty pictures hold at most one op; record it so we can treat it uniformly.
+            fOwned = sk_make_sp<SkRecord>();
+            SkRecorder recorder(fOwned.get(), picture.cullRect());
+            picture.playback(&recorder);
+            fRecord = fOwned.get();
+        }
+    }
+
+    const SkRecord& record() const { return *fRecord; }
+    int count() const { return fRecord->count(); }
+
+    // Draws ops [start, stop) into canvas.  The canvas' state is not saved or restored, so matrix
+    // and clip changes carry over into whatever is drawn next.
+    void draw(SkCanvas* canvas, int start, int stop) const {
+        SkRecords::Draw draw(canvas, fDrawablePicts, nullptr, fDrawableCount, &SkMatrix::I());
+        for (int i = start; i < stop; i++) {
+            fRecord->visit(i, draw);
+        }
+    }
+
+    uint32_t typeHash() const {
+        int count = this->count();
+        uint32_t hash = SkOpts::hash(&count, sizeof(count));
+        for (int i = 0; i < this->count(); i++) {
+            uint32_t type = fRecord->visit(i, [](const auto& op) { return (uint32_t)op.kType; });
+            hash = SkOpts::hash(&type, sizeof(type), hash);
+        }
+        return hash;
+    }
+
+    SkPicture const* const* drawablePicts() const { return fDrawablePicts; }
+    int drawableCount() const { return fDrawableCount; }
+
+private:
+    sk_sp<SkRecord>         fOwned;
+    const SkRecord*         fRecord = nullptr;
+    SkPicture const* const* fDrawablePicts = nullptr;
+    int                     fDrawableCount = 0;
+};
+
+// Hashes the content of a single op.  Paths, paints, regions and blobs are hashed by value, while
+// shared immutable objects (images, pictures, vertices, typefaces) are hashed by unique ID.
+//
+// A hash collision would silently drop a change, so we digest with MD5 rather than SkOpts::hash,
+// whose CRC-based mixing readily collides on small structured inputs like paint colors.
+class OpHasher {
+public:
+    OpHasher(SkPicture const* const drawablePicts[], int drawableCount)
+        : fDrawablePicts(drawablePicts)
+        , fDrawableCount(drawableCount) {
+        fProcs.fImageProc = [](SkImage* image, void*) { return ID(image->uniqueID()); };
+        fProcs.fPictureProc = [](SkPicture* picture, void*) { return ID(picture->uniqueID()); };
+        fProcs.fTypefaceProc = [](SkTypeface* typeface, void*) {
+            return ID(typeface->uniqueID());
+        };
+    }
+
+    template <typename T>
+    uint64_t operator()(const T& op) {
+        SkMD5 md5;
+        fMD5 = &md5;
+        const SkRecords::Type type = T::kType;
+        this->pod(type);
+        this->hashOp(op);
+
+        uint64_t hash;
+        SkMD5::Digest digest = md5.finish();
+        memcpy(&hash, digest.data, sizeof(hash));
+        return hash;
+    }
+
+private:
+    static sk_sp<SkData> ID(uint32_t id) { return SkData::MakeWithCopy(&id, sizeof(id)); }
+
+    void bytes(const void* data, size_t size) { fMD5->write(data, size); }
+
+    template <typename T>
+    void pod(const T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "");
+        this->bytes(&value, sizeof(T));
+    }
+
+    template <typename T>
+    void array(const T* values, int count) {
+        this->pod(values != nullptr);
+        if (values) {
+            this->bytes(values, count * sizeof(T));
+        }
+    }
+
+    template <typename Fn>
+    void flattened(Fn&& flatten) {
+        char storage[256];
+        SkBinaryWriteBuffer buffer(storage, sizeof(storage));
+        buffer.setSerialProcs(fProcs);
+        flatten(buffer);
+        if (buffer.usingInitialStorage()) {
+            this->bytes(storage, buffer.bytesWritten());
+        } else {
+            SkAutoMalloc copy(buffer.bytesWritten());
+            buffer.writeToMemory(copy.get());
+            this->bytes(copy.get(), buffer.bytesWritten());
+        }
+    }
+
+    template <typename T>
+    void optional(const SkRecords::Optional<T>& value) {
+        this->pod(value != nullptr);
+        if (value) {
+            this->field(*value);
+        }
+    }
+
+    void field(SkScalar v)                 { this->pod(v); }
+    void field(const SkRect& r)            { this->pod(r); }
+    void field(const SkIRect& r)           { this->pod(r); }
+    void field(const SkRRect& rr)          { this->pod(rr); }
+    void field(const SkMatrix& m) {
+        SkScalar values[9];
+        m.get9(values);
+        this->bytes(values, sizeof(values));
+    }
+    void field(const SkM44& m) {
+        SkScalar values[16];
+        m.getColMajor(values);
+        this->bytes(values, sizeof(values));
+    }
+    void field(const SkPath& path) {
+        SkAutoMalloc storage(path.writeToMemory(nullptr));
+        this->bytes(storage.get(), path.writeToMemory(storage.get()));
+    }
+    void field(const SkRegion& region) {
+        SkAutoMalloc storage(region.writeToMemory(nullptr));
+        this->bytes(storage.get(), region.writeToMemory(storage.get()));
+    }
+    void field(const SkPaint& paint) {
+        this->flattened([&](SkWriteBuffer& buffer) { SkPaintPriv::Flatten(paint, buffer); });
+    }
+    void field(const sk_sp<const SkImageFilter>& filter) {
+        this->flattened([&](SkWriteBuffer& buffer) { buffer.writeFlattenable(filter.get()); });
+    }
+    void field(const sk_sp<const SkTextBlob>& blob) {
+        this->flattened([&](SkWriteBuffer& buffer) { SkTextBlobPriv::Flatten(*blob, buffer); });
+    }
+    void field(const sk_sp<const SkImage>& image)      { this->id(image.get()); }
+    void field(const sk_sp<const SkPicture>& picture)  { this->id(picture.get()); }
+    void field(const sk_sp<SkVertices>& vertices)      { this->id(vertices.get()); }
+    void field(const sk_sp<SkData>& data) {
+        this->pod(data != nullptr);
+        if (data) {
+            this->bytes(data->data(), data->size());
+        }
+    }
+    void field(const SkString& string) { this->bytes(string.c_str(), string.size()); }
+
+    template <typename T>
+    void id(const T* obj) { this->pod(obj ? obj->uniqueID() : 0); }
+
+    void hashOp(const SkRecords::NoOp&)    {}
+    void hashOp(const SkRecords::Flush&)   {}
+    void hashOp(const SkRecords::Save&)    {}
+    void hashOp(const SkRecords::Restore&) {}  // Its matrix is derived from the ops before it.
+    void hashOp(const SkRecords::SaveLayer& r) {
+        this->optional(r.bounds);
+        this->optional(r.paint);
+        this->field(r.backdrop);
+        this->field(r.clipMask);
+        this->optional(r.clipMatrix);
+        this->pod(r.saveLayerFlags);
+    }
+    void hashOp(const SkRecords::SaveBehind& r) { this->optional(r.subset); }
+    void hashOp(const SkRecords::SetMatrix& r)  { this->field(r.matrix); }
+    void hashOp(const SkRecords::Concat& r)     { this->field(r.matrix); }
+    void hashOp(const SkRecords::Concat44& r)   { this->field(r.matrix); }
+    void hashOp(const SkRecords::Translate& r)  { this->pod(r.dx); this->pod(r.dy); }
+    void hashOp(const SkRecords::Scale& r)      { this->pod(r.sx); this->pod(r.sy); }
+    void hashOp(const SkRecords::ClipPath& r)   { this->field(r.path);   this->pod(r.opAA); }
+    void hashOp(const SkRecords::ClipRRect& r)  { this->field(r.rrect);  this->pod(r.opAA); }
+    void hashOp(const SkRecords::ClipRect& r)   { this->field(r.rect);   this->pod(r.opAA); }
+    void hashOp(const SkRecords::ClipRegion& r) { this->field(r.region); this->pod(r.op); }
+    void hashOp(const SkRecords::DrawArc& r) {
+        this->field(r.paint);
+        this->field(r.oval);
+        this->pod(r.startAngle);
+        this->pod(r.sweepAngle);
+        this->pod(r.useCenter);
+    }
+    void hashOp(const SkRecords::DrawDRRect& r) {
+        this->field(r.paint);
+        this->field(r.outer);
+        this->field(r.inner);
+    }
+    void hashOp(const SkRecords::DrawDrawable& r) {
+        this->optional(r.matrix);
+        this->field(r.worstCaseBounds);
+        if (fDrawablePicts && r.index >= 0 && r.index < fDrawableCount) {
+            this->id(fDrawablePicts[r.index]);
+        } else {
+            this->pod(r.index);
+        }
+    }
+    void hashOp(const SkRecords::DrawImage& r) {
+        this->optional(r.paint);
+        this->field(r.image);
+        this->pod(r.left);
+        this->pod(r.top);
+    }
+    void hashOp(const SkRecords::DrawImageLattice& r) {
+        this->optional(r.paint);
+        this->field(r.image);
+        this->array(r.xDivs.operator int*(), r.xCount);
+        this->array(r.yDivs.operator int*(), r.yCount);
+        this->array(r.flags.operator SkCanvas::Lattice::RectType*(), r.flagCount);
+        this->array(r.colors.operator SkColor*(), r.flagCount);
+        this->field(r.src);
+        this->field(r.dst);
+    }
+    void hashOp(const SkRecords::DrawImageRect& r) {
+        this->optional(r.paint);
+        this->field(r.image);
+        this->optional(r.src);
+        this->field(r.dst);
+        this->pod(r.constraint);
+    }
+    void hashOp(const SkRecords::DrawImageNine& r) {
+        this->optional(r.paint);
+        this->field(r.image);
+        this->field(r.center);
+        this->field(r.dst);
+    }
+    void hashOp(const SkRecords::DrawOval& r)   { this->field(r.paint); this->field(r.oval); }
+    void hashOp(const SkRecords::DrawPaint& r)  { this->field(r.paint); }
+    void hashOp(const SkRecords::DrawBehind& r) { this->field(r.paint); }
+    void hashOp(const SkRecords::DrawPath& r)   { this->field(r.paint); this->field(r.path); }
+    void hashOp(const SkRecords::DrawPicture& r) {
+        this->optional(r.paint);
+        this->field(r.picture);
+        this->field(r.matrix);
+    }
+    void hashOp(const SkRecords::DrawPoints& r) {
+        this->field(r.paint);
+        this->pod(r.mode);
+        this->array(r.pts, r.count);
+    }
+    void hashOp(const SkRecords::DrawRRect& r)  { this->field(r.paint); this->field(r.rrect); }
+    void hashOp(const SkRecords::DrawRect& r)   { this->field(r.paint); this->field(r.rect); }
+    void hashOp(const SkRecords::DrawRegion& r) { this->field(r.paint); this->field(r.region); }
+    void hashOp(const SkRecords::DrawTextBlob& r) {
+        this->field(r.paint);
+        this->field(r.blob);
+        this->pod(r.x);
+        this->pod(r.y);
+    }
+    void hashOp(const SkRecords::DrawPatch& r) {
+        this->field(r.paint);
+        this->array(r.cubics.operator SkPoint*(), SkPatchUtils::kNumCtrlPts);
+        this->array(r.colors.operator SkColor*(), SkPatchUtils::kNumCorners);
+        this->array(r.texCoords.operator SkPoint*(), SkPatchUtils::kNumCorners);
+        this->pod(r.bmode);
+    }
+    void hashOp(const SkRecords::DrawAtlas& r) {
+        this->optional(r.paint);
+        this->field(r.atlas);
+        this->array(r.xforms.operator SkRSXform*(), r.count);
+        this->array(r.texs.operator SkRect*(), r.count);
+        this->array(r.colors.operator SkColor*(), r.count);
+        this->pod(r.mode);
+        this->optional(r.cull);
+    }
+    void hashOp(const SkRecords::DrawVertices& r) {
+        this->field(r.paint);
+        this->field(r.vertices);
+        this->array(r.bones.operator SkVertices::Bone*(), r.boneCount);
+        this->pod(r.bmode);
+    }
+    void hashOp(const SkRecords::DrawShadowRec& r) { this->field(r.path); this->pod(r.rec); }
+    void hashOp(const SkRecords::DrawAnnotation& r) {
+        this->field(r.rect);
+        this->field(r.key);
+        this->field(r.value);
+    }
+    void hashOp(const SkRecords::DrawEdgeAAQuad& r) {
+        this->field(r.rect);
+        this->array(r.clip.operator SkPoint*(), 4);
+        this->pod(r.aa);
+        this->pod(r.color);
+        this->pod(r.mode);
+    }
+    void hashOp(const SkRecords::DrawEdgeAAImageSet& r) {
+        this->optional(r.paint);
+        int clipCount = 0,
+            matrixCount = 0;
+        for (int i = 0; i < r.count; i++) {
+            const SkCanvas::ImageSetEntry& entry = r.set[i];
+            this->field(entry.fImage);
+            this->field(entry.fSrcRect);
+            this->field(entry.fDstRect);
+            this->pod(entry.fMatrixIndex);
+            this->pod(entry.fAlpha);
+            this->pod(entry.fAAFlags);
+            this->pod(entry.fHasClip);
+            clipCount += entry.fHasClip ? 4 : 0;
+            matrixCount = SkTMax(matrixCount, entry.fMatrixIndex + 1);
+        }
+        this->array(r.dstClips.operator SkPoint*(), clipCount);
+        for (int i = 0; r.preViewMatrices && i < matrixCount; i++) {
+            this->field(r.preViewMatrices[i]);
+        }
+        this->pod(r.constraint);
+    }
+
+    SkPicture const* const* fDrawablePicts;
+    int                     fDrawableCount;
+    SkSerialProcs           fProcs;
+    SkMD5*                  fMD5 = nullptr;
+};
+
+std::vector<uint64_t> hash_ops(const PictureOps& ops) {
+    OpHasher hasher(ops.drawablePicts(), ops.drawableCount());
+    std::vector<uint64_t> hashes(ops.count());
+    for (int i = 0; i < ops.count(); i++) {
+        hashes[i] = ops.record().visit(i, hasher);
+    }
+    return hashes;
+}
+
+struct Span {
+    int fBaseStart, fBaseStop;
+    int fTargetStart, fTargetStop;
+};
+
+// Myers' O(ND) diff over op hashes, reporting each run of unmatched ops as a Span.  Gives up and
+// reports one Span covering everything if more than maxEdits insertions and deletions are needed.
+void diff(const uint64_t* a, int n, const uint64_t* b, int m, int offset, int maxEdits,
+          std::vector<Span>* spans) {
+    if (n == 0 && m == 0) {
+        return;
+    }
+    const int maxD = SkTMin(n + m, maxEdits);
+    const int width = 2 * maxD + 3;     // k ranges over [-maxD-1, maxD+1].
+    auto at = [&](std::vector<int>& v, int k) -> int& { return v[k + maxD + 1]; };
+
+    std::vector<int> v(width, 0);
+    std::vector<std::vector<int>> trace;
+    int found = -1;
+    for (int d = 0; d <= maxD && found < 0; d++) {
+        trace.push_back(v);
+        for (int k = -d; k <= d; k += 2) {
+            int x = (k == -d || (k != d && at(v, k - 1) < at(v, k + 1))) ? at(v, k + 1)
+                                                                          : at(v, k - 1) + 1;
+            int y = x - k;
+            while (x < n && y < m && a[x] == b[y]) {
+                x++;
+                y++;
+            }
+            at(v, k) = x;
+            if (x >= n && y >= m) {
+                found = d;
+                break;
+            }
+        }
+    }
+    if (found < 0) {
+        spans->push_back({offset, offset + n, offset, offset + m});
+        return;
+    }
+
+    // Walk the edit path backwards, collecting matched pairs.
+    std::vector<std::pair<int, int>> matches;
+    int x = n, y = m;
+    for (int d = found; d >= 0; d--) {
+        std::vector<int>& prev = trace[d];
+        int k = x - y;
+        int prevK = (k == -d || (k != d && at(prev, k - 1) < at(prev, k + 1))) ? k + 1 : k - 1;
+        int prevX = d > 0 ? at(prev, prevK) : 0,
+            prevY = d > 0 ? prevX - prevK : 0;
+        while (x > prevX && y > prevY) {
+            matches.push_back({--x, --y});
+        }
+        x = prevX;
+        y = prevY;
+    }
+
+    int ai = 0, bi = 0;
+    auto emit = [&](int aStop, int bStop) {
+        if (aStop > ai || bStop > bi) {
+            spans->push_back({offset + ai, offset + aStop, offset + bi, offset + bStop});
+        }
+    };
+    for (auto match = matches.rbegin(); match != matches.rend(); ++match) {
+        emit(match->first, match->second);
+        ai = match->first  + 1;
+        bi = match->second + 1;
+    }
+    emit(n, m);
+}
+
+// For each op, the save depth before it and whether it changes the matrix or clip for the ops
+// after it.  fDepth has one extra entry for the depth after the last op.
+struct Nesting {
+    explicit Nesting(const SkRecord& record)
+        : fDepth(record.count() + 1)
+        , fChangesState(record.count()) {
+        int depth = 0;
+        for (int i = 0; i < record.count(); i++) {
+            fDepth[i] = depth;
+            record.visit(i, [&](const auto& op) {
+                using T = std::decay_t<decltype(op)>;
+                if (std::is_same<T, SkRecords::Save>::value      ||
+                    std::is_same<T, SkRecords::SaveLayer>::value ||
+                    std::is_same<T, SkRecords::SaveBehind>::value) {
+                    depth++;
+                } else if (std::is_same<T, SkRecords::Restore>::value) {
+                    depth--;
+                } else {
+                    fChangesState[i] = std::is_same<T, SkRecords::SetMatrix>::value  ||
+                                       std::is_same<T, SkRecords::Concat>::value     ||
+                                       std::is_same<T, SkRecords::Concat44>::value   ||
+                                       std::is_same<T, SkRecords::Scale>::value      ||
+                                       std::is_same<T, SkRecords::Translate>::value  ||
+                                       std::is_same<T, SkRecords::ClipPath>::value   ||
+                                       std::is_same<T, SkRecords::ClipRRect>::value  ||
+                                       std::is_same<T, SkRecords::ClipRect>::value   ||
+                                       std::is_same<T, SkRecords::ClipRegion>::value;
+                }
+            });
+        }
+        fDepth[record.count()] = depth;
+    }
+
+    int count() const { return (int)fChangesState.size(); }
+
+    std::vector<int>  fDepth;
+    std::vector<bool> fChangesState;
+};
+
+// Returns -1 if ops [start, stop) contain a Restore without its Save, 1 if they contain a Save
+// without its Restore or a matrix or clip change that outlives them, and 0 otherwise.
+int containment(const Nesting& nesting, int start, int stop) {
+    const int depth = nesting.fDepth[start];
+    bool leaks = false;
+    for (int i = start; i < stop; i++) {
+        if (nesting.fDepth[i + 1] < depth) {
+            return -1;
+        }
+        leaks = leaks || (nesting.fChangesState[i] && nesting.fDepth[i] == depth);
+    }
+    return (leaks || nesting.fDepth[stop] > depth) ? 1 : 0;
+}
+
+// Widen spans until their ops are self-contained in both base and target, merging neighbors as
+// needed.  Self-contained spans can be shipped as standalone pictures (serialization wraps a
+// picture's ops in a save/restore, which would lose a leaked matrix or clip change), and they
+// keep every op whose result may change inside some span, so their bounds cover all changes.
+void contain(const Nesting& base, const Nesting& target, std::vector<Span>* spans) {
+    for (size_t i = 0; i < spans->size();) {
+        Span& s = (*spans)[i];
+
+        // A deletion directly followed by an insertion is really one span.
+        if (i + 1 < spans->size() && (*spans)[i+1].fBaseStart   == s.fBaseStop
+                                  && (*spans)[i+1].fTargetStart == s.fTargetStop) {
+            s.fBaseStop   = (*spans)[i+1].fBaseStop;
+            s.fTargetStop = (*spans)[i+1].fTargetStop;
+            spans->erase(spans->begin() + i + 1);
+            continue;
+        }
+
+        const int b = containment(base,   s.fBaseStart,   s.fBaseStop),
+                  t = containment(target, s.fTargetStart, s.fTargetStop);
+
+        // Ops just outside a span are common to both pictures, so we always grow both sides.
+        if ((b < 0 || t < 0) && s.fBaseStart > 0 && s.fTargetStart > 0) {
+            s.fBaseStart--;
+            s.fTargetStart--;
+            if (i > 0 && (*spans)[i-1].fTargetStop > s.fTargetStart) {
+                (*spans)[i-1].fBaseStop   = s.fBaseStop;
+                (*spans)[i-1].fTargetStop = s.fTargetStop;
+                spans->erase(spans->begin() + i);
+                i--;
+            }
+        } else if ((b > 0 || t > 0) && s.fBaseStop < base.count() &&
+                                       s.fTargetStop < target.count()) {
+            s.fBaseStop++;
+            s.fTargetStop++;
+            if (i + 1 < spans->size() && (*spans)[i+1].fTargetStart < s.fTargetStop) {
+                s.fBaseStop   = (*spans)[i+1].fBaseStop;
+                s.fTargetStop = (*spans)[i+1].fTargetStop;
+                spans->erase(spans->begin() + i + 1);
+            }
+        } else {
+            i++;
+        }
+    }
+}
+
+static constexpr int kMaxEdits = 256;
+
+static constexpr uint32_t kMagic   = SkSetFourByteTag('s', 'k', 'p', 'd');
+static constexpr uint32_t kVersion = 1;
+
+}  // namespace
+
+sk_sp<SkPictureDelta> SkPictureDelta::Make(const SkPicture& base, const SkPicture& target) {
+    PictureOps baseOps(base),
+               targetOps(target);
+
+    sk_sp<SkPictureDelta> delta(new SkPictureDelta);
+    delta->fBaseCount    = baseOps.count();
+    delta->fBaseTypeHash = baseOps.typeHash();
+    delta->fCullRect     = target.cullRect();
+    const SkBigPicture* bigTarget = SkPicturePriv::AsSkBigPicture(target);
+    delta->fUseBBH       = bigTarget && bigTarget->bbh();
+
+    // Trim the common prefix and suffix before running the (quadratic in edits) diff.
+    std::vector<uint64_t> a = hash_ops(baseOps),
+                          b = hash_ops(targetOps);
+    int n = (int)a.size(),
+        m = (int)b.size(),
+        prefix = 0,
+        suffix = 0;
+    while (prefix < n && prefix < m && a[prefix] == b[prefix]) {
+        prefix++;
+    }
+    while (suffix < n - prefix && suffix < m - prefix && a[n-1-suffix] == b[m-1-suffix]) {
+        suffix++;
+    }
+
+    std::vector<Span> spans;
+    diff(a.data() + prefix, n - prefix - suffix,
+         b.data() + prefix, m - prefix - suffix, prefix, kMaxEdits, &spans);
+    contain(Nesting(baseOps.record()), Nesting(targetOps.record()), &spans);
+
+    if (spans.empty()) {
+        return delta;
+    }
+
+    SkAutoTMalloc<SkRect> baseBounds(n),
+                          targetBounds(m);
+    SkRecordFillBounds(base.cullRect(),   baseOps.record(),   baseBounds);
+    SkRecordFillBounds(target.cullRect(), targetOps.record(), targetBounds);
+
+    for (const Span& s : spans) {
+        Hunk hunk;
+        hunk.fBaseStart   = s.fBaseStart;
+        hunk.fBaseCount   = s.fBaseStop - s.fBaseStart;
+        hunk.fTargetCount = s.fTargetStop - s.fTargetStart;
+
+        if (hunk.fTargetCount > 0) {
+            SkPictureRecorder recorder;
+            targetOps.draw(recorder.beginRecording(target.cullRect()),
+                           s.fTargetStart, s.fTargetStop);
+            hunk.fOps = recorder.finishRecordingAsPicture();
+        }
+
+        for (int i = s.fBaseStart; i < s.fBaseStop; i++) {
+            delta->fInvalidBounds.join(baseBounds[i]);
+        }
+        for (int i = s.fTargetStart; i < s.fTargetStop; i++) {
+            delta->fInvalidBounds.join(targetBounds[i]);
+        }
+        delta->fHunks.push_back(std::move(hunk));
+    }
+    return delta;
+}
+
+sk_sp<SkPicture> SkPictureDelta::apply(const SkPicture& base) const {
+    PictureOps baseOps(base);
+    if (baseOps.count() != fBaseCount || baseOps.typeHash() != fBaseTypeHash) {
+        return nullptr;
+    }
+
+    SkRTreeFactory factory;
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(fCullRect, fUseBBH ? &factory : nullptr);
+
+    int next = 0;
+    for (const Hunk& hunk : fHunks) {
+        baseOps.draw(canvas, next, hunk.fBaseStart);
+        if (hunk.fOps) {
+            PictureOps ops(*hunk.fOps);
+            ops.draw(canvas, 0, ops.count());
+        }
+        next = hunk.fBaseStart + hunk.fBaseCount;
+    }
+    baseOps.draw(canvas, next, fBaseCount);
+
+    return recorder.finishRecordingAsPicture();
+}
+
+sk_sp<SkData> SkPictureDelta::serialize(const SkSerialProcs* procs) const {
+    SkBinaryWriteBuffer buffer;
+    if (procs) {
+        buffer.setSerialProcs(*procs);
+    }
+    buffer.writeUInt(kMagic);
+    buffer.writeUInt(kVersion);
+    buffer.writeInt(fBaseCount);
+    buffer.writeUInt(fBaseTypeHash);
+    buffer.writeRect(fCullRect);
+    buffer.writeRect(fInvalidBounds);
+    buffer.writeBool(fUseBBH);
+    buffer.writeInt(fHunks.count());
+    for (const Hunk& hunk : fHunks) {
+        buffer.writeInt(hunk.fBaseStart);
+        buffer.writeInt(hunk.fBaseCount);
+        buffer.writeInt(hunk.fTargetCount);
+        buffer.writeBool(hunk.fOps != nullptr);
+        if (hunk.fOps) {
+            SkPicturePriv::Flatten(hunk.fOps, buffer);
+        }
+    }
+
+    sk_sp<SkData> data = SkData::MakeUninitialized(buffer.bytesWritten());
+    buffer.writeToMemory(data->writable_data());
+    return data;
+}
+
+sk_sp<SkPictureDelta> SkPictureDelta::MakeFromData(const void* data, size_t size,
+                                                   const SkDeserialProcs* procs) {
+    SkReadBuffer buffer(data, size);
+    if (procs) {
+        buffer.setDeserialProcs(*procs);
+    }
+    if (!buffer.validate(buffer.readUInt() == kMagic && buffer.readUInt() == kVersion)) {
+        return nullptr;
+    }
+
+    sk_sp<SkPictureDelta> delta(new SkPictureDelta);
+    delta->fBaseCount    = buffer.readInt();
+    delta->fBaseTypeHash = buffer.readUInt();
+    buffer.readRect(&delta->fCullRect);
+    buffer.readRect(&delta->fInvalidBounds);
+    delta->fUseBBH = buffer.readBool();
+
+    const int count = buffer.readInt();
+    int next = 0;
+    for (int i = 0; buffer.isValid() && i < count; i++) {
+        Hunk hunk;
+        hunk.fBaseStart   = buffer.readInt();
+        hunk.fBaseCount   = buffer.readInt();
+        hunk.fTargetCount = buffer.readInt();
+        if (buffer.readBool()) {
+            hunk.fOps = SkPicturePriv::MakeFromBuffer(buffer);
+            buffer.validate(hunk.fOps != nullptr);
+        }
+        // Hunks must be in order, non-overlapping, and within the base.
+        buffer.validate(hunk.fBaseStart >= next && hunk.fBaseCount >= 0 &&
+                        hunk.fBaseCount <= delta->fBaseCount - hunk.fBaseStart &&
+                        hunk.fTargetCount >= 0);
+        next = hunk.fBaseStart + hunk.fBaseCount;
+        delta->fHunks.push_back(std::move(hunk));
+    }
+    if (!buffer.validate(count >= 0 && delta->fBaseCount >= 0)) {
+        return nullptr;
+    }
+    return delta;
+}
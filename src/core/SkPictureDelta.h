@@ -0,0 +1,74 @@
+/*
+ * Copyright 2020 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkPictureDelta_DEFINED
+#define SkPictureDelta_DEFINED
+
+#include "include/core/SkPicture.h"
+#include "include/core/SkRect.h"
+#include "include/core/SkRefCnt.h"
+#include "include/private/SkTArray.h"
+
+class SkData;
+struct SkDeserialProcs;
+struct SkSerialProcs;
+
+// SkPictureDelta describes how to turn one picture (the base) into another (the target) one
+// recorded op at a time, so a stream of similar frames can ship only what changed.
+//
+// Ops are matched by content, not by pointer: paths, paints, regions and text blobs are compared
+// by value, images, pictures and vertices by unique ID.  Re-recording the same frame from scratch
+// therefore produces an empty delta.
+//
+// A delta is a list of hunks, each replacing a run of base ops with a run of target ops.  Hunks are
+// widened until both runs are save/restore balanced and leave the matrix and clip as they found
+// them, so each run can be carried around as an ordinary SkPicture.
+class SkPictureDelta : public SkRefCnt {
+public:
+    struct Hunk {
+        int fBaseStart;    // First base op replaced by this hunk.
+        int fBaseCount;    // Number of base ops replaced.
+        int fTargetCount;  // Number of target ops inserted in their place.
+
+        sk_sp<SkPicture> fOps;  // The inserted ops, or nullptr when fTargetCount is 0.
+    };
+
+    // Computes the delta from base to target.  Never returns nullptr.
+    static sk_sp<SkPictureDelta> Make(const SkPicture& base, const SkPicture& target);
+
+    // Applies this delta to base, returning a picture that draws the same as the target.
+    // Returns nullptr if base does not look like the picture this delta was computed against.
+    sk_sp<SkPicture> apply(const SkPicture& base) const;
+
+    // True if base and target record the same ops.
+    bool isEmpty() const { return fHunks.empty(); }
+
+    int hunkCount() const { return fHunks.count(); }
+    const Hunk& hunk(int i) const { return fHunks[i]; }
+
+    // Identity-space bounds of everything the hunks may draw in either the base or the target.
+    // Pixels outside these bounds render identically for both pictures.
+    const SkRect& invalidBounds() const { return fInvalidBounds; }
+
+    // The delta's wire format, suitable for MakeFromData().  Hunk ops are written with
+    // SkPicture's own serialization, using procs if provided.
+    sk_sp<SkData> serialize(const SkSerialProcs* procs = nullptr) const;
+    static sk_sp<SkPictureDelta> MakeFromData(const void* data, size_t size,
+                                              const SkDeserialProcs* procs = nullptr);
+
+private:
+    SkPictureDelta() = default;
+
+    int            fBaseCount = 0;
+    uint32_t       fBaseTypeHash = 0;  // Hash of the base's op types, a cheap sanity check.
+    SkRect         fCullRect = SkRect::MakeEmpty();
+    SkRect         fInvalidBounds = SkRect::MakeEmpty();
+    bool           fUseBBH = false;
+    SkTArray<Hunk> fHunks;
+};
+
+#endif//SkPictureDelta_DEFINED
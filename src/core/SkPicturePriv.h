@@ -34,6 +34,9 @@ public:
     static const SkBigPicture* AsSkBigPicture(const sk_sp<const SkPicture> picture) {
         return picture->asSkBigPicture();
     }
+    static const SkBigPicture* AsSkBigPicture(const SkPicture& picture) {
+        return picture.asSkBigPicture();
+    }
 
     // V35: Store SkRect (rather then width & height) in header
     // V36: Remove (obsolete) alphatype from SkColorTable
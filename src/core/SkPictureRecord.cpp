@@ -9,13 +9,19 @@
 
 #include "include/core/SkRRect.h"
 #include "include/core/SkRSXform.h"
+#include "include/core/SkSerialProcs.h"
 #include "include/core/SkTextBlob.h"
+#include "include/core/SkTypeface.h"
 #include "include/private/SkTo.h"
 #include "src/core/SkCanvasPriv.h"
 #include "src/core/SkClipOpPriv.h"
 #include "src/core/SkDrawShadowInfo.h"
 #include "src/core/SkMatrixPriv.h"
+#include "src/core/SkOpts.h"
+#include "src/core/SkPathPriv.h"
 #include "src/core/SkTSearch.h"
+#include "src/core/SkTextBlobPriv.h"
+#include "src/core/SkWriteBuffer.h"
 #include "src/image/SkImage_Base.h"
 #include "src/utils/SkPatchUtils.h"
 
@@ -819,21 +825,12 @@ void SkPictureRecord::onDrawEdgeAAImageSet(const SkCanvas::ImageSetEntry set[],
 
 ///////////////////////////////////////////////////////////////////////////////
 
-// De-duping helper.
+// De-duping helpers.
 
-template <typename T>
-static bool equals(T* a, T* b) { return a->uniqueID() == b->uniqueID(); }
-
-template <>
-bool equals(SkDrawable* a, SkDrawable* b) {
-    // SkDrawable's generationID is not a stable unique identifier.
-    return a == b;
-}
-
-template <typename T>
-static int find_or_append(SkTArray<sk_sp<T>>& array, T* obj) {
+static int find_or_append(SkTArray<sk_sp<SkDrawable>>& array, SkDrawable* obj) {
+    // SkDrawable's generationID is not a stable unique identifier, so we compare pointers.
     for (int i = 0; i < array.count(); i++) {
-        if (equals(array[i].get(), obj)) {
+        if (array[i].get() == obj) {
             return i;
         }
     }
@@ -843,13 +840,71 @@ static int find_or_append(SkTArray<sk_sp<T>>& array, T* obj) {
     return array.count() - 1;
 }
 
+// Finds obj by unique ID, appending it to array if it is not there yet.
+template <typename T>
+static int find_or_append(SkTArray<sk_sp<const T>>& array, SkTHashMap<uint32_t, int>* indices,
+                          const T* obj) {
+    if (int* n = indices->find(obj->uniqueID())) {
+        return *n;
+    }
+    array.push_back(sk_ref_sp(obj));
+    return *indices->set(obj->uniqueID(), array.count() - 1);
+}
+
+// Like find_or_append(), but also finds objects with a different unique ID and the same
+// serialized content.
+template <typename T, typename Content, typename Hash, typename Serialize>
+static int find_or_append(SkTArray<sk_sp<const T>>& array, SkTHashMap<uint32_t, int>* indices,
+                          SkTHashMap<Content, int, Hash>* contents, const T* obj,
+                          Serialize&& serialize) {
+    if (int* n = indices->find(obj->uniqueID())) {
+        return *n;
+    }
+    Content content{serialize(obj)};
+    int n;
+    if (int* m = contents->find(content)) {
+        n = *m;
+    } else {
+        array.push_back(sk_ref_sp(obj));
+        n = array.count() - 1;
+        contents->set(std::move(content), n);
+    }
+    return *indices->set(obj->uniqueID(), n);
+}
+
+static sk_sp<SkData> serialize_blob(const SkTextBlob* blob) {
+    // Typefaces are shared objects, so identifying them by ID is enough here.
+    SkSerialProcs procs;
+    procs.fTypefaceProc = [](SkTypeface* typeface, void*) {
+        uint32_t id = typeface->uniqueID();
+        return SkData::MakeWithCopy(&id, sizeof(id));
+    };
+    SkBinaryWriteBuffer buffer;
+    buffer.setSerialProcs(procs);
+    SkTextBlobPriv::Flatten(*blob, buffer);
+    sk_sp<SkData> data = SkData::MakeUninitialized(buffer.bytesWritten());
+    buffer.writeToMemory(data->writable_data());
+    return data;
+}
+
+uint32_t SkPictureRecord::PathHash::operator()(const SkPath& p) {
+    uint32_t hash = SkOpts::hash(SkPathPriv::PointData(p), p.countPoints() * sizeof(SkPoint));
+    hash = SkOpts::hash(SkPathPriv::VerbData(p), p.countVerbs(), hash);
+    return SkOpts::hash(SkPathPriv::ConicWeightData(p),
+                        SkPathPriv::ConicWeightCnt(p) * sizeof(SkScalar), hash);
+}
+
+uint32_t SkPictureRecord::ContentHash::operator()(const Content& c) {
+    return SkOpts::hash(c.fData->data(), c.fData->size());
+}
+
 sk_sp<SkSurface> SkPictureRecord::onNewSurface(const SkImageInfo& info, const SkSurfaceProps&) {
     return nullptr;
 }
 
 void SkPictureRecord::addImage(const SkImage* image) {
     // convention for images is 0-based index
-    this->addInt(find_or_append(fImages, image));
+    this->addInt(find_or_append(fImages, &fImageIndices, image));
 }
 
 void SkPictureRecord::addMatrix(const SkMatrix& matrix) {
@@ -858,8 +913,12 @@ void SkPictureRecord::addMatrix(const SkMatrix& matrix) {
 
 void SkPictureRecord::addPaintPtr(const SkPaint* paint) {
     if (paint) {
-        fPaints.push_back(*paint);
-        this->addInt(fPaints.count());
+        int* n = fPaintIndices.find(*paint);
+        if (!n) {
+            fPaints.push_back(*paint);
+            n = fPaintIndices.set(*paint, fPaints.count());
+        }
+        this->addInt(*n);
     } else {
         this->addInt(0);
     }
@@ -884,7 +943,7 @@ void SkPictureRecord::addPatch(const SkPoint cubics[12]) {
 
 void SkPictureRecord::addPicture(const SkPicture* picture) {
     // follow the convention of recording a 1-based index
-    this->addInt(find_or_append(fPictures, picture) + 1);
+    this->addInt(find_or_append(fPictures, &fPictureIndices, picture) + 1);
 }
 
 void SkPictureRecord::addDrawable(SkDrawable* drawable) {
@@ -940,12 +999,14 @@ void SkPictureRecord::addText(const void* text, size_t byteLength) {
 
 void SkPictureRecord::addTextBlob(const SkTextBlob* blob) {
     // follow the convention of recording a 1-based index
-    this->addInt(find_or_append(fTextBlobs, blob) + 1);
+    this->addInt(find_or_append(fTextBlobs, &fTextBlobIndices, &fTextBlobContents, blob,
+                                serialize_blob) + 1);
 }
 
 void SkPictureRecord::addVertices(const SkVertices* vertices) {
     // follow the convention of recording a 1-based index
-    this->addInt(find_or_append(fVertices, vertices) + 1);
+    this->addInt(find_or_append(fVertices, &fVerticesIndices, &fVerticesContents, vertices,
+                                [](const SkVertices* v) { return v->encode(); }) + 1);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
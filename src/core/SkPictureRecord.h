@@ -10,6 +10,7 @@
 
 #include "include/core/SkCanvas.h"
 #include "include/core/SkCanvasVirtualEnforcer.h"
+#include "include/core/SkData.h"
 #include "include/core/SkFlattenable.h"
 #include "include/core/SkPicture.h"
 #include "include/core/SkVertices.h"
@@ -250,8 +251,14 @@ protected:
 private:
     SkTArray<SkPaint>  fPaints;
 
+    struct PaintHash {
+        uint32_t operator()(const SkPaint& p) { return p.getHash(); }
+    };
+    SkTHashMap<SkPaint, int, PaintHash> fPaintIndices;  // 1-based indices into fPaints.
+
+    // Paths are deduped by content, so equal paths built separately are only written once.
     struct PathHash {
-        uint32_t operator()(const SkPath& p) { return p.getGenerationID(); }
+        uint32_t operator()(const SkPath& p);
     };
     SkTHashMap<SkPath, int, PathHash> fPaths;
 
@@ -263,6 +270,23 @@ private:
     SkTArray<sk_sp<const SkTextBlob>> fTextBlobs;
     SkTArray<sk_sp<const SkVertices>> fVertices;
 
+    // 0-based indices into the arrays above, by unique ID.
+    SkTHashMap<uint32_t, int> fImageIndices;
+    SkTHashMap<uint32_t, int> fPictureIndices;
+    SkTHashMap<uint32_t, int> fTextBlobIndices;
+    SkTHashMap<uint32_t, int> fVerticesIndices;
+
+    // Text blobs and vertices are also deduped by their serialized content.
+    struct Content {
+        sk_sp<SkData> fData;
+        bool operator==(const Content& that) const { return fData->equals(that.fData.get()); }
+    };
+    struct ContentHash {
+        uint32_t operator()(const Content& c);
+    };
+    SkTHashMap<Content, int, ContentHash> fTextBlobContents;
+    SkTHashMap<Content, int, ContentHash> fVerticesContents;
+
     uint32_t fRecordFlags;
     int      fInitialSaveCount;
 
@@ -0,0 +1,160 @@
+/*
+ * Copyright 2020 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkCanvas.h"
+#include "src/core/SkBigPicture.h"
+#include "src/core/SkPicturePriv.h"
+#include "src/core/SkPictureTileIndex.h"
+#include "src/core/SkRecordDraw.h"
+
+sk_sp<SkPictureTileIndex> SkPictureTileIndex::Make(sk_sp<const SkPicture> picture,
+                                                   const SkIRect& gridBounds,
+                                                   const SkISize& tileSize) {
+    if (!picture || gridBounds.isEmpty() || tileSize.isEmpty()) {
+        return nullptr;
+    }
+    int64_t columns = (gridBounds.width64()  + tileSize.width()  - 1) / tileSize.width(),
+            rows    = (gridBounds.height64() + tileSize.height() - 1) / tileSize.height();
+    if (columns * rows >= SK_MaxS32) {
+        return nullptr;
+    }
+    return sk_sp<SkPictureTileIndex>(new SkPictureTileIndex(std::move(picture),
+                                                            gridBounds, tileSize,
+                                                            SkToInt(columns), SkToInt(rows)));
+}
+
+SkPictureTileIndex::SkPictureTileIndex(sk_sp<const SkPicture> picture,
+                                       const SkIRect& gridBounds,
+                                       const SkISize& tileSize,
+                                       int columns, int rows)
+    : fPicture(std::move(picture))
+    , fGridBounds(gridBounds)
+    , fTileSize(tileSize)
+    , fColumns(columns)
+    , fRows(rows) {
+    // Compute the same bounds the picture's BBH would hold.  Pictures that are not
+    // SkBigPictures hold at most one op, bounded by their cull rect.
+    int opCount = 0;
+    SkAutoTMalloc<SkRect> bounds;
+    if (const SkBigPicture* big = SkPicturePriv::AsSkBigPicture(*fPicture)) {
+        opCount = big->record()->count();
+        bounds.reset(opCount);
+        SkRecordFillBounds(big->cullRect(), *big->record(), bounds);
+    } else if (fPicture->approximateOpCount() > 0) {
+        opCount = 1;
+        bounds.reset(1);
+        bounds[0] = fPicture->cullRect();
+    }
+
+    // Each op can only touch the tiles spanned by its bounds (plus the one pixel outset).
+    auto forEachTile = [&](const SkRect& r, auto&& fn) {
+        if (!r.isFinite() || r.isEmpty()) {
+            return;
+        }
+        const float left = (r.fLeft  - 1 - fGridBounds.fLeft) / fTileSize.width(),
+                    top  = (r.fTop   - 1 - fGridBounds.fTop)  / fTileSize.height(),
+                    right  = (r.fRight  + 1 - fGridBounds.fLeft) / fTileSize.width(),
+                    bottom = (r.fBottom + 1 - fGridBounds.fTop)  / fTileSize.height();
+        const int c0 = SkTPin(sk_float_floor2int(left),   0, fColumns - 1),
+                  r0 = SkTPin(sk_float_floor2int(top),    0, fRows    - 1),
+                  c1 = SkTPin(sk_float_floor2int(right),  0, fColumns - 1),
+                  r1 = SkTPin(sk_float_floor2int(bottom), 0, fRows    - 1);
+        for (int row = r0; row <= r1; row++) {
+            for (int column = c0; column <= c1; column++) {
+                if (SkRect::Intersects(r, this->tileQuery(column, row))) {
+                    fn(row * fColumns + column);
+                }
+            }
+        }
+    };
+
+    // Count each tile's ops, lay the lists out back to back, then fill them in op order.
+    const int tileCount = fColumns * fRows;
+    fOffsets.setCount(tileCount + 1);
+    sk_bzero(fOffsets.begin(), fOffsets.bytes());
+    for (int i = 0; i < opCount; i++) {
+        forEachTile(bounds[i], [&](int tile) { fOffsets[tile + 1]++; });
+    }
+    for (int tile = 0; tile < tileCount; tile++) {
+        fOffsets[tile + 1] += fOffsets[tile];
+    }
+    fOps.setCount(fOffsets[tileCount]);
+
+    SkAutoTMalloc<int> cursors(tileCount);
+    memcpy(cursors.get(), fOffsets.begin(), tileCount * sizeof(int));
+    for (int i = 0; i < opCount; i++) {
+        forEachTile(bounds[i], [&](int tile) { fOps[cursors[tile]++] = i; });
+    }
+}
+
+SkIRect SkPictureTileIndex::tileRect(int column, int row) const {
+    SkASSERT(0 <= column && column < fColumns);
+    SkASSERT(0 <= row    && row    < fRows);
+    // The last tile may reach past SK_MaxS32, so step through the grid in 64 bits.  Each tile's
+    // top-left corner lies inside fGridBounds, so the clipped tile fits in ints again.
+    const int64_t left = fGridBounds.fLeft + (int64_t)column * fTileSize.width(),
+                  top  = fGridBounds.fTop  + (int64_t)row    * fTileSize.height();
+    return SkIRect::MakeLTRB(SkToS32(left), SkToS32(top),
+                             (int)SkTMin<int64_t>(left + fTileSize.width(),  fGridBounds.fRight),
+                             (int)SkTMin<int64_t>(top  + fTileSize.height(), fGridBounds.fBottom));
+}
+
+SkRect SkPictureTileIndex::tileQuery(int column, int row) const {
+    return SkRect::Make(this->tileRect(column, row)).makeOutset(1, 1);
+}
+
+int SkPictureTileIndex::opCount(int column, int row) const {
+    SkASSERT(0 <= column && column < fColumns);
+    SkASSERT(0 <= row    && row    < fRows);
+    const int tile = row * fColumns + column;
+    return fOffsets[tile + 1] - fOffsets[tile];
+}
+
+void SkPictureTileIndex::playbackTile(SkCanvas* canvas, int column, int row,
+                                      SkPicture::AbortCallback* callback) const {
+    SkASSERT(canvas);
+    SkASSERT(0 <= column && column < fColumns);
+    SkASSERT(0 <= row    && row    < fRows);
+    const int tile = row * fColumns + column;
+    const int start = fOffsets[tile],
+              count = fOffsets[tile + 1] - start;
+    if (count == 0) {
+        return;
+    }
+
+    if (const SkBigPicture* big = SkPicturePriv::AsSkBigPicture(*fPicture)) {
+        SkRecordDrawOps(*big->record(),
+                        canvas,
+                        big->drawablePicts(),
+                        nullptr,
+                        big->drawableCount(),
+                        fOps.begin() + start,
+                        count,
+                        callback);
+    } else {
+        fPicture->playback(canvas, callback);
+    }
+}
+
+void SkPictureTileIndex::playback(SkCanvas* canvas, SkPicture::AbortCallback* callback) const {
+    SkASSERT(canvas);
+    const SkRect query = canvas->getLocalClipBounds();
+
+    // Any tile whose query contains ours lists every op the BBH would return for it.
+    if (query.isFinite() && !query.isEmpty()) {
+        const int column = sk_float_floor2int((query.centerX() - fGridBounds.fLeft) /
+                                              fTileSize.width()),
+                  row    = sk_float_floor2int((query.centerY() - fGridBounds.fTop) /
+                                              fTileSize.height());
+        if (0 <= column && column < fColumns && 0 <= row && row < fRows &&
+            this->tileQuery(column, row).contains(query)) {
+            this->playbackTile(canvas, column, row, callback);
+            return;
+        }
+    }
+    fPicture->playback(canvas, callback);
+}
@@ -0,0 +1,73 @@
+/*
+ * Copyright 2020 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkPictureTileIndex_DEFINED
+#define SkPictureTileIndex_DEFINED
+
+#include "include/core/SkPicture.h"
+#include "include/core/SkRect.h"
+#include "include/core/SkRefCnt.h"
+#include "include/private/SkTDArray.h"
+
+class SkCanvas;
+
+// SkPictureTileIndex precomputes, for a fixed grid of tiles, which ops of a picture touch each
+// tile.  Playing a tile back then walks its op list directly instead of querying the picture's
+// SkBBoxHierarchy, which pays off when the same picture is drawn into many tiles every frame.
+//
+// Tiles and their op lists are in the picture's identity space.  An op is listed for a tile if
+// the BBH would have returned it for a canvas clipped exactly to that tile, so the tile's rect is
+// outset by one pixel to match SkCanvas::getLocalClipBounds().
+class SkPictureTileIndex : public SkRefCnt {
+public:
+    // Indexes picture over a grid covering gridBounds, tiled from its top-left corner.
+    // Returns nullptr if gridBounds or tileSize is empty.
+    static sk_sp<SkPictureTileIndex> Make(sk_sp<const SkPicture> picture,
+                                          const SkIRect& gridBounds,
+                                          const SkISize& tileSize);
+
+    int columns() const { return fColumns; }
+    int rows() const { return fRows; }
+
+    // The bounds of tile (column, row), clipped to gridBounds.
+    SkIRect tileRect(int column, int row) const;
+
+    // Number of ops listed for tile (column, row).
+    int opCount(int column, int row) const;
+
+    // Draws the ops listed for tile (column, row) into canvas.  The caller is responsible for
+    // setting up the canvas' matrix and clip; ops are listed for the tile's identity-space bounds.
+    void playbackTile(SkCanvas*, int column, int row,
+                      SkPicture::AbortCallback* = nullptr) const;
+
+    // Draws the picture into canvas, as SkPicture::playback() would.  If the canvas' local clip
+    // bounds fall inside a single tile we use its op list, otherwise the picture draws itself.
+    void playback(SkCanvas*, SkPicture::AbortCallback* = nullptr) const;
+
+    const SkPicture* picture() const { return fPicture.get(); }
+
+private:
+    // columns and rows are computed and validated in 64 bits by Make().
+    SkPictureTileIndex(sk_sp<const SkPicture>, const SkIRect& gridBounds, const SkISize& tileSize,
+                       int columns, int rows);
+
+    // The rect an op's bounds must intersect to be listed for tile (column, row).
+    SkRect tileQuery(int column, int row) const;
+
+    sk_sp<const SkPicture> fPicture;
+    SkIRect                fGridBounds;
+    SkISize                fTileSize;
+    int                    fColumns;
+    int                    fRows;
+
+    // Op lists for all tiles, stored back to back in row-major tile order.  The ops of tile i are
+    // fOps[fOffsets[i]] through fOps[fOffsets[i+1] - 1], in increasing order.
+    SkTDArray<int>         fOffsets;
+    SkTDArray<int>         fOps;
+};
+
+#endif//SkPictureTileIndex_DEFINED
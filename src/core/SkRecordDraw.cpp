@@ -10,6 +10,26 @@
 #include "src/core/SkRecordDraw.h"
 #include "src/utils/SkPatchUtils.h"
 
+static void draw_ops(const SkRecord& record,
+                     SkCanvas* canvas,
+                     SkPicture const* const drawablePicts[],
+                     SkDrawable* const drawables[],
+                     int drawableCount,
+                     const int ops[],
+                     int opCount,
+                     SkPicture::AbortCallback* callback) {
+    SkRecords::Draw draw(canvas, drawablePicts, drawables, drawableCount);
+    for (int i = 0; i < opCount; i++) {
+        if (callback && callback->abort()) {
+            return;
+        }
+        // This visit call uses the SkRecords::Draw::operator() to call
+        // methods on the |canvas|, wrapped by methods defined with the
+        // DRAW() macro.
+        record.visit(ops[i], draw);
+    }
+}
+
 void SkRecordDraw(const SkRecord& record,
                   SkCanvas* canvas,
                   SkPicture const* const drawablePicts[],
@@ -30,16 +50,8 @@ void SkRecordDraw(const SkRecord& record,
         SkTDArray<int> ops;
         static_cast<const SkBBoxHierarchy_Base*>(bbh)->search(query, &ops);
 
-        SkRecords::Draw draw(canvas, drawablePicts, drawables, drawableCount);
-        for (int i = 0; i < ops.count(); i++) {
-            if (callback && callback->abort()) {
-                return;
-            }
-            // This visit call uses the SkRecords::Draw::operator() to call
-            // methods on the |canvas|, wrapped by methods defined with the
-            // DRAW() macro.
-            record.visit(ops[i], draw);
-        }
+        draw_ops(record, canvas, drawablePicts, drawables, drawableCount,
+                 ops.begin(), ops.count(), callback);
     } else {
         // Draw all ops.
         SkRecords::Draw draw(canvas, drawablePicts, drawables, drawableCount);
@@ -55,6 +67,19 @@ void SkRecordDraw(const SkRecord& record,
     }
 }
 
+void SkRecordDrawOps(const SkRecord& record,
+                     SkCanvas* canvas,
+                     SkPicture const* const drawablePicts[],
+                     SkDrawable* const drawables[],
+                     int drawableCount,
+                     const int ops[],
+                     int opCount,
+                     SkPicture::AbortCallback* callback) {
+    SkAutoCanvasRestore saveRestore(canvas, true /*save now, restore at exit*/);
+
+    draw_ops(record, canvas, drawablePicts, drawables, drawableCount, ops, opCount, callback);
+}
+
 void SkRecordPartialDraw(const SkRecord& record, SkCanvas* canvas,
                          SkPicture const* const drawablePicts[], int drawableCount,
                          int start, int stop,
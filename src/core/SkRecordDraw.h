@@ -31,6 +31,13 @@ void SkRecordDraw(const SkRecord&, SkCanvas*, SkPicture const* const drawablePic
                   SkDrawable* const drawables[], int drawableCount,
                   const SkBBoxHierarchy*, SkPicture::AbortCallback*);
 
+// Draw the listed ops of an SkRecord into an SkCanvas, in the order given.  Like the BBH path of
+// SkRecordDraw(), but with the op list computed by the caller (e.g. by SkPictureTileIndex).
+// The list must be sorted and must keep Save/Restore pairs together.
+void SkRecordDrawOps(const SkRecord&, SkCanvas*, SkPicture const* const drawablePicts[],
+                     SkDrawable* const drawables[], int drawableCount,
+                     const int ops[], int opCount, SkPicture::AbortCallback*);
+
 // Draw a portion of an SkRecord into an SkCanvas.
 // When drawing a portion of an SkRecord the CTM on the passed in canvas must be
 // the composition of the replay matrix with the record-time CTM (for the portion
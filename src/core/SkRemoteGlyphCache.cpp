@@ -182,6 +182,11 @@ bool SkFuzzDeserializeSkDescriptor(sk_sp<SkData> bytes, SkAutoDescriptor* ad) {
 // Paths use a SkWriter32 which requires 4 byte alignment.
 static const size_t kPathAlignment  = 4u;
 
+// When there is a glyph image arena, each image is preceded by its offset in the arena, or by
+// this if the image follows in the strike data instead. Without an arena nothing is written, so
+// the strike data is unchanged.
+static const uint64_t kInlineImage = ~0ull;
+
 // -- StrikeSpec -----------------------------------------------------------------------------------
 struct StrikeSpec {
     StrikeSpec() = default;
@@ -232,7 +237,7 @@ public:
                  SkDiscardableHandleId discardableHandleId);
     ~RemoteStrike() override;
 
-    void writePendingGlyphs(Serializer* serializer);
+    void writePendingGlyphs(Serializer* serializer, SkStrikeServer* server);
     SkDiscardableHandleId discardableHandleId() const { return fDiscardableHandleId; }
 
     const SkDescriptor& getDescriptor() const override {
@@ -530,7 +535,7 @@ void SkStrikeServer::writeStrikeData(std::vector<uint8_t>* memory) {
 #ifdef SK_DEBUG
             [&](RemoteStrike* strike) {
                 if (strike->hasPendingGlyphs()) {
-                    strike->writePendingGlyphs(&serializer);
+                    strike->writePendingGlyphs(&serializer, this);
                     strike->resetScalerContext();
                 }
                 auto it = fDescToRemoteStrike.find(&strike->getDescriptor());
@@ -539,9 +544,9 @@ void SkStrikeServer::writeStrikeData(std::vector<uint8_t>* memory) {
             }
 
 #else
-            [&serializer](RemoteStrike* strike) {
+            [&serializer, this](RemoteStrike* strike) {
                 if (strike->hasPendingGlyphs()) {
-                    strike->writePendingGlyphs(&serializer);
+                    strike->writePendingGlyphs(&serializer, this);
                     strike->resetScalerContext();
                 }
             }
@@ -550,6 +555,27 @@ void SkStrikeServer::writeStrikeData(std::vector<uint8_t>* memory) {
     fRemoteStrikesToSend.reset();
 }
 
+void SkStrikeServer::setGlyphImageArena(void* memory, size_t size) {
+    fGlyphImageArena = static_cast<char*>(memory);
+    fGlyphImageArenaSize = memory ? size : 0;
+    fGlyphImageArenaUsed = 0;
+    fGlyphImageArenaMisses = 0;
+}
+
+void* SkStrikeServer::allocateSharedImage(size_t size, size_t alignment, uint64_t* offset) {
+    size_t aligned = pad(fGlyphImageArenaUsed, alignment);
+    if (fGlyphImageArena == nullptr) {
+        return nullptr;
+    }
+    if (aligned > fGlyphImageArenaSize || size > fGlyphImageArenaSize - aligned) {
+        fGlyphImageArenaMisses++;
+        return nullptr;
+    }
+    fGlyphImageArenaUsed = aligned + size;
+    *offset = aligned;
+    return fGlyphImageArena + aligned;
+}
+
 SkStrikeServer::RemoteStrike* SkStrikeServer::getOrCreateCache(
         const SkPaint& paint,
         const SkFont& font,
@@ -665,7 +691,8 @@ static void writeGlyph(const SkGlyph& glyph, Serializer* serializer) {
     serializer->write<uint8_t>(glyph.maskFormat());
 }
 
-void SkStrikeServer::RemoteStrike::writePendingGlyphs(Serializer* serializer) {
+void SkStrikeServer::RemoteStrike::writePendingGlyphs(
+        Serializer* serializer, SkStrikeServer* server) {
     SkASSERT(this->hasPendingGlyphs());
 
     // Write the desc.
@@ -689,7 +716,15 @@ void SkStrikeServer::RemoteStrike::writePendingGlyphs(Serializer* serializer) {
         writeGlyph(glyph, serializer);
         auto imageSize = glyph.imageSize();
         if (imageSize > 0 && FitsInAtlas(glyph)) {
-            glyph.fImage = serializer->allocate(imageSize, glyph.formatAlignment());
+            if (server->fGlyphImageArena != nullptr) {
+                uint64_t offset = kInlineImage;
+                glyph.fImage =
+                        server->allocateSharedImage(imageSize, glyph.formatAlignment(), &offset);
+                serializer->write<uint64_t>(offset);
+            }
+            if (glyph.fImage == nullptr) {
+                glyph.fImage = serializer->allocate(imageSize, glyph.formatAlignment());
+            }
             fContext->getImage(glyph);
         }
     }
@@ -846,8 +881,10 @@ void SkStrikeServer::RemoteStrike::prepareForPathDrawing(
 class SkStrikeClient::DiscardableStrikePinner : public SkStrikePinner {
 public:
     DiscardableStrikePinner(SkDiscardableHandleId discardableHandleId,
-                            sk_sp<DiscardableHandleManager> manager)
-            : fDiscardableHandleId(discardableHandleId), fManager(std::move(manager)) {}
+                            sk_sp<DiscardableHandleManager> manager,
+                            sk_sp<SkData> glyphImageArena)
+            : fDiscardableHandleId(discardableHandleId), fManager(std::move(manager))
+            , fGlyphImageArena(std::move(glyphImageArena)) {}
 
     ~DiscardableStrikePinner() override = default;
     bool canDelete() override { return fManager->deleteHandle(fDiscardableHandleId); }
@@ -855,14 +892,18 @@ public:
 private:
     const SkDiscardableHandleId fDiscardableHandleId;
     sk_sp<DiscardableHandleManager> fManager;
+    // The strike's glyphs may use images in the arena, so it must outlive the strike.
+    const sk_sp<SkData> fGlyphImageArena;
 };
 
 SkStrikeClient::SkStrikeClient(sk_sp<DiscardableHandleManager> discardableManager,
                                bool isLogging,
-                               SkStrikeCache* strikeCache)
+                               SkStrikeCache* strikeCache,
+                               sk_sp<SkData> glyphImageArena)
         : fDiscardableHandleManager(std::move(discardableManager))
         , fStrikeCache{strikeCache ? strikeCache : SkStrikeCache::GlobalStrikeCache()}
-        , fIsLogging{isLogging} {}
+        , fIsLogging{isLogging}
+        , fGlyphImageArena{std::move(glyphImageArena)} {}
 
 SkStrikeClient::~SkStrikeClient() = default;
 
@@ -956,7 +997,8 @@ bool SkStrikeClient::readStrikeData(const volatile void* memory, size_t memorySi
             strike = fStrikeCache->createStrikeExclusive(
                     *client_desc, std::move(scaler), &fontMetrics,
                     std::make_unique<DiscardableStrikePinner>(spec.discardableHandleId,
-                                                                fDiscardableHandleManager));
+                                                              fDiscardableHandleManager,
+                                                              fGlyphImageArena));
             auto proxyContext = static_cast<SkScalerContextProxy*>(strike->getScalerContext());
             proxyContext->initCache(strike.get(), fStrikeCache);
         }
@@ -966,14 +1008,29 @@ bool SkStrikeClient::readStrikeData(const volatile void* memory, size_t memorySi
             SkTLazy<SkGlyph> glyph;
             if (!ReadGlyph(glyph, &deserializer)) READ_FAILURE
 
+            bool isShared = false;
             if (!glyph->isEmpty() && SkStrikeForGPU::FitsInAtlas(*glyph)) {
-                const volatile void* image =
-                        deserializer.read(glyph->imageSize(), glyph->formatAlignment());
-                if (!image) READ_FAILURE
-                glyph->fImage = (void*)image;
+                uint64_t offset = kInlineImage;
+                if (fGlyphImageArena && !deserializer.read<uint64_t>(&offset)) READ_FAILURE
+                if (offset == kInlineImage) {
+                    const volatile void* image =
+                            deserializer.read(glyph->imageSize(), glyph->formatAlignment());
+                    if (!image) READ_FAILURE
+                    glyph->fImage = (void*)image;
+                } else {
+                    size_t arenaSize = fGlyphImageArena->size();
+                    if (offset > arenaSize || glyph->imageSize() > arenaSize - offset) READ_FAILURE
+                    if (offset % glyph->formatAlignment() != 0) READ_FAILURE
+                    glyph->fImage = (char*)fGlyphImageArena->data() + offset;
+                    isShared = true;
+                }
             }
 
-            strike->mergeGlyphAndImage(glyph->getPackedID(), *glyph);
+            if (isShared) {
+                strike->mergeGlyphAndSharedImage(glyph->getPackedID(), *glyph);
+            } else {
+                strike->mergeGlyphAndImage(glyph->getPackedID(), *glyph);
+            }
         }
 
         if (!deserializer.read<uint64_t>(&glyphPathsCount)) READ_FAILURE
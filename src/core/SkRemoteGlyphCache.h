@@ -109,6 +109,20 @@ public:
     // unlocked after this call.
     SK_SPI void writeStrikeData(std::vector<uint8_t>* memory);
 
+    // Writes glyph images to memory, which the clients map read-only and pass to their
+    // SkStrikeClient, instead of into the strike data. The clients use the images in place rather
+    // than copying them, so the server never reuses space in memory. Once it is full, images are
+    // written into the strike data again. The memory must outlive the server.
+    //
+    // The strike data refers to the arena, so it can only be read by clients with the arena, and
+    // clients with an arena can only read strike data from a server with one.
+    SK_SPI void setGlyphImageArena(void* memory, size_t size);
+
+    // The number of glyph images written into the strike data because the glyph image arena was
+    // full, since it was set. Space in the arena is never reclaimed, so once this starts growing,
+    // the arena is full for good; a new server and clients with a larger arena can start over.
+    SK_SPI int glyphImageArenaMisses() const { return fGlyphImageArenaMisses; }
+
     // Methods used internally in Skia ------------------------------------------
     class RemoteStrike;
 
@@ -141,6 +155,10 @@ private:
 
     void checkForDeletedEntries();
 
+    // Returns space for a glyph image in the glyph image arena and sets offset to where it is, or
+    // returns nullptr if there is no arena or it is full.
+    void* allocateSharedImage(size_t size, size_t alignment, uint64_t* offset);
+
     RemoteStrike* getOrCreateCache(const SkDescriptor& desc,
                                    const SkTypeface& typeface,
                                    SkScalerContextEffects effects);
@@ -163,6 +181,12 @@ private:
     // State cached until the next serialization.
     SkTHashSet<RemoteStrike*> fRemoteStrikesToSend;
     std::vector<WireTypeface> fTypefacesToSend;
+
+    // See setGlyphImageArena().
+    char* fGlyphImageArena{nullptr};
+    size_t fGlyphImageArenaSize{0};
+    size_t fGlyphImageArenaUsed{0};
+    int fGlyphImageArenaMisses{0};
 };
 
 class SkStrikeClient {
@@ -205,9 +229,14 @@ public:
         virtual void notifyReadFailure(const ReadFailureData& data) {}
     };
 
+    // glyphImageArena is this process's read-only mapping of the memory the server was given in
+    // SkStrikeServer::setGlyphImageArena(), if any. Glyphs refer to their images in it, and their
+    // strikes keep it alive. Only image metrics are checked against the arena, so a server can
+    // change the pixels of its own glyphs after sending them, but nothing outside the arena.
     SK_SPI explicit SkStrikeClient(sk_sp<DiscardableHandleManager>,
                                    bool isLogging = true,
-                                   SkStrikeCache* strikeCache = nullptr);
+                                   SkStrikeCache* strikeCache = nullptr,
+                                   sk_sp<SkData> glyphImageArena = nullptr);
     SK_SPI ~SkStrikeClient();
 
     // Deserializes the typeface previously serialized using the SkStrikeServer. Returns null if the
@@ -230,6 +259,7 @@ private:
     sk_sp<DiscardableHandleManager> fDiscardableHandleManager;
     SkStrikeCache* const fStrikeCache;
     const bool fIsLogging;
+    const sk_sp<SkData> fGlyphImageArena;
 };
 
 // For exposure to fuzzing only.
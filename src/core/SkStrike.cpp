@@ -47,8 +47,17 @@ SkGlyph* SkStrike::glyph(SkPackedGlyphID packedGlyphID) {
     VALIDATE();
     SkGlyph* glyph = fGlyphMap.findOrNull(packedGlyphID);
     if (glyph == nullptr) {
-        glyph = this->makeGlyph(packedGlyphID);
-        fScalerContext->getMetrics(glyph);
+        SkGlyphPrototype saved;
+        const SkGlyphDiskCache::Entry* entry = this->diskCacheEntry();
+        if (entry && entry->metrics(packedGlyphID, &saved)) {
+            fMemoryUsed += sizeof(SkGlyph);
+            glyph = fAlloc.make<SkGlyph>(saved);
+            fGlyphMap.set(glyph);
+        } else {
+            glyph = this->makeGlyph(packedGlyphID);
+            fScalerContext->getMetrics(glyph);
+            fHasUnsavedGlyphs = true;
+        }
     }
     return glyph;
 }
@@ -71,6 +80,15 @@ SkGlyph* SkStrike::glyphOrNull(SkPackedGlyphID id) const {
 }
 
 const SkPath* SkStrike::preparePath(SkGlyph* glyph) {
+    if (!glyph->setPathHasBeenCalled()) {
+        SkPath saved;
+        bool hasPath;
+        const SkGlyphDiskCache::Entry* entry = this->diskCacheEntry();
+        if (entry && entry->path(glyph->getPackedID(), &hasPath, &saved)) {
+            return this->preparePath(glyph, hasPath ? &saved : nullptr);
+        }
+        fHasUnsavedGlyphs = true;
+    }
     if (glyph->setPath(&fAlloc, fScalerContext.get())) {
         fMemoryUsed += glyph->path()->approximateBytesUsed();
     }
@@ -107,7 +125,15 @@ SkSpan<const SkGlyph*> SkStrike::internalPrepare(
 }
 
 const void* SkStrike::prepareImage(SkGlyph* glyph) {
-    if (glyph->setImage(&fAlloc, fScalerContext.get())) {
+    if (!glyph->setImageHasBeenCalled()) {
+        const SkGlyphDiskCache::Entry* entry = this->diskCacheEntry();
+        const void* saved = entry ? entry->image(*glyph) : nullptr;
+        if (saved != nullptr) {
+            glyph->setImage(&fAlloc, saved);
+        } else {
+            glyph->setImage(&fAlloc, fScalerContext.get());
+            fHasUnsavedGlyphs = true;
+        }
         fMemoryUsed += glyph->imageSize();
     }
     return glyph->image();
@@ -124,6 +150,18 @@ SkGlyph* SkStrike::mergeGlyphAndImage(SkPackedGlyphID toID, const SkGlyph& from)
     return glyph;
 }
 
+SkGlyph* SkStrike::mergeGlyphAndSharedImage(SkPackedGlyphID toID, const SkGlyph& from) {
+    SkGlyph* glyph = fGlyphMap.findOrNull(toID);
+    if (glyph == nullptr) {
+        glyph = this->makeGlyph(toID);
+    }
+    // The image is not ours, but count it anyway so the cache is purged the same either way.
+    if (glyph->setMetricsAndSharedImage(from)) {
+        fMemoryUsed += glyph->imageSize();
+    }
+    return glyph;
+}
+
 const SkGlyph* SkStrike::getCachedGlyphAnySubPix(SkGlyphID glyphID, SkPackedGlyphID vetoID) const {
     for (SkFixed subY = 0; subY < SK_Fixed1; subY += SK_FixedQuarter) {
         for (SkFixed subX = 0; subX < SK_Fixed1; subX += SK_FixedQuarter) {
@@ -15,6 +15,7 @@
 #include "src/core/SkArenaAlloc.h"
 #include "src/core/SkDescriptor.h"
 #include "src/core/SkGlyph.h"
+#include "src/core/SkGlyphDiskCache.h"
 #include "src/core/SkGlyphRunPainter.h"
 #include "src/core/SkScalerContext.h"
 #include "src/core/SkStrikeForGPU.h"
@@ -51,6 +52,10 @@ public:
     // created by a search of desperation.
     SkGlyph* mergeGlyphAndImage(SkPackedGlyphID toID, const SkGlyph& from);
 
+    // Like mergeGlyphAndImage, but the toGlyph uses from's image in place. The owner of the image
+    // must keep it alive as long as this strike, usually through the strike's pinner.
+    SkGlyph* mergeGlyphAndSharedImage(SkPackedGlyphID toID, const SkGlyph& from);
+
     // If the path has never been set, then add a path to glyph.
     const SkPath* preparePath(SkGlyph* glyph, const SkPath* path);
 
@@ -112,6 +117,23 @@ public:
 
     SkScalerContext* getScalerContext() const { return fScalerContext.get(); }
 
+    // Glyphs saved to disk by an earlier strike with the same descriptor. Once found, they are
+    // used instead of asking the scaler context where possible.
+    void setDiskCacheLookup(sk_sp<SkGlyphDiskCache::Lookup> lookup) {
+        fDiskCacheLookup = std::move(lookup);
+    }
+    const SkGlyphDiskCache::Entry* diskCacheEntry() const {
+        return fDiskCacheLookup ? fDiskCacheLookup->entry() : nullptr;
+    }
+
+    // True if the scaler context generated anything since the strike was created.
+    bool hasUnsavedGlyphs() const { return fHasUnsavedGlyphs; }
+
+    template <typename Fn>
+    void forEachGlyph(Fn&& fn) const {
+        fGlyphMap.foreach([&](const SkGlyph* glyph) { fn(*glyph); });
+    }
+
 #ifdef SK_DEBUG
     void forceValidate() const;
     void validate() const;
@@ -192,6 +214,9 @@ private:
     // Tracks (approx) how much ram is tied-up in this strike.
     size_t                  fMemoryUsed;
 
+    sk_sp<SkGlyphDiskCache::Lookup> fDiskCacheLookup;
+    bool                            fHasUnsavedGlyphs{false};
+
     const SkGlyphPositionRoundingSpec fRoundingSpec;
 };
 
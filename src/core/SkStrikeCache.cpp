@@ -14,9 +14,12 @@
 #include "include/core/SkTypeface.h"
 #include "include/private/SkMutex.h"
 #include "include/private/SkTemplates.h"
+#include "src/core/SkGlyphDiskCache.h"
 #include "src/core/SkGlyphRunPainter.h"
 #include "src/core/SkStrike.h"
 
+#include <vector>
+
 class SkStrikeCache::Node final : public SkStrikeForGPU {
 public:
     Node(SkStrikeCache* strikeCache,
@@ -58,10 +61,15 @@ public:
     SkStrikeCache* const            fStrikeCache;
     Node*                           fNext{nullptr};
     Node*                           fPrev{nullptr};
+    uint64_t                        fLastUse{0};
     SkStrike                        fStrike;
     std::unique_ptr<SkStrikePinner> fPinner;
 };
 
+const SkDescriptor& SkStrikeCache::NodeTraits::GetKey(const Node* node) {
+    return node->fStrike.getDescriptor();
+}
+
 bool gSkUseThreadLocalStrikeCaches_IAcknowledgeThisIsIncrediblyExperimental = false;
 
 SkStrikeCache* SkStrikeCache::GlobalStrikeCache() {
@@ -132,11 +140,14 @@ bool operator == (decltype(nullptr), const SkStrikeCache::ExclusiveStrikePtr& rh
 }
 
 SkStrikeCache::~SkStrikeCache() {
-    Node* node = fHead;
-    while (node) {
-        Node* next = node->fNext;
-        delete node;
-        node = next;
+    for (Shard& shard : fShards) {
+        SkAutoSpinlock ac(shard.fLock);
+        Node* node = shard.fHead;
+        while (node) {
+            Node* next = node->fNext;
+            delete node;
+            node = next;
+        }
     }
 }
 
@@ -170,6 +181,10 @@ auto SkStrikeCache::findOrCreateStrike(const SkDescriptor& desc,
     if (node == nullptr) {
         auto scaler = CreateScalerContext(desc, effects, typeface);
         node = this->createStrike(desc, std::move(scaler));
+        // The strike's file is mapped on the disk cache's thread; until then the scaler is used.
+        if (sk_sp<SkGlyphDiskCache> diskCache = SkGlyphDiskCache::Get()) {
+            node->fStrike.setDiskCacheLookup(diskCache->findLater(desc, typeface));
+        }
     }
     return node;
 }
@@ -253,13 +268,18 @@ void SkStrikeCache::attachNode(Node* node) {
     if (node == nullptr) {
         return;
     }
-    SkAutoSpinlock ac(fLock);
+    {
+        Shard& shard = this->shardFor(node->fStrike.getDescriptor());
+        SkAutoSpinlock ac(shard.fLock);
 
-    this->validate();
-    node->fStrike.validate();
+        this->validate(shard);
+        node->fStrike.validate();
 
-    this->internalAttachToHead(node);
-    this->internalPurge();
+        this->internalAttachToHead(shard, node);
+    }
+    if (this->overBudget()) {
+        this->purge();
+    }
 }
 
 SkExclusiveStrikePtr SkStrikeCache::findStrikeExclusive(const SkDescriptor& desc) {
@@ -267,13 +287,13 @@ SkExclusiveStrikePtr SkStrikeCache::findStrikeExclusive(const SkDescriptor& desc
 }
 
 auto SkStrikeCache::findAndDetachStrike(const SkDescriptor& desc) -> Node* {
-    SkAutoSpinlock ac(fLock);
+    Shard& shard = this->shardFor(desc);
+    SkAutoSpinlock ac(shard.fLock);
 
-    for (Node* node = fHead; node != nullptr; node = node->fNext) {
-        if (node->fStrike.getDescriptor() == desc) {
-            this->internalDetachCache(node);
-            return node;
-        }
+    if (Node** found = shard.fIndex.find(desc)) {
+        Node* node = *found;
+        this->internalDetachCache(shard, node);
+        return node;
     }
 
     return nullptr;
@@ -308,23 +328,26 @@ static bool loose_compare(const SkDescriptor& lhs, const SkDescriptor& rhs) {
 
 bool SkStrikeCache::desperationSearchForImage(const SkDescriptor& desc, SkGlyph* glyph,
                                               SkStrike* targetCache) {
-    SkAutoSpinlock ac(fLock);
-
     SkGlyphID glyphID = glyph->getGlyphID();
-    for (Node* node = fHead; node != nullptr; node = node->fNext) {
-        if (loose_compare(node->fStrike.getDescriptor(), desc)) {
-            if (SkGlyph *fallback = node->fStrike.glyphOrNull(glyph->getPackedID())) {
-                // This desperate-match node may disappear as soon as we drop fLock, so we
-                // need to copy the glyph from node into this strike, including a
-                // deep copy of the mask.
-                targetCache->mergeGlyphAndImage(glyph->getPackedID(), *fallback);
-                return true;
-            }
+    // Loosely matching descriptors hash differently, so every shard has to be searched.
+    for (Shard& shard : fShards) {
+        SkAutoSpinlock ac(shard.fLock);
+
+        for (Node* node = shard.fHead; node != nullptr; node = node->fNext) {
+            if (loose_compare(node->fStrike.getDescriptor(), desc)) {
+                if (SkGlyph *fallback = node->fStrike.glyphOrNull(glyph->getPackedID())) {
+                    // This desperate-match node may disappear as soon as we drop the shard's
+                    // lock, so we need to copy the glyph from node into this strike, including
+                    // a deep copy of the mask.
+                    targetCache->mergeGlyphAndImage(glyph->getPackedID(), *fallback);
+                    return true;
+                }
 
-            // Look for any sub-pixel pos for this glyph, in case there is a pos mismatch.
-            if (const auto* fallback = node->fStrike.getCachedGlyphAnySubPix(glyphID)) {
-                targetCache->mergeGlyphAndImage(glyph->getPackedID(), *fallback);
-                return true;
+                // Look for any sub-pixel pos for this glyph, in case there is a pos mismatch.
+                if (const auto* fallback = node->fStrike.getCachedGlyphAnySubPix(glyphID)) {
+                    targetCache->mergeGlyphAndImage(glyph->getPackedID(), *fallback);
+                    return true;
+                }
             }
         }
     }
@@ -334,22 +357,24 @@ bool SkStrikeCache::desperationSearchForImage(const SkDescriptor& desc, SkGlyph*
 
 bool SkStrikeCache::desperationSearchForPath(
         const SkDescriptor& desc, SkGlyphID glyphID, SkPath* path) {
-    SkAutoSpinlock ac(fLock);
-
     // The following is wrong there is subpixel positioning with paths...
     // Paths are only ever at sub-pixel position (0,0), so we can just try that directly rather
     // than try our packed position first then search all others on failure like for masks.
     //
     // This will have to search the sub-pixel positions too.
     // There is also a problem with accounting for cache size with shared path data.
-    for (Node* node = fHead; node != nullptr; node = node->fNext) {
-        if (loose_compare(node->fStrike.getDescriptor(), desc)) {
-            if (SkGlyph *from = node->fStrike.glyphOrNull(SkPackedGlyphID{glyphID})) {
-                if (from->setPathHasBeenCalled() && from->path() != nullptr) {
-                    // We can just copy the path out by value here, so no need to worry
-                    // about the lifetime of this desperate-match node.
-                    *path = *from->path();
-                    return true;
+    for (Shard& shard : fShards) {
+        SkAutoSpinlock ac(shard.fLock);
+
+        for (Node* node = shard.fHead; node != nullptr; node = node->fNext) {
+            if (loose_compare(node->fStrike.getDescriptor(), desc)) {
+                if (SkGlyph *from = node->fStrike.glyphOrNull(SkPackedGlyphID{glyphID})) {
+                    if (from->setPathHasBeenCalled() && from->path() != nullptr) {
+                        // We can just copy the path out by value here, so no need to worry
+                        // about the lifetime of this desperate-match node.
+                        *path = *from->path();
+                        return true;
+                    }
                 }
             }
         }
@@ -383,23 +408,19 @@ auto SkStrikeCache::createStrike(
 }
 
 void SkStrikeCache::purgeAll() {
-    SkAutoSpinlock ac(fLock);
-    this->internalPurge(fTotalMemoryUsed);
+    this->purge(fTotalMemoryUsed.load());
 }
 
 size_t SkStrikeCache::getTotalMemoryUsed() const {
-    SkAutoSpinlock ac(fLock);
-    return fTotalMemoryUsed;
+    return fTotalMemoryUsed.load(std::memory_order_relaxed);
 }
 
 int SkStrikeCache::getCacheCountUsed() const {
-    SkAutoSpinlock ac(fLock);
-    return fCacheCount;
+    return fCacheCount.load(std::memory_order_relaxed);
 }
 
 int SkStrikeCache::getCacheCountLimit() const {
-    SkAutoSpinlock ac(fLock);
-    return fCacheCountLimit;
+    return fCacheCountLimit.load(std::memory_order_relaxed);
 }
 
 size_t SkStrikeCache::setCacheSizeLimit(size_t newLimit) {
@@ -408,17 +429,13 @@ size_t SkStrikeCache::setCacheSizeLimit(size_t newLimit) {
         newLimit = minLimit;
     }
 
-    SkAutoSpinlock ac(fLock);
-
-    size_t prevLimit = fCacheSizeLimit;
-    fCacheSizeLimit = newLimit;
-    this->internalPurge();
+    size_t prevLimit = fCacheSizeLimit.exchange(newLimit);
+    this->purge();
     return prevLimit;
 }
 
 size_t  SkStrikeCache::getCacheSizeLimit() const {
-    SkAutoSpinlock ac(fLock);
-    return fCacheSizeLimit;
+    return fCacheSizeLimit.load(std::memory_order_relaxed);
 }
 
 int SkStrikeCache::setCacheCountLimit(int newCount) {
@@ -426,17 +443,13 @@ int SkStrikeCache::setCacheCountLimit(int newCount) {
         newCount = 0;
     }
 
-    SkAutoSpinlock ac(fLock);
-
-    int prevCount = fCacheCountLimit;
-    fCacheCountLimit = newCount;
-    this->internalPurge();
+    int prevCount = fCacheCountLimit.exchange(newCount);
+    this->purge();
     return prevCount;
 }
 
 int SkStrikeCache::getCachePointSizeLimit() const {
-    SkAutoSpinlock ac(fLock);
-    return fPointSizeLimit;
+    return fPointSizeLimit.load(std::memory_order_relaxed);
 }
 
 int SkStrikeCache::setCachePointSizeLimit(int newLimit) {
@@ -444,111 +457,205 @@ int SkStrikeCache::setCachePointSizeLimit(int newLimit) {
         newLimit = 0;
     }
 
-    SkAutoSpinlock ac(fLock);
-
-    int prevLimit = fPointSizeLimit;
-    fPointSizeLimit = newLimit;
-    return prevLimit;
+    return fPointSizeLimit.exchange(newLimit);
 }
 
 void SkStrikeCache::forEachStrike(std::function<void(const SkStrike&)> visitor) const {
-    SkAutoSpinlock ac(fLock);
+    for (const Shard& shard : fShards) {
+        SkAutoSpinlock ac(shard.fLock);
 
-    this->validate();
+        this->validate(shard);
 
-    for (Node* node = fHead; node != nullptr; node = node->fNext) {
-        visitor(node->fStrike);
+        for (Node* node = shard.fHead; node != nullptr; node = node->fNext) {
+            visitor(node->fStrike);
+        }
     }
 }
 
-size_t SkStrikeCache::internalPurge(size_t minBytesNeeded) {
-    this->validate();
+bool SkStrikeCache::overBudget() const {
+    return fTotalMemoryUsed.load(std::memory_order_relaxed) > fCacheSizeLimit.load() ||
+           fCacheCount.load(std::memory_order_relaxed) > fCacheCountLimit.load();
+}
+
+size_t SkStrikeCache::purge(size_t minBytesNeeded) {
+    size_t  bytesFreed = 0;
+    int     countFreed = 0;
+    std::vector<Node*> purged;
+    {
+        // Only one thread purges at a time; the others find the budget already met.
+        SkAutoMutexExclusive purgeLock(fPurgeMutex);
+        this->detachPurgeable(minBytesNeeded, &bytesFreed, &countFreed, &purged);
+    }
+
+    // Saving strikes is slow, so the disk cache's thread writes them behind, and deletes them.
+    sk_sp<SkGlyphDiskCache> diskCache = purged.empty() ? nullptr : SkGlyphDiskCache::Get();
+    std::vector<Node*> unsaved;
+    for (Node* node : purged) {
+        if (diskCache && node->fStrike.hasUnsavedGlyphs()) {
+            unsaved.push_back(node);
+        } else {
+            delete node;
+        }
+    }
+    if (!unsaved.empty()) {
+        diskCache->runLater([diskCache = diskCache.get(), unsaved] {
+            bool saved = false;
+            for (Node* node : unsaved) {
+                saved |= diskCache->save(node->fStrike);
+                delete node;
+            }
+            // Purging the directory reads every file's header, so do it once for the batch.
+            if (saved) {
+                diskCache->purge();
+            }
+        });
+    }
+
+#ifdef SPEW_PURGE_STATUS
+    if (countFreed) {
+        SkDebugf("purging %dK from font cache [%d entries]\n",
+                 (int)(bytesFreed >> 10), countFreed);
+    }
+#endif
+
+    return bytesFreed;
+}
+
+void SkStrikeCache::detachPurgeable(size_t minBytesNeeded, size_t* bytesFreedPtr,
+                                    int* countFreedPtr, std::vector<Node*>* purged) {
+    for (Shard& shard : fShards) {
+        shard.fLock.acquire();
+        this->validate(shard);
+    }
+
+    const size_t totalMemoryUsed = fTotalMemoryUsed.load(),
+                 cacheSizeLimit  = fCacheSizeLimit.load();
+    const int    cacheCount      = fCacheCount.load(),
+                 cacheCountLimit = fCacheCountLimit.load();
 
     size_t bytesNeeded = 0;
-    if (fTotalMemoryUsed > fCacheSizeLimit) {
-        bytesNeeded = fTotalMemoryUsed - fCacheSizeLimit;
+    if (totalMemoryUsed > cacheSizeLimit) {
+        bytesNeeded = totalMemoryUsed - cacheSizeLimit;
     }
     bytesNeeded = SkTMax(bytesNeeded, minBytesNeeded);
     if (bytesNeeded) {
         // no small purges!
-        bytesNeeded = SkTMax(bytesNeeded, fTotalMemoryUsed >> 2);
+        bytesNeeded = SkTMax(bytesNeeded, totalMemoryUsed >> 2);
     }
 
     int countNeeded = 0;
-    if (fCacheCount > fCacheCountLimit) {
-        countNeeded = fCacheCount - fCacheCountLimit;
+    if (cacheCount > cacheCountLimit) {
+        countNeeded = cacheCount - cacheCountLimit;
         // no small purges!
-        countNeeded = SkMax32(countNeeded, fCacheCount >> 2);
-    }
-
-    // early exit
-    if (!countNeeded && !bytesNeeded) {
-        return 0;
+        countNeeded = SkMax32(countNeeded, cacheCount >> 2);
     }
 
     size_t  bytesFreed = 0;
     int     countFreed = 0;
 
-    // Start at the tail and proceed backwards deleting; the list is in LRU
-    // order, with unimportant entries at the tail.
-    Node* node = fTail;
-    while (node != nullptr && (bytesFreed < bytesNeeded || countFreed < countNeeded)) {
-        Node* prev = node->fPrev;
+    // Each shard's list is in LRU order, with unimportant entries at the tail. Walk all the
+    // tails backwards together, always deleting the least recently used strike next.
+    Node* cursors[kShardCount];
+    for (int i = 0; i < kShardCount; i++) {
+        cursors[i] = fShards[i].fTail;
+    }
+    while (bytesFreed < bytesNeeded || countFreed < countNeeded) {
+        int oldest = -1;
+        for (int i = 0; i < kShardCount; i++) {
+            if (cursors[i] && (oldest < 0 || cursors[i]->fLastUse < cursors[oldest]->fLastUse)) {
+                oldest = i;
+            }
+        }
+        if (oldest < 0) {
+            break;
+        }
+
+        Node* node = cursors[oldest];
+        cursors[oldest] = node->fPrev;
 
         // Only delete if the strike is not pinned.
         if (node->fPinner == nullptr || node->fPinner->canDelete()) {
             bytesFreed += node->fStrike.getMemoryUsed();
             countFreed += 1;
-            this->internalDetachCache(node);
-            delete node;
+            this->internalDetachCache(fShards[oldest], node);
+            purged->push_back(node);
         }
-        node = prev;
     }
 
-    this->validate();
-
-#ifdef SPEW_PURGE_STATUS
-    if (countFreed) {
-        SkDebugf("purging %dK from font cache [%d entries]\n",
-                 (int)(bytesFreed >> 10), countFreed);
+    for (Shard& shard : fShards) {
+        this->validate(shard);
+        shard.fLock.release();
     }
-#endif
-
-    return bytesFreed;
+    *bytesFreedPtr = bytesFreed;
+    *countFreedPtr = countFreed;
 }
 
-void SkStrikeCache::internalAttachToHead(Node* node) {
+void SkStrikeCache::internalAttachToHead(Shard& shard, Node* node) {
     SkASSERT(nullptr == node->fPrev && nullptr == node->fNext);
-    if (fHead) {
-        fHead->fPrev = node;
-        node->fNext = fHead;
+    if (shard.fHead) {
+        shard.fHead->fPrev = node;
+        node->fNext = shard.fHead;
     }
-    fHead = node;
+    shard.fHead = node;
 
-    if (fTail == nullptr) {
-        fTail = node;
+    if (shard.fTail == nullptr) {
+        shard.fTail = node;
     }
 
-    fCacheCount += 1;
-    fTotalMemoryUsed += node->fStrike.getMemoryUsed();
+    // The newest strike for a descriptor is the one found, as it would be by a search from
+    // the head of the list.
+    if (shard.fIndex.find(node->fStrike.getDescriptor())) {
+        shard.fUnindexedCount += 1;
+    }
+    shard.fIndex.set(node);
+    node->fLastUse = fUseCount.fetch_add(1, std::memory_order_relaxed);
+
+    const size_t memoryUsed = node->fStrike.getMemoryUsed();
+    shard.fCacheCount += 1;
+    shard.fMemoryUsed += memoryUsed;
+    fCacheCount.fetch_add(1, std::memory_order_relaxed);
+    fTotalMemoryUsed.fetch_add(memoryUsed, std::memory_order_relaxed);
 }
 
-void SkStrikeCache::internalDetachCache(Node* node) {
-    SkASSERT(fCacheCount > 0);
-    fCacheCount -= 1;
-    fTotalMemoryUsed -= node->fStrike.getMemoryUsed();
+void SkStrikeCache::internalDetachCache(Shard& shard, Node* node) {
+    const size_t memoryUsed = node->fStrike.getMemoryUsed();
+    SkASSERT(shard.fCacheCount > 0);
+    shard.fCacheCount -= 1;
+    shard.fMemoryUsed -= memoryUsed;
+    fCacheCount.fetch_sub(1, std::memory_order_relaxed);
+    fTotalMemoryUsed.fetch_sub(memoryUsed, std::memory_order_relaxed);
 
     if (node->fPrev) {
         node->fPrev->fNext = node->fNext;
     } else {
-        fHead = node->fNext;
+        shard.fHead = node->fNext;
     }
     if (node->fNext) {
         node->fNext->fPrev = node->fPrev;
     } else {
-        fTail = node->fPrev;
+        shard.fTail = node->fPrev;
     }
     node->fPrev = node->fNext = nullptr;
+
+    const SkDescriptor& desc = node->fStrike.getDescriptor();
+    Node** indexed = shard.fIndex.find(desc);
+    SkASSERT(indexed);
+    if (*indexed != node) {
+        SkASSERT(shard.fUnindexedCount > 0);
+        shard.fUnindexedCount -= 1;
+        return;
+    }
+    shard.fIndex.remove(desc);
+    if (shard.fUnindexedCount > 0) {
+        // Index the next newest strike for this descriptor, if there is one.
+        for (Node* other = shard.fHead; other != nullptr; other = other->fNext) {
+            if (other->fStrike.getDescriptor() == desc) {
+                shard.fIndex.set(other);
+                shard.fUnindexedCount -= 1;
+                break;
+            }
+        }
+    }
 }
 
 void SkStrikeCache::ValidateGlyphCacheDataSize() {
@@ -566,11 +673,11 @@ void SkStrikeCache::validateGlyphCacheDataSize() const {
 #endif
 
 #ifdef SK_DEBUG
-void SkStrikeCache::validate() const {
+void SkStrikeCache::validate(const Shard& shard) const {
     size_t computedBytes = 0;
     int computedCount = 0;
 
-    const Node* node = fHead;
+    const Node* node = shard.fHead;
     while (node != nullptr) {
         computedBytes += node->fStrike.getMemoryUsed();
         computedCount += 1;
@@ -578,13 +685,18 @@ void SkStrikeCache::validate() const {
     }
 
     // Can't use SkASSERTF because it looses thread annotations.
-    if (fCacheCount != computedCount) {
-        SkDebugf("fCacheCount: %d, computedCount: %d", fCacheCount, computedCount);
+    if (shard.fCacheCount != computedCount) {
+        SkDebugf("fCacheCount: %d, computedCount: %d", shard.fCacheCount, computedCount);
         SK_ABORT("fCacheCount != computedCount");
     }
-    if (fTotalMemoryUsed != computedBytes) {
-        SkDebugf("fTotalMemoryUsed: %d, computedBytes: %d", fTotalMemoryUsed, computedBytes);
-        SK_ABORT("fTotalMemoryUsed == computedBytes");
+    if (shard.fMemoryUsed != computedBytes) {
+        SkDebugf("fMemoryUsed: %d, computedBytes: %d", shard.fMemoryUsed, computedBytes);
+        SK_ABORT("fMemoryUsed == computedBytes");
+    }
+    if (shard.fIndex.count() + shard.fUnindexedCount != computedCount) {
+        SkDebugf("indexed: %d, unindexed: %d, computedCount: %d",
+                 shard.fIndex.count(), shard.fUnindexedCount, computedCount);
+        SK_ABORT("indexed + unindexed != computedCount");
     }
 }
 #endif
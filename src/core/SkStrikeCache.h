@@ -8,10 +8,14 @@
 #ifndef SkStrikeCache_DEFINED
 #define SkStrikeCache_DEFINED
 
+#include <atomic>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
+#include "include/private/SkMutex.h"
 #include "include/private/SkSpinlock.h"
+#include "include/private/SkTHash.h"
 #include "include/private/SkTemplates.h"
 #include "src/core/SkDescriptor.h"
 #include "src/core/SkStrike.h"
@@ -124,14 +128,41 @@ public:
 #endif
 
 private:
+    // Strikes are spread over shards by descriptor hash, so threads looking up different strikes
+    // rarely contend. Each shard keeps its own LRU list and an index from descriptor to strike;
+    // the totals used for budgeting are kept for the whole cache.
+    static constexpr int kShardCount = 16;
+
+    struct NodeTraits {
+        static const SkDescriptor& GetKey(const Node* node);
+        static uint32_t Hash(const SkDescriptor& desc) { return desc.getChecksum(); }
+    };
+
+    struct Shard {
+        mutable SkSpinlock fLock;
+        Node*              fHead SK_GUARDED_BY(fLock) {nullptr};
+        Node*              fTail SK_GUARDED_BY(fLock) {nullptr};
+        // Two threads may create strikes for the same descriptor; the most recently attached
+        // one is indexed, and fUnindexedCount counts the others still in the list.
+        SkTHashTable<Node*, SkDescriptor, NodeTraits> fIndex SK_GUARDED_BY(fLock);
+        int32_t            fUnindexedCount SK_GUARDED_BY(fLock) {0};
+        size_t             fMemoryUsed SK_GUARDED_BY(fLock) {0};
+        int32_t            fCacheCount SK_GUARDED_BY(fLock) {0};
+    };
+
 #ifdef SK_DEBUG
-    // A simple accounting of what each glyph cache reports and the strike cache total.
-    void validate() const SK_REQUIRES(fLock);
+    // A simple accounting of what each glyph cache reports and the shard total.
+    void validate(const Shard& shard) const SK_REQUIRES(shard.fLock);
 #else
-    void validate() const {}
+    void validate(const Shard&) const {}
 #endif
 
-    Node* findAndDetachStrike(const SkDescriptor&) SK_EXCLUDES(fLock);
+    Shard& shardFor(const SkDescriptor& desc) {
+        return fShards[desc.getChecksum() >> 28];
+    }
+    static_assert(kShardCount == 1 << 4, "shardFor() uses the top four bits of the checksum");
+
+    Node* findAndDetachStrike(const SkDescriptor&);
     Node* createStrike(
             const SkDescriptor& desc,
             std::unique_ptr<SkScalerContext> scaler,
@@ -140,28 +171,35 @@ private:
     Node* findOrCreateStrike(
             const SkDescriptor& desc,
             const SkScalerContextEffects& effects,
-            const SkTypeface& typeface) SK_EXCLUDES(fLock);
-    void attachNode(Node* node) SK_EXCLUDES(fLock);
+            const SkTypeface& typeface);
+    void attachNode(Node* node);
+
+    // The following methods can only be called when the shard's lock is already held.
+    void internalDetachCache(Shard& shard, Node*) SK_REQUIRES(shard.fLock);
+    void internalAttachToHead(Shard& shard, Node*) SK_REQUIRES(shard.fLock);
 
-    // The following methods can only be called when mutex is already held.
-    void internalDetachCache(Node*) SK_REQUIRES(fLock);
-    void internalAttachToHead(Node*) SK_REQUIRES(fLock);
+    bool overBudget() const;
 
     // Checkout budgets, modulated by the specified min-bytes-needed-to-purge,
-    // and attempt to purge caches to match.
-    // Returns number of bytes freed.
-    size_t internalPurge(size_t minBytesNeeded = 0) SK_REQUIRES(fLock);
+    // and attempt to purge caches to match. Locks every shard, so the least recently
+    // used strikes in the whole cache go first.
+    // Returns number of bytes freed. Strikes with glyphs to save are written to the disk cache,
+    // if any, behind the purge.
+    size_t purge(size_t minBytesNeeded = 0);
+    // Detaches the strikes purge() deletes. Called with fPurgeMutex held.
+    void detachPurgeable(size_t minBytesNeeded, size_t* bytesFreed, int* countFreed,
+                         std::vector<Node*>* purged) SK_NO_THREAD_SAFETY_ANALYSIS;
 
     void forEachStrike(std::function<void(const SkStrike&)> visitor) const;
 
-    mutable SkSpinlock fLock;
-    Node*              fHead SK_GUARDED_BY(fLock) {nullptr};
-    Node*              fTail SK_GUARDED_BY(fLock) {nullptr};
-    size_t             fCacheSizeLimit{SK_DEFAULT_FONT_CACHE_LIMIT};
-    size_t             fTotalMemoryUsed SK_GUARDED_BY(fLock) {0};
-    int32_t            fCacheCountLimit{SK_DEFAULT_FONT_CACHE_COUNT_LIMIT};
-    int32_t            fCacheCount SK_GUARDED_BY(fLock) {0};
-    int32_t            fPointSizeLimit{SK_DEFAULT_FONT_CACHE_POINT_SIZE_LIMIT};
+    Shard                 fShards[kShardCount];
+    SkMutex               fPurgeMutex;
+    std::atomic<uint64_t> fUseCount{0};
+    std::atomic<size_t>   fCacheSizeLimit{SK_DEFAULT_FONT_CACHE_LIMIT};
+    std::atomic<size_t>   fTotalMemoryUsed{0};
+    std::atomic<int32_t>  fCacheCountLimit{SK_DEFAULT_FONT_CACHE_COUNT_LIMIT};
+    std::atomic<int32_t>  fCacheCount{0};
+    std::atomic<int32_t>  fPointSizeLimit{SK_DEFAULT_FONT_CACHE_POINT_SIZE_LIMIT};
 };
 
 using SkExclusiveStrikePtr = SkStrikeCache::ExclusiveStrikePtr;
@@ -6,6 +6,7 @@
  */
 
 #include "include/private/SkMutex.h"
+#include "include/private/SkTDArray.h"
 #include "src/core/SkTypefaceCache.h"
 #include <atomic>
 
@@ -77,7 +78,47 @@ sk_sp<SkTypeface> SkTypefaceCache::FindByProcAndRef(FindProc proc, void* ctx) {
     return Get().findByProcAndRef(proc, ctx);
 }
 
+namespace {
+struct PurgeProcRec {
+    SkTypefaceCache::PurgeProc fProc;
+    void* fContext;
+};
+}  // namespace
+
+static SkMutex& purge_procs_mutex() {
+    static SkMutex& mutex = *(new SkMutex);
+    return mutex;
+}
+
+static SkTDArray<PurgeProcRec>& purge_procs() {
+    static SkTDArray<PurgeProcRec>& procs = *(new SkTDArray<PurgeProcRec>);
+    return procs;
+}
+
+void SkTypefaceCache::AddPurgeProc(PurgeProc proc, void* context) {
+    SkAutoMutexExclusive ama(purge_procs_mutex());
+    purge_procs().push_back({proc, context});
+}
+
+void SkTypefaceCache::RemovePurgeProc(PurgeProc proc, void* context) {
+    SkAutoMutexExclusive ama(purge_procs_mutex());
+    SkTDArray<PurgeProcRec>& procs = purge_procs();
+    for (int i = 0; i < procs.count(); ++i) {
+        if (procs[i].fProc == proc && procs[i].fContext == context) {
+            procs.remove(i);
+            return;
+        }
+    }
+}
+
 void SkTypefaceCache::PurgeAll() {
+    {
+        // Run these first, so typefaces they release can be purged below.
+        SkAutoMutexExclusive ama(purge_procs_mutex());
+        for (const PurgeProcRec& rec : purge_procs()) {
+            rec.fProc(rec.fContext);
+        }
+    }
     SkAutoMutexExclusive ama(typeface_cache_mutex());
     Get().purgeAll();
 }
@@ -58,6 +58,16 @@ public:
     static sk_sp<SkTypeface> FindByProcAndRef(FindProc proc, void* ctx);
     static void PurgeAll();
 
+    /**
+     *  Callback for AddPurgeProc. Called by PurgeAll(), e.g. so a font manager can drop the
+     *  typefaces it keeps for its own lookups.
+     */
+    typedef void(*PurgeProc)(void* context);
+
+    /** Registers proc to be called with context by PurgeAll(), until RemovePurgeProc. */
+    static void AddPurgeProc(PurgeProc proc, void* context);
+    static void RemovePurgeProc(PurgeProc proc, void* context);
+
     /**
      *  Debugging only: dumps the status of the typefaces in the cache
      */
@@ -5,7 +5,9 @@
  * found in the LICENSE file.
  */
 
+#include "include/core/SkPixmap.h"
 #include "include/private/SkM44.h"
+#include "src/core/SkOpts.h"
 #include "src/core/SkYUVMath.h"
 
 // in SkColorMatrix order (row-major)
@@ -224,3 +226,50 @@ void SkColorMatrix_DumpYUVMatrixTables() {
         dump(im, cs, false);
     }
 }
+
+// Returns the shift from a full resolution dimension to a chroma dimension, or -1.
+static int chroma_shift(int full, int chroma) {
+    if (chroma == full) {
+        return 0;
+    }
+    if (chroma == (full + 1) / 2) {
+        return 1;
+    }
+    return -1;
+}
+
+bool SkConvertYUV8PlanesToRGBA(const SkPixmap planes[3], SkYUVColorSpace cs,
+                               const SkPixmap& dst) {
+    const int width  = dst.width(),
+              height = dst.height();
+    if (planes[0].dimensions() != dst.dimensions() ||
+        planes[1].dimensions() != planes[2].dimensions()) {
+        return false;
+    }
+    if (dst.colorType() != kRGBA_8888_SkColorType && dst.colorType() != kBGRA_8888_SkColorType) {
+        return false;
+    }
+    for (int i = 0; i < 3; ++i) {
+        if (planes[i].info().bytesPerPixel() != 1 || !planes[i].addr()) {
+            return false;
+        }
+    }
+
+    const int hShift = chroma_shift(width,  planes[1].width()),
+              vShift = chroma_shift(height, planes[1].height());
+    if (hShift < 0 || vShift < 0) {
+        return false;
+    }
+
+    float m[20];
+    SkColorMatrix_YUV2RGB(cs, m);
+    for (int y = 0; y < height; ++y) {
+        uint32_t* row = dst.writable_addr32(0, y);
+        SkOpts::YUV_to_RGB1(row, planes[0].addr8(0, y), planes[1].addr8(0, y >> vShift),
+                            planes[2].addr8(0, y >> vShift), width, hShift, m);
+        if (dst.colorType() == kBGRA_8888_SkColorType) {
+            SkOpts::RGBA_to_BGRA(row, row, width);
+        }
+    }
+    return true;
+}
@@ -13,6 +13,12 @@
 void SkColorMatrix_RGB2YUV(SkYUVColorSpace, float m[20]);
 void SkColorMatrix_YUV2RGB(SkYUVColorSpace, float m[20]);
 
+class SkPixmap;
+
+// Converts 8-bit Y, U and V planes to opaque RGBA or BGRA 8888 pixels in dst, which must be the
+// size of the Y plane.  U and V may be subsampled by two in either direction.
+bool SkConvertYUV8PlanesToRGBA(const SkPixmap planes[3], SkYUVColorSpace, const SkPixmap& dst);
+
 // Used to create the pre-compiled tables in SkYUVMath.cpp
 void SkColorMatrix_DumpYUVMatrixTables();
 
@@ -474,15 +474,13 @@ void GrTextBlob::flush(GrTextTarget* target, const SkSurfaceProps& props,
                              || runPaint.getMaskFilter();
 
 
-            for (const auto& pathGlyph : subRun->fPaths) {
+            for (auto& pathGlyph : subRun->fPaths) {
                 SkMatrix ctm{drawMatrix};
                 ctm.preTranslate(drawOrigin.x(), drawOrigin.y());
                 SkMatrix pathMatrix = SkMatrix::MakeScale(
                         subRun->fStrikeSpec.strikeToSourceRatio());
                 pathMatrix.postTranslate(pathGlyph.fOrigin.x(), pathGlyph.fOrigin.y());
 
-                // TmpPath must be in the same scope as GrShape shape below.
-                SkTLazy<SkPath> tmpPath;
                 const SkPath* path = &pathGlyph.fPath;
                 if (!scalePath) {
                     // Scale can be applied to CTM -- no effects.
@@ -492,10 +490,12 @@ void GrTextBlob::flush(GrTextTarget* target, const SkSurfaceProps& props,
 
                     // Transform the path form the normalized outline to source space. This
                     // way the CTM will remain the same so it can be used by the effects.
-                    SkPath* sourceOutline = tmpPath.init();
-                    path->transform(pathMatrix, sourceOutline);
-                    sourceOutline->setIsVolatile(true);
-                    path = sourceOutline;
+                    // The source outline is the same for every draw of the blob, so it is made
+                    // once; as it keeps its generation ID, the tessellation of it is cached too.
+                    if (!pathGlyph.fSourcePath.isValid()) {
+                        path->transform(pathMatrix, pathGlyph.fSourcePath.init());
+                    }
+                    path = pathGlyph.fSourcePath.get();
                 }
 
                 // TODO: we are losing the mutability of the path here
@@ -18,6 +18,7 @@
 #include "src/core/SkStrikeCache.h"
 #include "src/core/SkStrikeSpec.h"
 #include "src/core/SkTInternalLList.h"
+#include "src/core/SkTLazy.h"
 #include "src/gpu/GrColor.h"
 #include "src/gpu/GrDrawOpAtlas.h"
 #include "src/gpu/text/GrStrikeCache.h"
@@ -90,6 +91,9 @@ public:
         PathGlyph(const SkPath& path, SkPoint origin);
         SkPath fPath;
         SkPoint fOrigin;
+        // fPath scaled and translated into source space, made by the first draw that needs it.
+        // Keeping it lets path renderers find the geometry they made for it on earlier draws.
+        SkTLazy<SkPath> fSourcePath;
     };
 
     SK_DECLARE_INTERNAL_LLIST_INTERFACE(GrTextBlob);
@@ -10,12 +10,15 @@
 #include "include/core/SkData.h"
 #include "include/core/SkPixelRef.h"
 #include "include/core/SkSurface.h"
+#include "include/core/SkYUVAIndex.h"
 #include "include/private/SkImageInfoPriv.h"
 #include "src/codec/SkColorTable.h"
 #include "src/core/SkCompressedDataUtils.h"
 #include "src/core/SkConvertPixels.h"
 #include "src/core/SkImagePriv.h"
+#include "src/core/SkOpts.h"
 #include "src/core/SkTLazy.h"
+#include "src/core/SkYUVMath.h"
 #include "src/image/SkImage_Base.h"
 #include "src/shaders/SkBitmapProcShader.h"
 
@@ -352,6 +355,75 @@ sk_sp<SkImage> SkMakeImageFromRasterBitmap(const SkBitmap& bm, SkCopyPixelsMode
     return SkMakeImageFromRasterBitmapPriv(bm, cpm, kNeedNewImageUniqueID);
 }
 
+sk_sp<SkImage> SkMakeRasterImageFromYUVAPixmaps(SkYUVColorSpace yuvColorSpace,
+                                                const SkPixmap yuvaPixmaps[],
+                                                const SkYUVAIndex yuvaIndices[4],
+                                                SkISize imageSize, GrSurfaceOrigin imageOrigin,
+                                                sk_sp<SkColorSpace> imageColorSpace) {
+    int numPixmaps;
+    if (!SkYUVAIndex::AreValidIndices(yuvaIndices, &numPixmaps)) {
+        return nullptr;
+    }
+    // Each channel must have a plane of its own.
+    const int alphaIndex = yuvaIndices[SkYUVAIndex::kA_Index].fIndex;
+    bool used[4] = { false, false, false, false };
+    for (int i = 0; i < 4; ++i) {
+        const int index = yuvaIndices[i].fIndex;
+        if (index >= 0) {
+            if (used[index]) {
+                return nullptr;
+            }
+            used[index] = true;
+        }
+    }
+    for (int i = 0; i < numPixmaps; ++i) {
+        if (yuvaPixmaps[i].info().bytesPerPixel() != 1 || !yuvaPixmaps[i].addr()) {
+            return nullptr;
+        }
+    }
+    const SkPixmap planes[3] = {
+        yuvaPixmaps[yuvaIndices[SkYUVAIndex::kY_Index].fIndex],
+        yuvaPixmaps[yuvaIndices[SkYUVAIndex::kU_Index].fIndex],
+        yuvaPixmaps[yuvaIndices[SkYUVAIndex::kV_Index].fIndex],
+    };
+    if (alphaIndex >= 0 && yuvaPixmaps[alphaIndex].dimensions() != imageSize) {
+        return nullptr;
+    }
+
+    const SkImageInfo info = SkImageInfo::MakeN32(
+            imageSize.width(), imageSize.height(),
+            alphaIndex >= 0 ? kPremul_SkAlphaType : kOpaque_SkAlphaType, imageColorSpace);
+    SkBitmap bitmap;
+    if (!bitmap.tryAllocPixels(info) ||
+        !SkConvertYUV8PlanesToRGBA(planes, yuvColorSpace, bitmap.pixmap())) {
+        return nullptr;
+    }
+
+    for (int y = 0; y < imageSize.height(); ++y) {
+        uint32_t* row = bitmap.getAddr32(0, y);
+        if (alphaIndex >= 0) {
+            // Alpha is the last byte in both RGBA and BGRA.
+            const uint8_t* alpha = yuvaPixmaps[alphaIndex].addr8(0, y);
+            for (int x = 0; x < imageSize.width(); ++x) {
+                reinterpret_cast<uint8_t*>(row + x)[3] = alpha[x];
+            }
+            SkOpts::RGBA_to_rgbA(row, row, imageSize.width());
+        }
+    }
+    if (kBottomLeft_GrSurfaceOrigin == imageOrigin) {
+        SkAutoTMalloc<uint32_t> temp(imageSize.width());
+        const size_t rowBytes = imageSize.width() * sizeof(uint32_t);
+        for (int top = 0, bottom = imageSize.height() - 1; top < bottom; ++top, --bottom) {
+            memcpy(temp.get(), bitmap.getAddr32(0, top), rowBytes);
+            memcpy(bitmap.getAddr32(0, top), bitmap.getAddr32(0, bottom), rowBytes);
+            memcpy(bitmap.getAddr32(0, bottom), temp.get(), rowBytes);
+        }
+    }
+
+    bitmap.setImmutable();
+    return SkImage::MakeFromBitmap(bitmap);
+}
+
 const SkPixelRef* SkBitmapImageGetPixelRef(const SkImage* image) {
     return ((const SkImage_Raster*)image)->getPixelRef();
 }
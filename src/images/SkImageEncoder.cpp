@@ -5,6 +5,7 @@
  * found in the LICENSE file.
  */
 
+#include "include/core/SkColorSpace.h"
 #include "include/encode/SkJpegEncoder.h"
 #include "include/encode/SkPngEncoder.h"
 #include "include/encode/SkWebpEncoder.h"
@@ -22,6 +23,9 @@ bool SkPngEncoder::Encode(SkWStream*, const SkPixmap&, const Options&) { return
 std::unique_ptr<SkEncoder> SkPngEncoder::Make(SkWStream*, const SkPixmap&, const Options&) {
     return nullptr;
 }
+std::unique_ptr<SkEncoder> SkPngEncoder::Make(SkWStream*, const SkImageInfo&, const Options&) {
+    return nullptr;
+}
 #endif
 
 #ifndef SK_HAS_WEBP_LIBRARY
@@ -81,6 +85,11 @@ bool SkEncoder::encodeRows(int numRows) {
         return false;
     }
 
+    // Encoders made from an SkImageInfo have no pixels until encodeRows(const SkPixmap&).
+    if (!fSrc.addr() && !fRows.addr()) {
+        return false;
+    }
+
     if (fCurrRow + numRows > fSrc.height()) {
         numRows = fSrc.height() - fCurrRow;
     }
@@ -94,6 +103,28 @@ bool SkEncoder::encodeRows(int numRows) {
     return true;
 }
 
+bool SkEncoder::encodeRows(const SkPixmap& rows) {
+    if (fSrc.addr() || !rows.addr() || rows.width() != fSrc.width() ||
+        rows.colorType() != fSrc.colorType() || rows.alphaType() != fSrc.alphaType() ||
+        !SkColorSpace::Equals(rows.colorSpace(), fSrc.colorSpace())) {
+        return false;
+    }
+
+    fRows = rows;
+    fRowsTop = fCurrRow;
+    bool success = this->encodeRows(rows.height());
+    fRows.reset();
+    return success;
+}
+
+const void* SkEncoder::srcRow(int y) const {
+    if (fRows.addr()) {
+        SkASSERT(y >= fRowsTop && y < fRowsTop + fRows.height());
+        return fRows.addr(0, y - fRowsTop);
+    }
+    return fSrc.addr(0, y);
+}
+
 sk_sp<SkData> SkEncodePixmap(const SkPixmap& src, SkEncodedImageFormat format, int quality) {
     SkDynamicMemoryWStream stream;
     return SkEncodeImage(&stream, src, format, quality) ? stream.detachAsData() : nullptr;
@@ -218,8 +218,8 @@ bool SkJpegEncoder::onEncodeRows(int numRows) {
     const size_t srcBytes = SkColorTypeBytesPerPixel(fSrc.colorType()) * fSrc.width();
     const size_t jpegSrcBytes = fEncoderMgr->cinfo()->input_components * fSrc.width();
 
-    const void* srcRow = fSrc.addr(0, fCurrRow);
     for (int i = 0; i < numRows; i++) {
+        const void* srcRow = this->srcRow(fCurrRow + i);
         JSAMPLE* jpegSrcRow = (JSAMPLE*) srcRow;
         if (fEncoderMgr->proc()) {
             sk_msan_assert_initialized(srcRow, SkTAddOffset<const void>(srcRow, srcBytes));
@@ -238,7 +238,6 @@ bool SkJpegEncoder::onEncodeRows(int numRows) {
         }
 
         jpeg_write_scanlines(fEncoderMgr->cinfo(), &jpegSrcRow, 1);
-        srcRow = SkTAddOffset<const void>(srcRow, fSrc.rowBytes());
     }
 
     fCurrRow += numRows;
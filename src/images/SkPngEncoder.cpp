@@ -15,11 +15,14 @@
 #include "include/private/SkImageInfoPriv.h"
 #include "src/codec/SkColorTable.h"
 #include "src/codec/SkPngPriv.h"
+#include "src/core/SkEndian.h"
 #include "src/core/SkMSAN.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/images/SkImageEncoderFns.h"
 #include <vector>
 
 #include "png.h"
+#include "zlib.h"
 
 static_assert(PNG_FILTER_NONE  == (int)SkPngEncoder::FilterFlag::kNone,  "Skia libpng filter err.");
 static_assert(PNG_FILTER_SUB   == (int)SkPngEncoder::FilterFlag::kSub,   "Skia libpng filter err.");
@@ -386,6 +389,20 @@ std::unique_ptr<SkEncoder> SkPngEncoder::Make(SkWStream* dst, const SkPixmap& sr
         return nullptr;
     }
 
+    return MakeEncoder(dst, src, options);
+}
+
+std::unique_ptr<SkEncoder> SkPngEncoder::Make(SkWStream* dst, const SkImageInfo& info,
+                                              const Options& options) {
+    if (!SkImageInfoIsValid(info)) {
+        return nullptr;
+    }
+
+    return MakeEncoder(dst, SkPixmap(info, nullptr, info.minRowBytes()), options);
+}
+
+std::unique_ptr<SkEncoder> SkPngEncoder::MakeEncoder(SkWStream* dst, const SkPixmap& src,
+                                                     const Options& options) {
     std::unique_ptr<SkPngEncoderMgr> encoderMgr = SkPngEncoderMgr::Make(dst);
     if (!encoderMgr) {
         return nullptr;
@@ -420,8 +437,8 @@ bool SkPngEncoder::onEncodeRows(int numRows) {
         return false;
     }
 
-    const void* srcRow = fSrc.addr(0, fCurrRow);
     for (int y = 0; y < numRows; y++) {
+        const void* srcRow = this->srcRow(fCurrRow + y);
         sk_msan_assert_initialized(srcRow,
                                    (const uint8_t*)srcRow + (fSrc.width() << fSrc.shiftPerPixel()));
         fEncoderMgr->proc()((char*)fStorage.get(),
@@ -431,7 +448,6 @@ bool SkPngEncoder::onEncodeRows(int numRows) {
 
         png_bytep rowPtr = (png_bytep) fStorage.get();
         png_write_rows(fEncoderMgr->pngPtr(), &rowPtr, 1);
-        srcRow = SkTAddOffset<const void>(srcRow, fSrc.rowBytes());
     }
 
     fCurrRow += numRows;
@@ -442,9 +458,272 @@ bool SkPngEncoder::onEncodeRows(int numRows) {
     return true;
 }
 
+// Parallel encoding, in the style of pigz.
+//
+// The image is split into strips of rows, which are filtered and deflated independently. Every
+// strip but the last ends with a sync flush, leaving its deflate output byte aligned so the next
+// strip's output can follow it directly. The strips are then joined with a zlib header and the
+// combined adler32 of the filtered rows, and written as IDAT chunks. Strips are sized in bytes
+// rather than by thread count, so the output is the same however many threads do the work.
+
+// Uncompressed bytes per strip. Each strip starts with an empty deflate window, so smaller strips
+// compress a little worse.
+static constexpr size_t kStripBytes = 1 << 20;
+static constexpr size_t kMaxIDATBytes = 1 << 16;
+
+static int paeth_predictor(int a, int b, int c) {
+    int p = a + b - c;
+    int pa = SkTAbs(p - a),
+        pb = SkTAbs(p - b),
+        pc = SkTAbs(p - c);
+    if (pa <= pb && pa <= pc) {
+        return a;
+    }
+    return pb <= pc ? b : c;
+}
+
+// Writes the filter type followed by row, filtered against prev, to dst.
+static void filter_row(int filter, const uint8_t* row, const uint8_t* prev, size_t rowBytes,
+                       size_t bpp, uint8_t* dst) {
+    *dst++ = SkToU8(filter);
+    switch (filter) {
+        case PNG_FILTER_VALUE_NONE:
+            memcpy(dst, row, rowBytes);
+            break;
+        case PNG_FILTER_VALUE_SUB:
+            for (size_t i = 0; i < rowBytes; i++) {
+                dst[i] = row[i] - (i < bpp ? 0 : row[i - bpp]);
+            }
+            break;
+        case PNG_FILTER_VALUE_UP:
+            for (size_t i = 0; i < rowBytes; i++) {
+                dst[i] = row[i] - prev[i];
+            }
+            break;
+        case PNG_FILTER_VALUE_AVG:
+            for (size_t i = 0; i < rowBytes; i++) {
+                dst[i] = row[i] - (((i < bpp ? 0 : row[i - bpp]) + prev[i]) >> 1);
+            }
+            break;
+        case PNG_FILTER_VALUE_PAETH:
+            for (size_t i = 0; i < rowBytes; i++) {
+                dst[i] = row[i] - (i < bpp ? prev[i]
+                                           : paeth_predictor(row[i - bpp], prev[i], prev[i - bpp]));
+            }
+            break;
+        default:
+            SkASSERT(false);
+    }
+}
+
+// The same heuristic libpng uses: the filtered row whose bytes, taken as signed, have the smallest
+// sum of absolute values is likely to compress best.
+static uint32_t filtered_row_cost(const uint8_t* filtered, size_t rowBytes) {
+    uint32_t sum = 0;
+    for (size_t i = 0; i < rowBytes; i++) {
+        sum += filtered[i] < 128 ? filtered[i] : 256 - filtered[i];
+    }
+    return sum;
+}
+
+static bool deflate_bytes(z_stream* zs, const void* data, size_t len, int flush,
+                          std::vector<uint8_t>* out) {
+    zs->next_in = (Bytef*)data;
+    zs->avail_in = SkToU32(len);
+    uint8_t buffer[16384];
+    do {
+        zs->next_out = buffer;
+        zs->avail_out = sizeof(buffer);
+        if (Z_STREAM_ERROR == deflate(zs, flush)) {
+            return false;
+        }
+        out->insert(out->end(), buffer, buffer + sizeof(buffer) - zs->avail_out);
+    } while (zs->avail_out == 0);
+    return true;
+}
+
+namespace {
+
+struct PngStrip {
+    std::vector<uint8_t> fDeflated;
+    uLong                fAdler = adler32(0, Z_NULL, 0);
+    size_t               fFilteredBytes = 0;
+    bool                 fSuccess = false;
+};
+
+struct PngStripEncoder {
+    const SkPixmap&         fSrc;
+    transform_scanline_proc fProc;
+    size_t                  fRowBytes;
+    size_t                  fBpp;
+    int                     fFilters;
+    int                     fZLibLevel;
+
+    void transformRow(int y, uint8_t* dst) const {
+        const void* srcRow = fSrc.addr(0, y);
+        sk_msan_assert_initialized(srcRow,
+                                   (const uint8_t*)srcRow + (fSrc.width() << fSrc.shiftPerPixel()));
+        fProc((char*)dst, (const char*)srcRow, fSrc.width(),
+              SkColorTypeBytesPerPixel(fSrc.colorType()));
+    }
+
+    void encode(int startY, int endY, PngStrip* strip) const {
+        z_stream zs;
+        memset(&zs, 0, sizeof(zs));
+        int strategy = fFilters == PNG_FILTER_NONE ? Z_DEFAULT_STRATEGY : Z_FILTERED;
+        if (Z_OK != deflateInit2(&zs, fZLibLevel, Z_DEFLATED, -MAX_WBITS, 8, strategy)) {
+            return;
+        }
+
+        // The first row of a strip is still filtered against the last row of the one above it.
+        std::vector<uint8_t> rows(2 * fRowBytes, 0);
+        uint8_t* prev = rows.data();
+        uint8_t* curr = prev + fRowBytes;
+        if (startY > 0) {
+            this->transformRow(startY - 1, prev);
+        }
+
+        std::vector<uint8_t> filtered(2 * (fRowBytes + 1));
+        uint8_t* best = filtered.data();
+        uint8_t* trial = best + fRowBytes + 1;
+
+        bool success = true;
+        for (int y = startY; success && y < endY; y++) {
+            this->transformRow(y, curr);
+
+            uint32_t bestCost = UINT32_MAX;
+            for (int filter = PNG_FILTER_VALUE_NONE; filter < PNG_FILTER_VALUE_LAST; filter++) {
+                if (!(fFilters & (PNG_FILTER_NONE << filter))) {
+                    continue;
+                }
+                filter_row(filter, curr, prev, fRowBytes, fBpp, trial);
+                if (SkIsPow2(fFilters)) {
+                    std::swap(best, trial);
+                    break;
+                }
+                uint32_t cost = filtered_row_cost(trial + 1, fRowBytes);
+                if (cost < bestCost) {
+                    bestCost = cost;
+                    std::swap(best, trial);
+                }
+            }
+
+            strip->fAdler = adler32(strip->fAdler, best, SkToU32(fRowBytes + 1));
+            strip->fFilteredBytes += fRowBytes + 1;
+            int flush = y + 1 < endY ? Z_NO_FLUSH
+                                     : endY == fSrc.height() ? Z_FINISH : Z_SYNC_FLUSH;
+            success = deflate_bytes(&zs, best, fRowBytes + 1, flush, &strip->fDeflated);
+            std::swap(prev, curr);
+        }
+
+        deflateEnd(&zs);
+        strip->fSuccess = success;
+    }
+};
+
+// Collects the zlib stream and writes it out in IDAT chunks of kMaxIDATBytes.
+class IDATWriter {
+public:
+    explicit IDATWriter(SkWStream* dst) : fDst(dst) {}
+
+    bool write(const uint8_t* data, size_t len) {
+        while (len > 0) {
+            size_t n = SkTMin(len, kMaxIDATBytes - fBuffer.size());
+            fBuffer.insert(fBuffer.end(), data, data + n);
+            data += n;
+            len -= n;
+            if (fBuffer.size() == kMaxIDATBytes && !this->flush()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool flush() {
+        bool success = fBuffer.empty() || WriteChunk(fDst, "IDAT", fBuffer.data(), fBuffer.size());
+        fBuffer.clear();
+        return success;
+    }
+
+    static bool WriteChunk(SkWStream* dst, const char type[4], const uint8_t* data, size_t len) {
+        uint32_t length = SkEndian_SwapBE32(SkToU32(len));
+        uLong crc = crc32(0, Z_NULL, 0);
+        crc = crc32(crc, (const Bytef*)type, 4);
+        if (len) {
+            crc = crc32(crc, data, SkToU32(len));
+        }
+        uint32_t crcBE = SkEndian_SwapBE32(SkToU32(crc));
+        return dst->write(&length, 4) && dst->write(type, 4) && (!len || dst->write(data, len)) &&
+               dst->write(&crcBE, 4);
+    }
+
+private:
+    SkWStream*           fDst;
+    std::vector<uint8_t> fBuffer;
+};
+
+}  // namespace
+
+static bool encode_strips(SkWStream* dst, const SkPixmap& src, SkPngEncoderMgr* encoderMgr,
+                          int rowsPerStrip, const SkPngEncoder::Options& options) {
+    int zlibLevel = SkTMin(SkTMax(0, options.fZLibLevel), 9);
+    int filters = (int)options.fFilterFlags & (int)SkPngEncoder::FilterFlag::kAll;
+    if (!filters) {
+        filters = PNG_FILTER_NONE;
+    }
+
+    size_t rowBytes = encoderMgr->pngBytesPerPixel() * src.width();
+    const PngStripEncoder stripEncoder{src, encoderMgr->proc(), rowBytes,
+                                       (size_t)encoderMgr->pngBytesPerPixel(), filters, zlibLevel};
+
+    int stripCount = (src.height() + rowsPerStrip - 1) / rowsPerStrip;
+    std::vector<PngStrip> strips(stripCount);
+    SkTaskGroup(*options.fExecutor).batch(stripCount, [&](int i) {
+        stripEncoder.encode(i * rowsPerStrip, SkTMin((i + 1) * rowsPerStrip, src.height()),
+                            &strips[i]);
+    });
+
+    // CMF says deflate with a 32K window, FLG records the level and makes the pair a multiple of
+    // 31.
+    uint8_t header[2] = { 0x78, 0 };
+    header[1] = (zlibLevel < 2 ? 0 : zlibLevel < 6 ? 1 : zlibLevel == 6 ? 2 : 3) << 6;
+    header[1] += 31 - ((header[0] << 8) | header[1]) % 31;
+
+    IDATWriter writer(dst);
+    if (!writer.write(header, sizeof(header))) {
+        return false;
+    }
+    uLong adler = adler32(0, Z_NULL, 0);
+    for (const PngStrip& strip : strips) {
+        if (!strip.fSuccess || !writer.write(strip.fDeflated.data(), strip.fDeflated.size())) {
+            return false;
+        }
+        adler = adler32_combine(adler, strip.fAdler, strip.fFilteredBytes);
+    }
+    uint32_t adlerBE = SkEndian_SwapBE32(SkToU32(adler));
+    return writer.write((const uint8_t*)&adlerBE, 4) && writer.flush() &&
+           IDATWriter::WriteChunk(dst, "IEND", nullptr, 0);
+}
+
 bool SkPngEncoder::Encode(SkWStream* dst, const SkPixmap& src, const Options& options) {
     auto encoder = SkPngEncoder::Make(dst, src, options);
-    return encoder.get() && encoder->encodeRows(src.height());
+    if (!encoder) {
+        return false;
+    }
+
+    if (options.fExecutor) {
+        // Rows libpng would need to transform further (e.g. to drop the filler from opaque F16)
+        // are always encoded serially, as are images too small to split.
+        SkPngEncoderMgr* encoderMgr = static_cast<SkPngEncoder*>(encoder.get())->fEncoderMgr.get();
+        size_t rowBytes = encoderMgr->pngBytesPerPixel() * src.width();
+        int rowsPerStrip = (int)SkTMax<size_t>(1, kStripBytes / (rowBytes + 1));
+        if (rowBytes == png_get_rowbytes(encoderMgr->pngPtr(), encoderMgr->infoPtr()) &&
+            src.height() > rowsPerStrip) {
+            return encode_strips(dst, src, encoderMgr, rowsPerStrip, options);
+        }
+    }
+
+    return encoder->encodeRows(src.height());
 }
 
 #endif
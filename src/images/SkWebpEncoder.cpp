@@ -138,8 +138,7 @@ bool SkWebpEncoder::Encode(SkWStream* stream, const SkPixmap& pixmap, const Opti
 
     // Set compression, method, and pixel format.
     // libwebp recommends using BGRA for lossless and YUV for lossy.
-    // The choices of |webp_config.method| currently just match Chrome's defaults.  We
-    // could potentially expose this decision to the client.
+    // The default choices of |webp_config.method| match Chrome's defaults.
     if (Compression::kLossy == opts.fCompression) {
         webp_config.lossless = 0;
 #ifndef SK_WEBP_ENCODER_USE_DEFAULT_METHOD
@@ -152,6 +151,15 @@ bool SkWebpEncoder::Encode(SkWStream* stream, const SkPixmap& pixmap, const Opti
         pic.use_argb = 1;
     }
 
+    switch (opts.fEffort) {
+        case Effort::kDefault:                           break;
+        case Effort::kFastest:  webp_config.method = 0; break;
+        case Effort::kFast:     webp_config.method = 2; break;
+        case Effort::kBalanced: webp_config.method = 4; break;
+        case Effort::kSmallest: webp_config.method = 6; break;
+    }
+    webp_config.thread_level = opts.fMultithreaded ? 1 : 0;
+
     // If there is no need to embed an ICC profile, we write directly to the input stream.
     // Otherwise, we will first encode to |tmp| and use a mux to add the ICC chunk.  libwebp
     // forces us to have an encoded image before we can add a profile.
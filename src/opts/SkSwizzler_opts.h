@@ -10,6 +10,8 @@
 
 #include "include/private/SkColorData.h"
 
+#include <algorithm>
+#include <cstring>
 #include <utility>
 
 #if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSSE3
@@ -158,6 +160,41 @@ static void inverted_CMYK_to_BGR1_portable(uint32_t* dst, const uint32_t* src, i
     }
 }
 
+// Keeps the first, most significant byte of each of |count| big-endian 16-bit components.
+static void strip16_portable(uint8_t dst[], const uint8_t* src, int count) {
+    for (int i = 0; i < count; i++) {
+        dst[i] = src[2*i];
+    }
+}
+
+static void index_to_8888_portable(uint32_t dst[], const uint8_t* src, int count,
+                                   const uint32_t ctable[]) {
+    for (int i = 0; i < count; i++) {
+        dst[i] = ctable[src[i]];
+    }
+}
+
+// U and V are shared by (1 << uvShift) horizontally adjacent pixels.  The matrix is in
+// SkColorMatrix order, operating on normalized values; alpha is always opaque.
+static void YUV_to_RGB1_portable(uint32_t dst[], const uint8_t* y, const uint8_t* u,
+                                 const uint8_t* v, int count, int uvShift, const float m[20]) {
+    auto to_byte = [](float f) {
+        return (uint32_t)(std::min(std::max(f, 0.0f), 255.0f) + 0.5f);
+    };
+    for (int i = 0; i < count; i++) {
+        float Y = y[i],
+              U = u[i >> uvShift],
+              V = v[i >> uvShift];
+        uint32_t r = to_byte(m[ 0]*Y + m[ 1]*U + m[ 2]*V + m[ 4]*255),
+                 g = to_byte(m[ 5]*Y + m[ 6]*U + m[ 7]*V + m[ 9]*255),
+                 b = to_byte(m[10]*Y + m[11]*U + m[12]*V + m[14]*255);
+        dst[i] = (uint32_t)0xFF << 24
+               | (uint32_t)b    << 16
+               | (uint32_t)g    <<  8
+               | (uint32_t)r    <<  0;
+    }
+}
+
 #if defined(SK_ARM_HAS_NEON)
 
 // Rounded divide by 255, (x + 127) / 255
@@ -477,6 +514,30 @@ static void inverted_cmyk_to(uint32_t* dst, const uint32_t* src, int count) {
     inverted_cmyk_to<kBGR1>(dst, src, count);
 }
 
+static void strip16(uint8_t dst[], const uint8_t* src, int count) {
+    while (count >= 16) {
+        // Load 16 components, deinterleaving their high and low bytes.
+        uint8x16x2_t bytes = vld2q_u8(src);
+        vst1q_u8(dst, bytes.val[0]);
+        src += 32;
+        dst += 16;
+        count -= 16;
+    }
+
+    strip16_portable(dst, src, count);
+}
+
+/*not static*/ inline void index_to_8888(uint32_t dst[], const uint8_t* src, int count,
+                                         const uint32_t ctable[]) {
+    index_to_8888_portable(dst, src, count, ctable);
+}
+
+/*not static*/ inline void YUV_to_RGB1(uint32_t dst[], const uint8_t* y, const uint8_t* u,
+                                       const uint8_t* v, int count, int uvShift,
+                                       const float m[20]) {
+    YUV_to_RGB1_portable(dst, y, u, v, count, uvShift, m);
+}
+
 #elif SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSSE3
 
 // Scale a byte by another.
@@ -774,6 +835,159 @@ static void inverted_cmyk_to(uint32_t* dst, const uint32_t* src, int count) {
     inverted_cmyk_to<kBGR1>(dst, src, count);
 }
 
+static void strip16(uint8_t dst[], const uint8_t* src, int count) {
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+    const __m256i lowBytes256 = _mm256_set1_epi16(0x00FF);
+    while (count >= 32) {
+        __m256i a = _mm256_loadu_si256((const __m256i*) (src +  0)),
+                b = _mm256_loadu_si256((const __m256i*) (src + 32));
+
+        // Little-endian loads put the byte we want in the low half of each 16-bit lane.
+        a = _mm256_and_si256(a, lowBytes256);
+        b = _mm256_and_si256(b, lowBytes256);
+
+        // Packing works within 128-bit halves, so reorder the 64-bit quarters afterwards.
+        __m256i bytes = _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0xD8);
+        _mm256_storeu_si256((__m256i*) dst, bytes);
+
+        src += 64;
+        dst += 32;
+        count -= 32;
+    }
+#endif
+
+    const __m128i lowBytes = _mm_set1_epi16(0x00FF);
+    while (count >= 16) {
+        __m128i a = _mm_loadu_si128((const __m128i*) (src +  0)),
+                b = _mm_loadu_si128((const __m128i*) (src + 16));
+        a = _mm_and_si128(a, lowBytes);
+        b = _mm_and_si128(b, lowBytes);
+        _mm_storeu_si128((__m128i*) dst, _mm_packus_epi16(a, b));
+
+        src += 32;
+        dst += 16;
+        count -= 16;
+    }
+
+    strip16_portable(dst, src, count);
+}
+
+/*not static*/ inline void index_to_8888(uint32_t dst[], const uint8_t* src, int count,
+                                         const uint32_t ctable[]) {
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+    while (count >= 8) {
+        // Load 8 indices and look up their colors.
+        __m256i indices = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*) src));
+        __m256i colors = _mm256_i32gather_epi32((const int*) ctable, indices, 4);
+        _mm256_storeu_si256((__m256i*) dst, colors);
+
+        src += 8;
+        dst += 8;
+        count -= 8;
+    }
+#endif
+
+    index_to_8888_portable(dst, src, count, ctable);
+}
+
+/*not static*/ inline void YUV_to_RGB1(uint32_t dst[], const uint8_t* y, const uint8_t* u,
+                                       const uint8_t* v, int count, int uvShift,
+                                       const float m[20]) {
+    // We convert four (or eight) pixels at a time in float, then pack R, G, B and A planes
+    // down to bytes with saturation and interlace them with a single shuffle.  Like
+    // YUV_to_RGB1_portable, we round by adding 0.5 and truncating; cvtps would round half to
+    // even.  Values below -0.5 truncate towards zero, but saturate to 0 all the same.
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+    {
+        auto load8 = [](const uint8_t* p) {
+            return _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*) p)));
+        };
+        // With uvShift, four chroma samples are each repeated for two adjacent pixels.
+        auto loadUV = [uvShift](const uint8_t* p) {
+            if (!uvShift) {
+                return _mm256_cvtepi32_ps(
+                        _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*) p)));
+            }
+            int32_t four;
+            memcpy(&four, p, 4);
+            __m256i uv = _mm256_cvtepu8_epi32(_mm_cvtsi32_si128(four));
+            uv = _mm256_permutevar8x32_epi32(uv, _mm256_setr_epi32(0,0,1,1,2,2,3,3));
+            return _mm256_cvtepi32_ps(uv);
+        };
+        auto row = [&](const float* r, __m256 Y, __m256 U, __m256 V) {
+            __m256 c = _mm256_add_ps(_mm256_mul_ps(Y, _mm256_set1_ps(r[0])),
+                                     _mm256_mul_ps(U, _mm256_set1_ps(r[1])));
+            c = _mm256_add_ps(c, _mm256_mul_ps(V, _mm256_set1_ps(r[2])));
+            c = _mm256_add_ps(c, _mm256_set1_ps(r[4] * 255));
+            return _mm256_cvttps_epi32(_mm256_add_ps(c, _mm256_set1_ps(0.5f)));
+        };
+        const __m256i interlace = _mm256_setr_epi8(0,4,8,12, 1,5,9,13, 2,6,10,14, 3,7,11,15,
+                                                   0,4,8,12, 1,5,9,13, 2,6,10,14, 3,7,11,15);
+        const __m256i alpha = _mm256_set1_epi32(0xFF);
+        while (count >= 8) {
+            __m256 Y = load8(y),
+                   U = loadUV(u),
+                   V = loadUV(v);
+            __m256i rg = _mm256_packs_epi32(row(m +  0, Y, U, V), row(m + 5, Y, U, V)),
+                    ba = _mm256_packs_epi32(row(m + 10, Y, U, V), alpha);
+            __m256i px = _mm256_shuffle_epi8(_mm256_packus_epi16(rg, ba), interlace);
+            _mm256_storeu_si256((__m256i*) dst, px);
+
+            y += 8;
+            u += 8 >> uvShift;
+            v += 8 >> uvShift;
+            dst += 8;
+            count -= 8;
+        }
+    }
+#endif
+    const __m128i zeros = _mm_setzero_si128();
+    auto widen = [&](int32_t bytes) {
+        __m128i x = _mm_unpacklo_epi8(_mm_cvtsi32_si128(bytes), zeros);
+        return _mm_unpacklo_epi16(x, zeros);
+    };
+    auto load4 = [&](const uint8_t* p) {
+        int32_t four;
+        memcpy(&four, p, 4);
+        return _mm_cvtepi32_ps(widen(four));
+    };
+    auto loadUV = [&](const uint8_t* p) {
+        if (!uvShift) {
+            return load4(p);
+        }
+        uint16_t two;
+        memcpy(&two, p, 2);
+        __m128i uv = widen(two);
+        return _mm_cvtepi32_ps(_mm_unpacklo_epi32(uv, uv));
+    };
+    auto row = [&](const float* r, __m128 Y, __m128 U, __m128 V) {
+        __m128 c = _mm_add_ps(_mm_mul_ps(Y, _mm_set1_ps(r[0])),
+                              _mm_mul_ps(U, _mm_set1_ps(r[1])));
+        c = _mm_add_ps(c, _mm_mul_ps(V, _mm_set1_ps(r[2])));
+        c = _mm_add_ps(c, _mm_set1_ps(r[4] * 255));
+        return _mm_cvttps_epi32(_mm_add_ps(c, _mm_set1_ps(0.5f)));
+    };
+    const __m128i interlace = _mm_setr_epi8(0,4,8,12, 1,5,9,13, 2,6,10,14, 3,7,11,15);
+    const __m128i alpha = _mm_set1_epi32(0xFF);
+    while (count >= 4) {
+        __m128 Y = load4(y),
+               U = loadUV(u),
+               V = loadUV(v);
+        __m128i rg = _mm_packs_epi32(row(m +  0, Y, U, V), row(m + 5, Y, U, V)),
+                ba = _mm_packs_epi32(row(m + 10, Y, U, V), alpha);
+        __m128i px = _mm_shuffle_epi8(_mm_packus_epi16(rg, ba), interlace);
+        _mm_storeu_si128((__m128i*) dst, px);
+
+        y += 4;
+        u += 4 >> uvShift;
+        v += 4 >> uvShift;
+        dst += 4;
+        count -= 4;
+    }
+
+    YUV_to_RGB1_portable(dst, y, u, v, count, uvShift, m);
+}
+
 #else
 
 /*not static*/ inline void RGBA_to_rgbA(uint32_t* dst, const uint32_t* src, int count) {
@@ -816,8 +1030,67 @@ static void inverted_cmyk_to(uint32_t* dst, const uint32_t* src, int count) {
     inverted_CMYK_to_BGR1_portable(dst, src, count);
 }
 
+static void strip16(uint8_t dst[], const uint8_t* src, int count) {
+    strip16_portable(dst, src, count);
+}
+
+/*not static*/ inline void index_to_8888(uint32_t dst[], const uint8_t* src, int count,
+                                         const uint32_t ctable[]) {
+    index_to_8888_portable(dst, src, count, ctable);
+}
+
+/*not static*/ inline void YUV_to_RGB1(uint32_t dst[], const uint8_t* y, const uint8_t* u,
+                                       const uint8_t* v, int count, int uvShift,
+                                       const float m[20]) {
+    YUV_to_RGB1_portable(dst, y, u, v, count, uvShift, m);
+}
+
 #endif
 
+// 16-bit components are reduced to 8 bits with strip16(), and then swizzled like 8-bit pixels.
+// The 8888 swizzles all work in place.
+
+template <bool kSwapRB>
+static void RGB16_to_8888(uint32_t dst[], const uint8_t* src, int count) {
+    uint8_t rgb[3 * 64];
+    while (count > 0) {
+        int n = std::min(count, 64);
+        strip16(rgb, src, 3*n);
+        auto proc = kSwapRB ? RGB_to_BGR1 : RGB_to_RGB1;
+        proc(dst, rgb, n);
+        src += 6*n;
+        dst += n;
+        count -= n;
+    }
+}
+
+/*not static*/ inline void RGB16_to_RGB1(uint32_t dst[], const uint8_t* src, int count) {
+    RGB16_to_8888<false>(dst, src, count);
+}
+
+/*not static*/ inline void RGB16_to_BGR1(uint32_t dst[], const uint8_t* src, int count) {
+    RGB16_to_8888<true>(dst, src, count);
+}
+
+/*not static*/ inline void RGBA16_to_RGBA(uint32_t dst[], const uint8_t* src, int count) {
+    strip16((uint8_t*) dst, src, 4*count);
+}
+
+/*not static*/ inline void RGBA16_to_BGRA(uint32_t dst[], const uint8_t* src, int count) {
+    strip16((uint8_t*) dst, src, 4*count);
+    RGBA_to_BGRA(dst, dst, count);
+}
+
+/*not static*/ inline void RGBA16_to_rgbA(uint32_t dst[], const uint8_t* src, int count) {
+    strip16((uint8_t*) dst, src, 4*count);
+    RGBA_to_rgbA(dst, dst, count);
+}
+
+/*not static*/ inline void RGBA16_to_bgrA(uint32_t dst[], const uint8_t* src, int count) {
+    strip16((uint8_t*) dst, src, 4*count);
+    RGBA_to_bgrA(dst, dst, count);
+}
+
 }
 
 #endif // SkSwizzler_opts_DEFINED
@@ -21,6 +21,7 @@
 #include "src/core/SkDescriptor.h"
 #include "src/core/SkFDot6.h"
 #include "src/core/SkFontDescriptor.h"
+#include "src/core/SkFontStream.h"
 #include "src/core/SkGlyph.h"
 #include "src/core/SkMask.h"
 #include "src/core/SkMaskGamma.h"
@@ -254,6 +255,10 @@ private:
 
 struct SkFaceRec;
 
+// f_t_mutex() guards the FT_Library, the list of faces, and opening and closing faces.
+// Each SkFaceRec has its own mutex guarding everything else done with its FT_Face, so glyphs
+// from different faces can be generated concurrently. Since FreeType 2.6 this is all that is
+// needed to share one FT_Library between threads. When both are needed, lock f_t_mutex() first.
 static SkMutex& f_t_mutex() {
     static SkMutex& mutex = *(new SkMutex);
     return mutex;
@@ -297,6 +302,8 @@ static void unref_ft_library() {
 struct SkFaceRec {
     SkFaceRec* fNext;
     std::unique_ptr<FT_FaceRec, SkFunctionWrapper<decltype(FT_Done_Face), FT_Done_Face>> fFace;
+    // Must be held to use fFace (or its sizes) once the face is in the list.
+    SkMutex fMutex;
     FT_StreamRec fFTStream;
     std::unique_ptr<SkStreamAsset> fSkStream;
     uint32_t fRefCnt;
@@ -482,17 +489,25 @@ extern /*static*/ void unref_ft_face(SkFaceRec* faceRec) {
 class AutoFTAccess {
 public:
     AutoFTAccess(const SkTypeface* tf) : fFaceRec(nullptr) {
-        f_t_mutex().acquire();
-        SkASSERT_RELEASE(ref_ft_library());
-        fFaceRec = ref_ft_face(tf);
+        {
+            SkAutoMutexExclusive ac(f_t_mutex());
+            SkASSERT_RELEASE(ref_ft_library());
+            fFaceRec = ref_ft_face(tf);
+        }
+        if (fFaceRec) {
+            fFaceRec->fMutex.acquire();
+        }
     }
 
     ~AutoFTAccess() {
+        if (fFaceRec) {
+            fFaceRec->fMutex.release();
+        }
+        SkAutoMutexExclusive ac(f_t_mutex());
         if (fFaceRec) {
             unref_ft_face(fFaceRec);
         }
         unref_ft_library();
-        f_t_mutex().release();
     }
 
     FT_Face face() { return fFaceRec ? fFaceRec->fFace.get() : nullptr; }
@@ -501,6 +516,7 @@ public:
     bool isNamedVariationSpecified() {
         return fFaceRec ? fFaceRec->fNamedVariationSpecified : false;
     }
+    SkStreamAsset* stream() { return fFaceRec ? fFaceRec->fSkStream.get() : nullptr; }
 
 private:
     SkFaceRec* fFaceRec;
@@ -553,9 +569,9 @@ private:
     void getBBoxForCurrentGlyph(const SkGlyph* glyph, FT_BBox* bbox,
                                 bool snapToPixelBoundary = false);
     bool getCBoxForLetter(char letter, FT_BBox* bbox);
-    // Caller must lock f_t_mutex() before calling this function.
+    // Caller must lock fFaceRec->fMutex before calling this function.
     void updateGlyphIfLCD(SkGlyph* glyph);
-    // Caller must lock f_t_mutex() before calling this function.
+    // Caller must lock fFaceRec->fMutex before calling this function.
     // update FreeType2 glyph slot with glyph emboldened
     void emboldenIfNeeded(FT_Face face, FT_GlyphSlot glyph, SkGlyphID gid);
     bool shouldSubpixelBitmap(const SkGlyph&, const SkMatrix&);
@@ -848,10 +864,11 @@ SkScalerContext_FreeType::SkScalerContext_FreeType(sk_sp<SkTypeface> typeface,
     , fFTSize(nullptr)
     , fStrikeIndex(-1)
 {
-    SkAutoMutexExclusive  ac(f_t_mutex());
-    SkASSERT_RELEASE(ref_ft_library());
-
-    fFaceRec.reset(ref_ft_face(this->getTypeface()));
+    {
+        SkAutoMutexExclusive  ac(f_t_mutex());
+        SkASSERT_RELEASE(ref_ft_library());
+        fFaceRec.reset(ref_ft_face(this->getTypeface()));
+    }
 
     // load the font file
     if (nullptr == fFaceRec) {
@@ -859,6 +876,8 @@ SkScalerContext_FreeType::SkScalerContext_FreeType(sk_sp<SkTypeface> typeface,
         return;
     }
 
+    SkAutoMutexExclusive  ac(fFaceRec->fMutex);
+
     fLCDIsVert = SkToBool(fRec.fFlags & SkScalerContext::kLCD_Vertical_Flag);
 
     // compute the flags we send to Load_Glyph
@@ -1026,12 +1045,12 @@ SkScalerContext_FreeType::SkScalerContext_FreeType(sk_sp<SkTypeface> typeface,
 }
 
 SkScalerContext_FreeType::~SkScalerContext_FreeType() {
-    SkAutoMutexExclusive  ac(f_t_mutex());
-
     if (fFTSize != nullptr) {
+        SkAutoMutexExclusive  ac(fFaceRec->fMutex);
         FT_Done_Size(fFTSize);
     }
 
+    SkAutoMutexExclusive  ac(f_t_mutex());
     fFaceRec = nullptr;
 
     unref_ft_library();
@@ -1041,7 +1060,7 @@ SkScalerContext_FreeType::~SkScalerContext_FreeType() {
     this face with other context (at different sizes).
 */
 FT_Error SkScalerContext_FreeType::setupSize() {
-    f_t_mutex().assertHeld();
+    fFaceRec->fMutex.assertHeld();
     FT_Error err = FT_Activate_Size(fFTSize);
     if (err != 0) {
         return err;
@@ -1062,7 +1081,7 @@ bool SkScalerContext_FreeType::generateAdvance(SkGlyph* glyph) {
         return false;
     }
 
-    SkAutoMutexExclusive  ac(f_t_mutex());
+    SkAutoMutexExclusive  ac(fFaceRec->fMutex);
 
     if (this->setupSize()) {
         glyph->zeroMetrics();
@@ -1167,7 +1186,7 @@ bool SkScalerContext_FreeType::shouldSubpixelBitmap(const SkGlyph& glyph, const
 }
 
 void SkScalerContext_FreeType::generateMetrics(SkGlyph* glyph) {
-    SkAutoMutexExclusive  ac(f_t_mutex());
+    SkAutoMutexExclusive  ac(fFaceRec->fMutex);
 
     glyph->fMaskFormat = fRec.fMaskFormat;
 
@@ -1319,7 +1338,7 @@ void SkScalerContext_FreeType::generateMetrics(SkGlyph* glyph) {
 }
 
 void SkScalerContext_FreeType::generateImage(const SkGlyph& glyph) {
-    SkAutoMutexExclusive  ac(f_t_mutex());
+    SkAutoMutexExclusive  ac(fFaceRec->fMutex);
 
     if (this->setupSize()) {
         sk_bzero(glyph.fImage, glyph.imageSize());
@@ -1352,7 +1371,7 @@ void SkScalerContext_FreeType::generateImage(const SkGlyph& glyph) {
 bool SkScalerContext_FreeType::generatePath(SkGlyphID glyphID, SkPath* path) {
     SkASSERT(path);
 
-    SkAutoMutexExclusive  ac(f_t_mutex());
+    SkAutoMutexExclusive  ac(fFaceRec->fMutex);
 
     // FT_IS_SCALABLE is documented to mean the face contains outline glyphs.
     if (!FT_IS_SCALABLE(fFace) || this->setupSize()) {
@@ -1393,7 +1412,7 @@ void SkScalerContext_FreeType::generateFontMetrics(SkFontMetrics* metrics) {
         return;
     }
 
-    SkAutoMutexExclusive ac(f_t_mutex());
+    SkAutoMutexExclusive ac(fFaceRec->fMutex);
 
     if (this->setupSize()) {
         sk_bzero(metrics, sizeof(*metrics));
@@ -1578,14 +1597,7 @@ void SkTypeface_FreeType::onCharsToGlyphs(const SkUnichar uni[], int count,
 
     SkAutoMutexExclusive ama(fC2GCacheMutex);
 
-    int i;
-    for (i = 0; i < count; ++i) {
-        int index = fC2GCache.findGlyphIndex(uni[i]);
-        if (index < 0) {
-            break;
-        }
-        glyphs[i] = SkToU16(index);
-    }
+    int i = fC2GCache.findGlyphs(uni, count, glyphs);
     if (i == count) {
         // we're done, no need to access the freetype objects
         return;
@@ -1777,6 +1789,24 @@ size_t SkTypeface_FreeType::onGetTableData(SkFontTableTag tag, size_t offset,
 sk_sp<SkData> SkTypeface_FreeType::onCopyTableData(SkFontTableTag tag) const {
     AutoFTAccess fta(this);
     FT_Face face = fta.face();
+    if (!face) {
+        return nullptr;
+    }
+
+    // When the font is in memory, as it is when its file is mapped, share the table with it.
+    if (SkStreamAsset* stream = fta.stream()) {
+        std::unique_ptr<SkStreamAsset> owner = stream->getMemoryBase() ? stream->duplicate()
+                                                                       : nullptr;
+        const void* base = owner ? owner->getMemoryBase() : nullptr;
+        size_t offset, length;
+        if (base && SkFontStream::FindTable(base, owner->getLength(), face->face_index & 0xFFFF,
+                                            tag, &offset, &length)) {
+            return SkData::MakeWithProc(static_cast<const char*>(base) + offset, length,
+                                        [](const void*, void* ctx) {
+                                            delete static_cast<SkStreamAsset*>(ctx);
+                                        }, owner.release());
+        }
+    }
 
     FT_ULong tableLength = 0;
     FT_Error error;
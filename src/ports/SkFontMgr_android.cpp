@@ -20,6 +20,7 @@
 #include "include/private/SkTDArray.h"
 #include "include/private/SkTemplates.h"
 #include "src/core/SkFontDescriptor.h"
+#include "src/core/SkFontFileCache.h"
 #include "src/core/SkOSFile.h"
 #include "src/core/SkTSearch.h"
 #include "src/core/SkTypefaceCache.h"
@@ -79,7 +80,7 @@ public:
             sk_sp<SkData> data(SkData::MakeFromFILE(fFile));
             return data ? std::make_unique<SkMemoryStream>(std::move(data)) : nullptr;
         }
-        return SkStream::MakeFromFile(fPathName.c_str());
+        return SkFontFileCache::MakeStream(fPathName.c_str());
     }
 
     virtual void onGetFontDescriptor(SkFontDescriptor* desc, bool* serialize) const override {
@@ -450,7 +451,7 @@ protected:
     }
 
     sk_sp<SkTypeface> onMakeFromFile(const char path[], int ttcIndex) const override {
-        std::unique_ptr<SkStreamAsset> stream = SkStream::MakeFromFile(path);
+        std::unique_ptr<SkStreamAsset> stream = SkFontFileCache::MakeStream(path);
         return stream.get() ? this->makeFromStream(std::move(stream), ttcIndex) : nullptr;
     }
 
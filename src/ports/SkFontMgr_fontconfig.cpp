@@ -17,10 +17,13 @@
 #include "include/private/SkFixed.h"
 #include "include/private/SkMutex.h"
 #include "include/private/SkTDArray.h"
+#include "include/private/SkTHash.h"
 #include "include/private/SkTemplates.h"
 #include "src/core/SkAdvancedTypefaceMetrics.h"
 #include "src/core/SkFontDescriptor.h"
+#include "src/core/SkFontFileCache.h"
 #include "src/core/SkOSFile.h"
+#include "src/core/SkSharedMutex.h"
 #include "src/core/SkTypefaceCache.h"
 #include "src/ports/SkFontHost_FreeType_common.h"
 
@@ -498,7 +501,7 @@ public:
                 filename = resolvedFilename.c_str();
             }
         }
-        return SkStream::MakeFromFile(filename);
+        return SkFontFileCache::MakeStream(filename);
     }
 
     void onFilterRec(SkScalerContextRec* rec) const override {
@@ -715,14 +718,76 @@ class SkFontMgr_fontconfig : public SkFontMgr {
         return face;
     }
 
+    /** Remembers the results of onMatchFamilyStyle and onMatchFamilyStyleCharacter, so repeated
+     *  fallback lookups do not queue up behind fontconfig. Character matches are kept for each
+     *  character, since fontconfig may prefer a different font for each.
+     */
+    static constexpr int kMaxMatchCacheCount = 4096;
+
+    mutable SkSharedMutex fMatchCacheMutex;
+    // Family and style matches, and character matches, including misses.
+    mutable SkTHashMap<SkString, sk_sp<SkTypeface>> fMatchCache;
+
+    /** Returns true and sets typeface if key is cached. */
+    bool findMatch(const SkString& key, sk_sp<SkTypeface>* typeface) const {
+        SkAutoSharedMutexShared shared(fMatchCacheMutex);
+        const sk_sp<SkTypeface>* cached = fMatchCache.find(key);
+        if (!cached) {
+            return false;
+        }
+        *typeface = *cached;
+        return true;
+    }
+
+    void addMatch(SkString key, sk_sp<SkTypeface> typeface) const {
+        SkAutoSharedMutexExclusive exclusive(fMatchCacheMutex);
+        if (fMatchCache.count() >= kMaxMatchCacheCount) {
+            fMatchCache.reset();
+        }
+        fMatchCache.set(std::move(key), std::move(typeface));
+    }
+
+    /** Called by SkGraphics::PurgeFontCache(). Also drops results for fonts added to fFC. */
+    static void PurgeMatchCache(void* context) {
+        const SkFontMgr_fontconfig* self = static_cast<const SkFontMgr_fontconfig*>(context);
+        SkTHashMap<SkString, sk_sp<SkTypeface>> matches;
+        {
+            SkAutoSharedMutexExclusive exclusive(self->fMatchCacheMutex);
+            std::swap(matches, self->fMatchCache);
+        }
+        // The typefaces are released here, without holding fMatchCacheMutex.
+    }
+
+    static SkString MakeMatchKey(char kind, const char familyName[], const SkFontStyle& style,
+                                 const char* bcp47[], int bcp47Count, SkUnichar character) {
+        SkString key;
+        key.appendf("%c%d,%d,%d,%d;", kind, style.weight(), style.width(), style.slant(),
+                    character);
+        // Length prefixed so that no two requests have the same key.
+        if (familyName) {
+            key.appendf("%zu:%s", strlen(familyName), familyName);
+        } else {
+            key.append("-");
+        }
+        for (int i = 0; i < bcp47Count; ++i) {
+            key.appendf("%zu:%s", strlen(bcp47[i]), bcp47[i]);
+        }
+        return key;
+    }
+
 public:
     /** Takes control of the reference to 'config'. */
     explicit SkFontMgr_fontconfig(FcConfig* config)
         : fFC(config ? config : FcInitLoadConfigAndFonts())
         , fSysroot(reinterpret_cast<const char*>(FcConfigGetSysRoot(fFC)))
-        , fFamilyNames(GetFamilyNames(fFC)) { }
+        , fFamilyNames(GetFamilyNames(fFC))
+    {
+        SkTypefaceCache::AddPurgeProc(PurgeMatchCache, this);
+    }
 
     ~SkFontMgr_fontconfig() override {
+        SkTypefaceCache::RemovePurgeProc(PurgeMatchCache, this);
+
         // Hold the lock while unrefing the config.
         FCLocker lock;
         fFC.reset();
@@ -871,6 +936,32 @@ protected:
     SkTypeface* onMatchFamilyStyle(const char familyName[],
                                    const SkFontStyle& style) const override
     {
+        SkString key = MakeMatchKey('s', familyName, style, nullptr, 0, 0);
+        sk_sp<SkTypeface> typeface;
+        if (!this->findMatch(key, &typeface)) {
+            typeface = this->fcMatchFamilyStyle(familyName, style);
+            this->addMatch(std::move(key), typeface);
+        }
+        return typeface.release();
+    }
+
+    SkTypeface* onMatchFamilyStyleCharacter(const char familyName[],
+                                            const SkFontStyle& style,
+                                            const char* bcp47[],
+                                            int bcp47Count,
+                                            SkUnichar character) const override
+    {
+        SkString key = MakeMatchKey('c', familyName, style, bcp47, bcp47Count, character);
+        sk_sp<SkTypeface> typeface;
+        if (!this->findMatch(key, &typeface)) {
+            typeface = this->fcMatchFamilyStyleCharacter(familyName, style, bcp47, bcp47Count,
+                                                         character);
+            this->addMatch(std::move(key), typeface);
+        }
+        return typeface.release();
+    }
+
+    sk_sp<SkTypeface> fcMatchFamilyStyle(const char familyName[], const SkFontStyle& style) const {
         FCLocker lock;
 
         SkAutoFcPattern pattern;
@@ -903,15 +994,14 @@ protected:
             return nullptr;
         }
 
-        return createTypefaceFromFcPattern(font).release();
+        return createTypefaceFromFcPattern(font);
     }
 
-    SkTypeface* onMatchFamilyStyleCharacter(const char familyName[],
-                                            const SkFontStyle& style,
-                                            const char* bcp47[],
-                                            int bcp47Count,
-                                            SkUnichar character) const override
-    {
+    sk_sp<SkTypeface> fcMatchFamilyStyleCharacter(const char familyName[],
+                                                  const SkFontStyle& style,
+                                                  const char* bcp47[],
+                                                  int bcp47Count,
+                                                  SkUnichar character) const {
         FCLocker lock;
 
         SkAutoFcPattern pattern;
@@ -945,7 +1035,7 @@ protected:
             return nullptr;
         }
 
-        return createTypefaceFromFcPattern(font).release();
+        return createTypefaceFromFcPattern(font);
     }
 
     SkTypeface* onMatchFaceStyle(const SkTypeface* typeface,
@@ -1004,7 +1094,7 @@ protected:
     }
 
     sk_sp<SkTypeface> onMakeFromFile(const char path[], int ttcIndex) const override {
-        return this->makeFromStream(SkStream::MakeFromFile(path), ttcIndex);
+        return this->makeFromStream(SkFontFileCache::MakeStream(path), ttcIndex);
     }
 
     sk_sp<SkTypeface> onMakeFromFontData(std::unique_ptr<SkFontData> fontData) const override {
@@ -96,6 +96,22 @@ void* sk_fdmmap(int fd, size_t* size) {
     return addr;
 }
 
+bool sk_fstamp(FILE* f, SkFileStamp* stamp) {
+    struct stat status;
+    if (0 != fstat(fileno(f), &status)) {
+        return false;
+    }
+#if defined(SK_BUILD_FOR_MAC) || defined(SK_BUILD_FOR_IOS)
+    const struct timespec& modified = status.st_mtimespec;
+#else
+    const struct timespec& modified = status.st_mtim;
+#endif
+    stamp->fVolume = status.st_dev;
+    stamp->fFile = status.st_ino;
+    stamp->fModified = (int64_t)modified.tv_sec * 1000000000 + modified.tv_nsec;
+    return true;
+}
+
 int sk_fileno(FILE* f) {
     return fileno(f);
 }
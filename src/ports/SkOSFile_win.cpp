@@ -115,6 +115,27 @@ void* sk_fdmmap(int fileno, size_t* length) {
     return addr;
 }
 
+bool sk_fstamp(FILE* f, SkFileStamp* stamp) {
+    int fileno = _fileno(f);
+    if (fileno < 0) {
+        return false;
+    }
+    HANDLE file = (HANDLE)_get_osfhandle(fileno);
+    if (INVALID_HANDLE_VALUE == file) {
+        return false;
+    }
+    BY_HANDLE_FILE_INFORMATION info;
+    if (0 == GetFileInformationByHandle(file, &info)) {
+        return false;
+    }
+    stamp->fVolume = info.dwVolumeSerialNumber;
+    stamp->fFile = info.nFileIndexLow + (((uint64_t)info.nFileIndexHigh) << 32);
+    // In 100 nanosecond intervals.
+    stamp->fModified = (int64_t)(info.ftLastWriteTime.dwLowDateTime +
+                                 (((uint64_t)info.ftLastWriteTime.dwHighDateTime) << 32));
+    return true;
+}
+
 int sk_fileno(FILE* f) {
     return _fileno((FILE*)f);
 }
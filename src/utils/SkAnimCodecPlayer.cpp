@@ -9,6 +9,7 @@
 #include "include/core/SkData.h"
 #include "include/core/SkImage.h"
 #include "include/utils/SkAnimCodecPlayer.h"
+#include "include/utils/SkAnimFrameDecoder.h"
 #include "src/codec/SkCodecImageGenerator.h"
 #include <algorithm>
 
@@ -16,14 +17,7 @@ SkAnimCodecPlayer::SkAnimCodecPlayer(std::unique_ptr<SkCodec> codec) : fCodec(st
     fImageInfo = fCodec->getInfo();
     fFrameInfos = fCodec->getFrameInfo();
     fImages.resize(fFrameInfos.size());
-
-    // change the interpretation of fDuration to a end-time for that frame
-    size_t dur = 0;
-    for (auto& f : fFrameInfos) {
-        dur += f.fDuration;
-        f.fDuration = dur;
-    }
-    fTotalDuration = dur;
+    this->computeDuration();
 
     if (!fTotalDuration) {
         // Static image -- may or may not have returned a single frame info.
@@ -34,8 +28,33 @@ SkAnimCodecPlayer::SkAnimCodecPlayer(std::unique_ptr<SkCodec> codec) : fCodec(st
     }
 }
 
+// How many frames past the current one to keep decoded ahead of time.
+static constexpr int kPrefetchFrames = 4;
+
+SkAnimCodecPlayer::SkAnimCodecPlayer(sk_sp<SkAnimFrameDecoder> decoder)
+        : fDecoder(std::move(decoder)) {
+    fImageInfo = fDecoder->imageInfo();
+    fFrameInfos = fDecoder->frameInfos();
+    this->computeDuration();
+
+    if (!fTotalDuration) {
+        fFrameInfos.clear();
+    }
+    fDecoder->prefetch(0, kPrefetchFrames);
+}
+
 SkAnimCodecPlayer::~SkAnimCodecPlayer() {}
 
+void SkAnimCodecPlayer::computeDuration() {
+    // change the interpretation of fDuration to a end-time for that frame
+    size_t dur = 0;
+    for (auto& f : fFrameInfos) {
+        dur += f.fDuration;
+        f.fDuration = dur;
+    }
+    fTotalDuration = dur;
+}
+
 SkISize SkAnimCodecPlayer::dimensions() {
     return { fImageInfo.width(), fImageInfo.height() };
 }
@@ -43,6 +62,10 @@ SkISize SkAnimCodecPlayer::dimensions() {
 sk_sp<SkImage> SkAnimCodecPlayer::getFrameAt(int index) {
     SkASSERT((unsigned)index < fFrameInfos.size());
 
+    if (fDecoder) {
+        return fDecoder->getFrame(index);
+    }
+
     if (fImages[index]) {
         return fImages[index];
     }
@@ -70,6 +93,10 @@ sk_sp<SkImage> SkAnimCodecPlayer::getFrameAt(int index) {
 }
 
 sk_sp<SkImage> SkAnimCodecPlayer::getFrame() {
+    if (fDecoder) {
+        return fDecoder->getFrame(fCurrIndex);
+    }
+
     SkASSERT(fTotalDuration > 0 || fImages.size() == 1);
 
     return fTotalDuration > 0
@@ -90,6 +117,9 @@ bool SkAnimCodecPlayer::seek(uint32_t msec) {
                                   });
     int prevIndex = fCurrIndex;
     fCurrIndex = lower - fFrameInfos.begin();
+    if (fDecoder && fCurrIndex != prevIndex) {
+        fDecoder->prefetch(fCurrIndex + 1, kPrefetchFrames);
+    }
     return fCurrIndex != prevIndex;
 }
 
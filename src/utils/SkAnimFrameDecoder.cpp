@@ -0,0 +1,214 @@
+/*
+ * Copyright 2020 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/utils/SkAnimFrameDecoder.h"
+
+#include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkImage.h"
+#include "include/private/SkTArray.h"
+
+#include <algorithm>
+#include <climits>
+
+sk_sp<SkAnimFrameDecoder> SkAnimFrameDecoder::Make(sk_sp<SkData> data, SkExecutor* executor,
+                                                   size_t cacheBudget) {
+    std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(data);
+    if (!codec) {
+        return nullptr;
+    }
+    return sk_sp<SkAnimFrameDecoder>(new SkAnimFrameDecoder(std::move(data), std::move(codec),
+                                                            executor, cacheBudget));
+}
+
+SkAnimFrameDecoder::SkAnimFrameDecoder(sk_sp<SkData> data, std::unique_ptr<SkCodec> codec,
+                                       SkExecutor* executor, size_t cacheBudget)
+    : fData(std::move(data))
+    , fExecutor(executor)
+    , fCacheBudget(cacheBudget)
+    , fImageInfo(codec->getInfo())
+    , fFrameBytes(fImageInfo.computeMinByteSize())
+    , fFrameInfos(codec->getFrameInfo()) {
+    if (fFrameInfos.empty()) {
+        // A still image.
+        SkCodec::FrameInfo info;
+        info.fRequiredFrame = SkCodec::kNoFrame;
+        info.fDuration = 0;
+        info.fFullyReceived = true;
+        info.fAlphaType = fImageInfo.alphaType();
+        info.fDisposalMethod = SkCodecAnimation::DisposalMethod::kKeep;
+        fFrameInfos.push_back(info);
+    }
+
+    fFrames.reset(new Frame[fFrameInfos.size()]);
+    for (const auto& info : fFrameInfos) {
+        if (info.fRequiredFrame != SkCodec::kNoFrame) {
+            fFrames[info.fRequiredFrame].fIsReference = true;
+        }
+    }
+
+    fIdleCodecs.push_back(std::move(codec));
+}
+
+SkAnimFrameDecoder::~SkAnimFrameDecoder() {}
+
+size_t SkAnimFrameDecoder::cachedBytes() const {
+    SkAutoMutexExclusive lock(fMutex);
+    return fCachedBytes;
+}
+
+sk_sp<SkImage> SkAnimFrameDecoder::lookup(int index) {
+    fMutex.assertHeld();
+    Frame& frame = fFrames[index];
+    if (frame.fImage) {
+        frame.fLastUse = ++fUseCount;
+    }
+    return frame.fImage;
+}
+
+void SkAnimFrameDecoder::purgeAsNeeded(int keep) {
+    fMutex.assertHeld();
+    while (fCachedBytes > fCacheBudget) {
+        // Purge the least recently used frame, preferring ones no other frame is decoded from.
+        int victim = -1;
+        for (int i = 0; i < this->frameCount(); ++i) {
+            const Frame& frame = fFrames[i];
+            if (i == keep || !frame.fImage) {
+                continue;
+            }
+            if (victim < 0) {
+                victim = i;
+                continue;
+            }
+            const Frame& worst = fFrames[victim];
+            if (frame.fIsReference != worst.fIsReference
+                    ? !frame.fIsReference
+                    : frame.fLastUse < worst.fLastUse) {
+                victim = i;
+            }
+        }
+        if (victim < 0) {
+            return;
+        }
+        fFrames[victim].fImage = nullptr;
+        fCachedBytes -= fFrameBytes;
+    }
+}
+
+sk_sp<SkImage> SkAnimFrameDecoder::getFrame(int index) {
+    if (index < 0 || index >= this->frameCount()) {
+        return nullptr;
+    }
+
+    // Walk back through the frames index depends on until we find one that is cached.  Those
+    // we passed are decoded from the oldest on.
+    SkSTArray<16, int> toDecode;
+    sk_sp<SkImage> image;
+    {
+        SkAutoMutexExclusive lock(fMutex);
+        for (int i = index; i != SkCodec::kNoFrame; i = fFrameInfos[i].fRequiredFrame) {
+            if ((image = this->lookup(i))) {
+                break;
+            }
+            toDecode.push_back(i);
+        }
+    }
+
+    for (int i = toDecode.count() - 1; i >= 0; --i) {
+        image = this->decodeFrame(toDecode[i], std::move(image));
+        if (!image) {
+            return nullptr;
+        }
+    }
+    return image;
+}
+
+sk_sp<SkImage> SkAnimFrameDecoder::decodeFrame(int index, sk_sp<SkImage> prior) {
+    Frame& frame = fFrames[index];
+    SkAutoMutexExclusive decodeLock(frame.fDecodeMutex);
+
+    std::unique_ptr<SkCodec> codec;
+    {
+        SkAutoMutexExclusive lock(fMutex);
+        // Another thread may have decoded it while we waited.
+        if (auto image = this->lookup(index)) {
+            return image;
+        }
+        if (!fIdleCodecs.empty()) {
+            codec = std::move(fIdleCodecs.back());
+            fIdleCodecs.pop_back();
+        }
+    }
+    // A codec decodes one frame at a time, so each thread decoding needs its own.
+    if (!codec) {
+        codec = SkCodec::MakeFromData(fData);
+        if (!codec) {
+            return nullptr;
+        }
+    }
+
+    const size_t rowBytes = fImageInfo.minRowBytes();
+    sk_sp<SkData> pixels = SkData::MakeUninitialized(fFrameBytes);
+
+    SkCodec::Options options;
+    options.fFrameIndex = index;
+    SkPixmap priorPixmap;
+    if (prior && prior->peekPixels(&priorPixmap)) {
+        SkASSERT(fFrameInfos[index].fRequiredFrame != SkCodec::kNoFrame);
+        sk_careful_memcpy(pixels->writable_data(), priorPixmap.addr(), fFrameBytes);
+        options.fPriorFrame = fFrameInfos[index].fRequiredFrame;
+    }
+    const SkCodec::Result result = codec->getPixels(fImageInfo, pixels->writable_data(),
+                                                    rowBytes, &options);
+
+    SkAutoMutexExclusive lock(fMutex);
+    fIdleCodecs.push_back(std::move(codec));
+    if (SkCodec::kSuccess != result) {
+        return nullptr;
+    }
+
+    frame.fImage = SkImage::MakeRasterData(fImageInfo, std::move(pixels), rowBytes);
+    frame.fLastUse = ++fUseCount;
+    fCachedBytes += fFrameBytes;
+    this->purgeAsNeeded(index);
+    return frame.fImage;
+}
+
+void SkAnimFrameDecoder::prefetch(int index, int count) {
+    if (!fExecutor || index < 0) {
+        return;
+    }
+
+    // Prefetching more than fits would purge the frames we are about to show.
+    count = std::min(count, this->frameCount());
+    if (fFrameBytes > 0) {
+        count = std::min(count, (int)std::min<size_t>(fCacheBudget / fFrameBytes, INT_MAX));
+    }
+
+    SkSTArray<16, int> queue;
+    {
+        SkAutoMutexExclusive lock(fMutex);
+        for (int n = 0; n < count; ++n) {
+            const int i = (index + n) % this->frameCount();
+            Frame& frame = fFrames[i];
+            if (!frame.fImage && !frame.fQueued) {
+                frame.fQueued = true;
+                queue.push_back(i);
+            }
+        }
+    }
+
+    // Frames with a cached or independent frame to start from are decoded in parallel.  Those
+    // in a chain wait on each other in decodeFrame(), and each is only decoded once.
+    for (int i : queue) {
+        fExecutor->add([self = sk_ref_sp(this), i] {
+            self->getFrame(i);
+            SkAutoMutexExclusive lock(self->fMutex);
+            self->fFrames[i].fQueued = false;
+        });
+    }
+}
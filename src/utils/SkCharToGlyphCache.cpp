@@ -8,6 +8,8 @@
 #include "include/private/SkTFitsIn.h"
 #include "src/utils/SkCharToGlyphCache.h"
 
+#include <algorithm>
+
 SkCharToGlyphCache::SkCharToGlyphCache() {
     this->reset();
 }
@@ -15,6 +17,11 @@ SkCharToGlyphCache::SkCharToGlyphCache() {
 SkCharToGlyphCache::~SkCharToGlyphCache() {}
 
 void SkCharToGlyphCache::reset() {
+    for (auto& page : fBMP) {
+        page.reset();
+    }
+    fBMPCount = 0;
+
     fK32.reset();
     fV16.reset();
 
@@ -94,6 +101,13 @@ static int find_with_slope(const SkUnichar base[], int count, SkUnichar value, d
 }
 
 int SkCharToGlyphCache::findGlyphIndex(SkUnichar unichar) const {
+    if ((uint32_t)unichar <= 0xFFFF) {
+        // The index is not used to insert characters in the BMP.
+        const SkGlyphID* page = this->bmpPage(unichar);
+        SkGlyphID glyph = page ? page[unichar & (kBMPPageSize - 1)] : kNoGlyph;
+        return glyph != kNoGlyph ? glyph : ~0;
+    }
+
     const int count = fK32.count();
     int index;
     if (count <= kSmallCountLimit) {
@@ -107,7 +121,46 @@ int SkCharToGlyphCache::findGlyphIndex(SkUnichar unichar) const {
     return index;
 }
 
+int SkCharToGlyphCache::findGlyphs(const SkUnichar unichars[], int count,
+                                   SkGlyphID glyphs[]) const {
+    int i = 0;
+    while (i < count) {
+        // Look up runs of characters in the same page of the BMP without searching.
+        if (const SkGlyphID* page = this->bmpPage(unichars[i])) {
+            const uint32_t pageBase = unichars[i] & ~(kBMPPageSize - 1);
+            for (; i < count && (uint32_t)unichars[i] - pageBase < kBMPPageSize; ++i) {
+                SkGlyphID glyph = page[unichars[i] - pageBase];
+                if (glyph == kNoGlyph) {
+                    return i;
+                }
+                glyphs[i] = glyph;
+            }
+            continue;
+        }
+
+        int index = this->findGlyphIndex(unichars[i]);
+        if (index < 0) {
+            return i;
+        }
+        glyphs[i++] = SkToU16(index);
+    }
+    return count;
+}
+
 void SkCharToGlyphCache::insertCharAndGlyph(int index, SkUnichar unichar, SkGlyphID glyph) {
+    SkASSERT(glyph != kNoGlyph);
+    if ((uint32_t)unichar <= 0xFFFF) {
+        auto& page = fBMP[unichar >> kBMPPageBits];
+        if (!page) {
+            page.reset(new SkGlyphID[kBMPPageSize]);
+            std::fill_n(page.get(), kBMPPageSize, kNoGlyph);
+        }
+        SkASSERT(page[unichar & (kBMPPageSize - 1)] == kNoGlyph);
+        page[unichar & (kBMPPageSize - 1)] = glyph;
+        fBMPCount += 1;
+        return;
+    }
+
     SkASSERT(fK32.size() == fV16.size());
     SkASSERT((unsigned)index < fK32.size());
     SkASSERT(unichar < fK32[index]);
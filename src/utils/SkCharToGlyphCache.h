@@ -11,6 +11,8 @@
 #include "include/core/SkTypes.h"
 #include "include/private/SkTDArray.h"
 
+#include <memory>
+
 class SkCharToGlyphCache {
 public:
     SkCharToGlyphCache();
@@ -18,7 +20,7 @@ public:
 
     // return number of unichars cached
     int count() const {
-        return fK32.count();
+        return fK32.count() + fBMPCount;
     }
 
     void reset();       // forget all cache entries (to save memory)
@@ -37,6 +39,12 @@ public:
      */
     int findGlyphIndex(SkUnichar c) const;
 
+    /**
+     *  Look up the glyphIDs of unichars until one is not in the cache, returning how many were
+     *  found. Much faster than calling findGlyphIndex() for each unichar in the BMP.
+     */
+    int findGlyphs(const SkUnichar unichars[], int count, SkGlyphID glyphs[]) const;
+
     /**
      *  Insert a new char/glyph pair into the cache at the specified index.
      *  See charToGlyph() for how to compute the bit-not of the index.
@@ -54,6 +62,20 @@ public:
     }
 
 private:
+    // Glyphs can't be 0xFFFF, since a font has at most 0xFFFF of them.
+    static constexpr SkGlyphID kNoGlyph = 0xFFFF;
+    static constexpr int kBMPPageBits = 8;
+    static constexpr int kBMPPageSize = 1 << kBMPPageBits;
+
+    const SkGlyphID* bmpPage(SkUnichar unichar) const {
+        return (uint32_t)unichar <= 0xFFFF ? fBMP[unichar >> kBMPPageBits].get() : nullptr;
+    }
+
+    // Characters in the BMP are looked up directly, in pages allocated when a character in them
+    // is inserted, and filled with kNoGlyph. Other characters are kept in the sorted arrays.
+    std::unique_ptr<SkGlyphID[]> fBMP[0x10000 >> kBMPPageBits];
+    int                  fBMPCount;
+
     SkTDArray<int32_t>   fK32;
     SkTDArray<uint16_t>  fV16;
     double               fDenom;
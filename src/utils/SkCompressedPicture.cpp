@@ -0,0 +1,203 @@
+/*
+ * Copyright 2020 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/utils/SkCompressedPicture.h"
+
+#include "include/core/SkData.h"
+#include "include/core/SkStream.h"
+#include "include/private/SkTo.h"
+#include "src/core/SkStreamPriv.h"
+#include "src/core/SkTaskGroup.h"
+#include "src/pdf/SkDeflate.h"
+
+#include <atomic>
+#include <vector>
+
+#include "zlib.h"
+
+// A compressed picture is laid out as
+//
+//     char     magic[8]                  "skiapicz"
+//     uint32_t version
+//     uint32_t chunk count
+//     uint64_t uncompressed size
+//     chunk count times:
+//         uint32_t uncompressed size     at most kMaxChunkSize
+//         uint32_t stored size           if equal to the uncompressed size, the chunk is stored
+//         uint8_t  data[stored size]     otherwise it's a zlib stream
+//
+// and the uncompressed bytes are an ordinary serialized SkPicture.
+
+static const char     kMagic[]      = { 's', 'k', 'i', 'a', 'p', 'i', 'c', 'z' };
+static const uint32_t kVersion      = 1;
+static const size_t   kMinChunkSize = 4096;
+static const size_t   kMaxChunkSize = 1 << 30;
+
+// Used to bound what an untrusted header may ask us to allocate.  zlib never inflates more
+// than 1032:1, and a stream of unknown length gets at most this many chunks.
+static const size_t   kChunkHeaderSize         = 2 * sizeof(uint32_t);
+static const uint64_t kMaxDeflateRatio         = 1032;
+static const uint32_t kMaxUnboundedChunkCount  = 1 << 20;
+
+bool SkCompressedPicture::Serialize(const SkPicture* picture, SkWStream* stream,
+                                    const Options& options, const SkSerialProcs* procs) {
+    if (!picture || !stream) {
+        return false;
+    }
+    sk_sp<SkData> skp = picture->serialize(procs);
+    if (skp->size() < options.fMinCompressedSize) {
+        return stream->write(skp->data(), skp->size());
+    }
+
+    const size_t chunkSize = SkTPin(options.fChunkSize, kMinChunkSize, kMaxChunkSize);
+    const int    chunkCount = SkToInt((skp->size() + chunkSize - 1) / chunkSize);
+    const int    level = SkTPin(options.fCompressionLevel, -1, 9);
+    const auto*  bytes = skp->bytes();
+
+    // Chunks are independent, so we compress them in parallel too.
+    std::vector<sk_sp<SkData>> chunks(chunkCount);
+    SkTaskGroup().batch(chunkCount, [&](int i) {
+        const size_t offset = i * chunkSize,
+                     size   = SkTMin(chunkSize, skp->size() - offset);
+        SkDynamicMemoryWStream compressed;
+        {
+            SkDeflateWStream deflate(&compressed, level);
+            deflate.write(bytes + offset, size);
+        }
+        chunks[i] = compressed.bytesWritten() < size
+                  ? compressed.detachAsData()
+                  : SkData::MakeWithoutCopy(bytes + offset, size);
+    });
+
+    uint64_t totalSize = skp->size();
+    bool ok = stream->write(kMagic, sizeof(kMagic))
+           && stream->write32(kVersion)
+           && stream->write32(chunkCount)
+           && stream->write(&totalSize, sizeof(totalSize));
+    for (int i = 0; ok && i < chunkCount; i++) {
+        const size_t offset = i * chunkSize,
+                     size   = SkTMin(chunkSize, skp->size() - offset);
+        ok = stream->write32(SkToU32(size))
+          && stream->write32(SkToU32(chunks[i]->size()))
+          && stream->write(chunks[i]->data(), chunks[i]->size());
+    }
+    return ok;
+}
+
+// Reads the rest of a compressed picture (after the magic) and returns its uncompressed bytes.
+static sk_sp<SkData> inflate(SkStream* stream) {
+    uint32_t version, chunkCount;
+    uint64_t totalSize;
+    if (!stream->readU32(&version) || version != kVersion ||
+        !stream->readU32(&chunkCount) ||
+        stream->read(&totalSize, sizeof(totalSize)) != sizeof(totalSize) ||
+        !SkTFitsIn<size_t>(totalSize)) {
+        return nullptr;
+    }
+
+    // The header is untrusted, so bound the chunk count by what the stream could hold.
+    if (stream->hasLength() && stream->hasPosition()) {
+        const size_t remaining = stream->getLength() - stream->getPosition();
+        if (chunkCount > remaining / kChunkHeaderSize) {
+            return nullptr;
+        }
+    } else if (chunkCount > kMaxUnboundedChunkCount) {
+        return nullptr;
+    }
+    if (chunkCount > totalSize / kMinChunkSize + 1) {
+        return nullptr;
+    }
+
+    struct Chunk {
+        sk_sp<SkData> fStored;
+        size_t        fOffset;
+        size_t        fSize;
+    };
+    std::vector<Chunk> chunks;
+    uint64_t offset = 0;
+    for (uint32_t i = 0; i < chunkCount; i++) {
+        uint32_t size, storedSize;
+        if (!stream->readU32(&size) || size > kMaxChunkSize || size > totalSize - offset ||
+            !stream->readU32(&storedSize) || storedSize > size ||
+            size > (uint64_t)storedSize * kMaxDeflateRatio) {
+            return nullptr;
+        }
+        Chunk chunk;
+        chunk.fStored = SkData::MakeUninitialized(storedSize);
+        if (stream->read(chunk.fStored->writable_data(), storedSize) != storedSize) {
+            return nullptr;
+        }
+        chunk.fOffset = SkToSizeT(offset);
+        chunk.fSize   = size;
+        chunks.push_back(std::move(chunk));
+        offset += size;
+    }
+    // Every chunk has now been read, and no chunk inflates to more than kMaxDeflateRatio times
+    // its stored size, so totalSize is bounded by the bytes the stream actually held.
+    if (offset != totalSize) {
+        return nullptr;
+    }
+
+    sk_sp<SkData> skp = SkData::MakeUninitialized(SkToSizeT(totalSize));
+    auto* bytes = static_cast<uint8_t*>(skp->writable_data());
+    std::atomic<bool> ok{true};
+    SkTaskGroup().batch(SkToInt(chunks.size()), [&](int i) {
+        const Chunk& chunk = chunks[i];
+        if (chunk.fStored->size() == chunk.fSize) {
+            memcpy(bytes + chunk.fOffset, chunk.fStored->data(), chunk.fSize);
+            return;
+        }
+        uLongf size = SkTo<uLongf>(chunk.fSize);
+        if (uncompress(bytes + chunk.fOffset, &size,
+                       chunk.fStored->bytes(), SkTo<uLong>(chunk.fStored->size())) != Z_OK ||
+            size != chunk.fSize) {
+            ok = false;
+        }
+    });
+    return ok ? skp : nullptr;
+}
+
+sk_sp<SkPicture> SkCompressedPicture::MakeFromStream(SkStream* stream,
+                                                     const SkDeserialProcs* procs) {
+    if (!stream) {
+        return nullptr;
+    }
+
+    char magic[sizeof(kMagic)];
+    if (stream->peek(magic, sizeof(magic)) == sizeof(magic)) {
+        if (0 != memcmp(magic, kMagic, sizeof(kMagic))) {
+            return SkPicture::MakeFromStream(stream, procs);
+        }
+        stream->skip(sizeof(magic));
+    } else {
+        if (stream->read(magic, sizeof(magic)) != sizeof(magic)) {
+            return nullptr;
+        }
+        if (0 != memcmp(magic, kMagic, sizeof(kMagic))) {
+            // Not ours; put the magic back for SkPicture, by seeking if we can.
+            if (stream->move(-(long)sizeof(magic))) {
+                return SkPicture::MakeFromStream(stream, procs);
+            }
+            SkDynamicMemoryWStream skp;
+            skp.write(magic, sizeof(magic));
+            SkStreamCopy(&skp, stream);
+            return SkPicture::MakeFromData(skp.detachAsData().get(), procs);
+        }
+    }
+
+    sk_sp<SkData> skp = inflate(stream);
+    return skp ? SkPicture::MakeFromData(skp.get(), procs) : nullptr;
+}
+
+sk_sp<SkPicture> SkCompressedPicture::MakeFromData(const SkData* data,
+                                                   const SkDeserialProcs* procs) {
+    if (!data) {
+        return nullptr;
+    }
+    SkMemoryStream stream(sk_ref_sp(data));
+    return MakeFromStream(&stream, procs);
+}
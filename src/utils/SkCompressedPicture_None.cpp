@@ -0,0 +1,31 @@
+/*
+ * Copyright 2020 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkData.h"
+#include "include/core/SkStream.h"
+#include "include/utils/SkCompressedPicture.h"
+
+// Without zlib we write plain SKPs, and can only read them back.
+
+bool SkCompressedPicture::Serialize(const SkPicture* picture, SkWStream* stream,
+                                    const Options&, const SkSerialProcs* procs) {
+    if (!picture || !stream) {
+        return false;
+    }
+    sk_sp<SkData> skp = picture->serialize(procs);
+    return stream->write(skp->data(), skp->size());
+}
+
+sk_sp<SkPicture> SkCompressedPicture::MakeFromData(const SkData* data,
+                                                   const SkDeserialProcs* procs) {
+    return SkPicture::MakeFromData(data, procs);
+}
+
+sk_sp<SkPicture> SkCompressedPicture::MakeFromStream(SkStream* stream,
+                                                     const SkDeserialProcs* procs) {
+    return SkPicture::MakeFromStream(stream, procs);
+}
@@ -0,0 +1,245 @@
+/*
+ * Copyright 2020 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/utils/SkImageDecodeAhead.h"
+
+#include "include/core/SkBitmap.h"
+#include "include/core/SkPath.h"
+#include "include/core/SkPicture.h"
+#include "include/core/SkRRect.h"
+#include "include/core/SkRSXform.h"
+#include "include/core/SkShader.h"
+#include "include/core/SkVertices.h"
+#include "include/private/SkTHash.h"
+#include "include/utils/SkNoDrawCanvas.h"
+#include "src/core/SkBitmapCache.h"
+#include "src/core/SkMipMap.h"
+#include "src/core/SkTaskGroup.h"
+#include "src/image/SkImage_Base.h"
+
+#include <atomic>
+
+// Mirrors SkBitmapController: draws with at least medium quality that scale the image down are
+// drawn from its mipmaps (high quality is lowered to medium when scaling down).
+static bool needs_mipmaps(const SkMatrix& matrix, SkFilterQuality quality) {
+    SkSize scale;
+    return quality >= kMedium_SkFilterQuality &&
+           matrix.decomposeScale(&scale, nullptr) &&
+           (scale.width() < SK_Scalar1 || scale.height() < SK_Scalar1);
+}
+
+static bool is_lazy_raster(const SkImage* image) {
+    return image && image->isLazyGenerated() && !image->isTextureBacked();
+}
+
+namespace {
+
+// Plays a picture back to note the images it draws, and the matrix each is drawn with.
+class ImageFinder final : public SkNoDrawCanvas {
+public:
+    ImageFinder(const SkIRect& clip, std::vector<SkImageDecodeAhead::Request>* requests)
+        : INHERITED(clip)
+        , fRequests(requests) {}
+
+protected:
+    void onDrawImage(const SkImage* image, SkScalar x, SkScalar y, const SkPaint* paint) override {
+        if (image && !this->quickReject(SkRect::Make(image->bounds()).makeOffset(x, y))) {
+            this->add(image, SkMatrix::MakeTrans(x, y), paint);
+        }
+    }
+
+    void onDrawImageRect(const SkImage* image, const SkRect* src, const SkRect& dst,
+                         const SkPaint* paint, SrcRectConstraint) override {
+        if (image && !this->quickReject(dst)) {
+            SkRect srcRect = src ? *src : SkRect::Make(image->bounds());
+            this->add(image, SkMatrix::MakeRectToRect(srcRect, dst, SkMatrix::kFill_ScaleToFit),
+                      paint);
+        }
+    }
+
+    // Like onDrawImageRect, judge the scale from the whole image to dst. (SkCanvas caps the
+    // quality of nine patches and lattices at low, so they never want mipmaps today.)
+    void onDrawImageNine(const SkImage* image, const SkIRect&, const SkRect& dst,
+                         const SkPaint* paint) override {
+        if (image && !this->quickReject(dst)) {
+            this->add(image, SkMatrix::MakeRectToRect(SkRect::Make(image->bounds()), dst,
+                                                      SkMatrix::kFill_ScaleToFit), paint);
+        }
+    }
+
+    void onDrawImageLattice(const SkImage* image, const Lattice&, const SkRect& dst,
+                            const SkPaint* paint) override {
+        if (image && !this->quickReject(dst)) {
+            this->add(image, SkMatrix::MakeRectToRect(SkRect::Make(image->bounds()), dst,
+                                                      SkMatrix::kFill_ScaleToFit), paint);
+        }
+    }
+
+    void onDrawAtlas(const SkImage* atlas, const SkRSXform xform[], const SkRect[],
+                     const SkColor[], int count, SkBlendMode, const SkRect* cull,
+                     const SkPaint* paint) override {
+        if (!atlas || (cull && this->quickReject(*cull))) {
+            return;
+        }
+        for (int i = 0; i < count; ++i) {
+            SkMatrix matrix;
+            matrix.setRSXform(xform[i]);
+            this->add(atlas, matrix, paint);
+        }
+    }
+
+    void onDrawEdgeAAImageSet(const ImageSetEntry set[], int count, const SkPoint[],
+                              const SkMatrix preViewMatrices[], const SkPaint* paint,
+                              SrcRectConstraint) override {
+        for (int i = 0; i < count; ++i) {
+            SkMatrix matrix = SkMatrix::MakeRectToRect(set[i].fSrcRect, set[i].fDstRect,
+                                                       SkMatrix::kFill_ScaleToFit);
+            if (set[i].fMatrixIndex >= 0) {
+                matrix.postConcat(preViewMatrices[set[i].fMatrixIndex]);
+            }
+            this->add(set[i].fImage.get(), matrix, paint);
+        }
+    }
+
+    // Geometry may be filled with an image shader.
+    void onDrawPaint(const SkPaint& paint) override { this->addShader(paint, nullptr); }
+    void onDrawBehind(const SkPaint& paint) override { this->addShader(paint, nullptr); }
+    void onDrawRect(const SkRect& r, const SkPaint& paint) override {
+        this->addShader(paint, &r);
+    }
+    void onDrawRRect(const SkRRect& rr, const SkPaint& paint) override {
+        this->addShader(paint, &rr.getBounds());
+    }
+    void onDrawDRRect(const SkRRect& outer, const SkRRect&, const SkPaint& paint) override {
+        this->addShader(paint, &outer.getBounds());
+    }
+    void onDrawOval(const SkRect& r, const SkPaint& paint) override {
+        this->addShader(paint, &r);
+    }
+    void onDrawArc(const SkRect& r, SkScalar, SkScalar, bool, const SkPaint& paint) override {
+        this->addShader(paint, &r);
+    }
+    void onDrawPath(const SkPath& path, const SkPaint& paint) override {
+        this->addShader(paint, path.isInverseFillType() ? nullptr : &path.getBounds());
+    }
+    void onDrawRegion(const SkRegion&, const SkPaint& paint) override {
+        this->addShader(paint, nullptr);
+    }
+    void onDrawPoints(PointMode, size_t, const SkPoint[], const SkPaint& paint) override {
+        this->addShader(paint, nullptr);
+    }
+    void onDrawTextBlob(const SkTextBlob*, SkScalar, SkScalar, const SkPaint& paint) override {
+        this->addShader(paint, nullptr);
+    }
+    void onDrawPatch(const SkPoint[12], const SkColor[4], const SkPoint[4], SkBlendMode,
+                     const SkPaint& paint) override {
+        this->addShader(paint, nullptr);
+    }
+    void onDrawVerticesObject(const SkVertices*, const SkVertices::Bone[], int, SkBlendMode,
+                              const SkPaint& paint) override {
+        this->addShader(paint, nullptr);
+    }
+
+    // Unlike SkNoDrawCanvas, look inside nested pictures and drawables.
+    void onDrawPicture(const SkPicture* picture, const SkMatrix* matrix,
+                       const SkPaint* paint) override {
+        this->SkCanvas::onDrawPicture(picture, matrix, paint);
+    }
+    void onDrawDrawable(SkDrawable* drawable, const SkMatrix* matrix) override {
+        this->SkCanvas::onDrawDrawable(drawable, matrix);
+    }
+
+private:
+    void addShader(const SkPaint& paint, const SkRect* bounds) {
+        SkMatrix localMatrix;
+        const SkShader* shader = paint.getShader();
+        const SkImage* image = shader ? shader->isAImage(&localMatrix, nullptr) : nullptr;
+        if (image && !(bounds && this->quickReject(*bounds))) {
+            this->add(image, localMatrix, &paint);
+        }
+    }
+
+    void add(const SkImage* image, const SkMatrix& imageToLocal, const SkPaint* paint) {
+        if (!is_lazy_raster(image)) {
+            return;
+        }
+        SkImageDecodeAhead::Request request;
+        request.fImage = sk_ref_sp(image);
+        request.fMatrix = SkMatrix::Concat(this->getTotalMatrix(), imageToLocal);
+        request.fQuality = paint ? paint->getFilterQuality() : kNone_SkFilterQuality;
+
+        if (int* index = fIndices.find(image->uniqueID())) {
+            SkImageDecodeAhead::Request& existing = (*fRequests)[*index];
+            if (!needs_mipmaps(existing.fMatrix, existing.fQuality) &&
+                    needs_mipmaps(request.fMatrix, request.fQuality)) {
+                existing = std::move(request);
+            }
+            return;
+        }
+        fIndices.set(image->uniqueID(), (int)fRequests->size());
+        fRequests->push_back(std::move(request));
+    }
+
+    std::vector<SkImageDecodeAhead::Request>* fRequests;
+    SkTHashMap<uint32_t, int>                 fIndices;
+
+    typedef SkNoDrawCanvas INHERITED;
+};
+
+}  // namespace
+
+std::vector<SkImageDecodeAhead::Request> SkImageDecodeAhead::FindImages(const SkPicture* picture,
+                                                                        const SkMatrix& matrix,
+                                                                        const SkIRect& clip) {
+    std::vector<Request> requests;
+    if (picture) {
+        ImageFinder finder(clip, &requests);
+        finder.drawPicture(picture, &matrix, nullptr);
+    }
+    return requests;
+}
+
+int SkImageDecodeAhead::Decode(const Request requests[], int count, SkExecutor* executor) {
+    std::atomic<int> decoded{0};
+    auto decode = [&](int i) {
+        const SkImage* image = requests[i].fImage.get();
+        if (!is_lazy_raster(image)) {
+            return;
+        }
+        // This is what a raster draw looks up, so it finds the pixels in the cache.
+        SkBitmap bitmap;
+        if (!as_IB(image)->getROPixels(&bitmap, SkImage::kAllow_CachingHint)) {
+            return;
+        }
+        if (needs_mipmaps(requests[i].fMatrix, requests[i].fQuality)) {
+            sk_sp<const SkMipMap> mipmaps(
+                    SkMipMapCache::FindAndRef(SkBitmapCacheDesc::Make(image)));
+            if (!mipmaps) {
+                mipmaps.reset(SkMipMapCache::AddAndRef(as_IB(image)));
+            }
+            if (!mipmaps) {
+                return;
+            }
+        }
+        decoded++;
+    };
+
+    if (executor) {
+        SkTaskGroup(*executor).batch(count, decode);
+    } else {
+        for (int i = 0; i < count; i++) {
+            decode(i);
+        }
+    }
+    return decoded.load();
+}
+
+int SkImageDecodeAhead::DecodePicture(const SkPicture* picture, const SkMatrix& matrix,
+                                      const SkIRect& clip, SkExecutor* executor) {
+    std::vector<Request> requests = FindImages(picture, matrix, clip);
+    return Decode(requests.data(), (int)requests.size(), executor);
+}
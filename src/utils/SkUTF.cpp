@@ -3,6 +3,8 @@
 
 #include "src/utils/SkUTF.h"
 
+#include "include/private/SkVx.h"
+
 #include <climits>
 
 static constexpr inline int32_t left_shift(int32_t value, int32_t shift) {
@@ -42,6 +44,16 @@ static bool utf8_type_is_valid_leading_byte(int type) { return type > 0; }
 
 static bool utf8_byte_is_continuation(uint8_t c) { return utf8_byte_type(c) == 0; }
 
+// Text is mostly ASCII, or at least mostly in the BMP, so it pays to check 16 code units at a
+// time for anything that needs decoding. A block that fails is decoded one code point at a time.
+static bool utf8_is_ascii_16(const char* utf8) {
+    return !any(skvx::Vec<16, uint8_t>::Load(utf8) & 0x80);
+}
+
+static bool utf16_is_bmp_16(const uint16_t* utf16) {
+    return !any((skvx::Vec<16, uint16_t>::Load(utf16) & 0xF800) == 0xD800);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 int SkUTF::CountUTF8(const char* utf8, size_t byteLength) {
@@ -50,7 +62,16 @@ int SkUTF::CountUTF8(const char* utf8, size_t byteLength) {
     }
     int count = 0;
     const char* stop = utf8 + byteLength;
+    const char* nextBlock = utf8;
     while (utf8 < stop) {
+        if (utf8 >= nextBlock && stop - utf8 >= 16) {
+            if (utf8_is_ascii_16(utf8)) {
+                utf8 += 16;
+                count += 16;
+                continue;
+            }
+            nextBlock = utf8 + 16;
+        }
         int type = utf8_byte_type(*(const uint8_t*)utf8);
         if (!utf8_type_is_valid_leading_byte(type) || utf8 + type > stop) {
             return -1;  // Sequence extends beyond end.
@@ -73,8 +94,17 @@ int SkUTF::CountUTF16(const uint16_t* utf16, size_t byteLength) {
     }
     const uint16_t* src = (const uint16_t*)utf16;
     const uint16_t* stop = src + (byteLength >> 1);
+    const uint16_t* nextBlock = src;
     int count = 0;
     while (src < stop) {
+        if (src >= nextBlock && stop - src >= 16) {
+            if (utf16_is_bmp_16(src)) {
+                src += 16;
+                count += 16;
+                continue;
+            }
+            nextBlock = src + 16;
+        }
         unsigned c = *src++;
         if (utf16_is_low_surrogate(c)) {
             return -1;
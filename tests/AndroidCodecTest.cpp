@@ -12,6 +12,7 @@
 #include "include/core/SkColorSpace.h"
 #include "include/core/SkData.h"
 #include "include/core/SkEncodedImageFormat.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImageGenerator.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkRefCnt.h"
@@ -28,6 +29,7 @@
 #include <initializer_list>
 #include <memory>
 #include <utility>
+#include <vector>
 
 static SkISize times(const SkISize& size, float factor) {
     return { (int) (size.width() * factor), (int) (size.height() * factor) };
@@ -299,3 +301,86 @@ DEF_TEST(AndroidCodec_sampledOrientation, r) {
         ERRORF(r, "got result \"%s\"\n", SkCodec::ResultToString(result));
     }
 }
+
+DEF_TEST(AndroidCodec_DecodeRegions, r) {
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    for (const char* path : { "images/mandrill_512_q075.jpg", "images/mandrill_256.png",
+                              "images/color_wheel.webp" }) {
+        sk_sp<SkData> data = GetResourceAsData(path);
+        if (!data) {
+            continue;
+        }
+        std::unique_ptr<SkAndroidCodec> codec = SkAndroidCodec::MakeFromData(data);
+        if (!codec) {
+            // Decoding this format may not be supported in this build.
+            REPORTER_ASSERT(r, !SkAndroidCodec::DecodeRegions(data, 1, nullptr, 0));
+            continue;
+        }
+
+        for (int sampleSize : { 1, 3 }) {
+            // Tile the image, keeping a copy of each tile decoded on its own to compare with.
+            const SkImageInfo& info = codec->getInfo();
+            std::vector<SkBitmap> tiles, expected;
+            std::vector<SkAndroidCodec::Region> regions;
+            for (int y = 0; y < info.height(); y += 64) {
+                for (int x = 0; x < info.width(); x += 96) {
+                    SkIRect subset = SkIRect::MakeXYWH(x, y, 96, 64);
+                    if (!subset.intersect(SkIRect::MakeSize(info.dimensions())) ||
+                        !codec->getSupportedSubset(&subset)) {
+                        continue;
+                    }
+                    SkISize size = codec->getSampledSubsetDimensions(sampleSize, subset);
+                    tiles.emplace_back();
+                    tiles.back().allocPixels(info.makeDimensions(size));
+                    expected.emplace_back();
+                    expected.back().allocPixels(info.makeDimensions(size));
+
+                    SkAndroidCodec::AndroidOptions options;
+                    options.fSubset = &subset;
+                    options.fSampleSize = sampleSize;
+                    REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getAndroidPixels(
+                            expected.back().info(), expected.back().getPixels(),
+                            expected.back().rowBytes(), &options));
+
+                    SkAndroidCodec::Region region;
+                    region.fSubset = subset;
+                    regions.push_back(region);
+                }
+            }
+            for (size_t i = 0; i < regions.size(); i++) {
+                regions[i].fDst = tiles[i].pixmap();
+            }
+
+            for (SkExecutor* e : { executor.get(), (SkExecutor*)nullptr }) {
+                for (const SkBitmap& tile : tiles) {
+                    tile.eraseColor(SK_ColorTRANSPARENT);
+                }
+                REPORTER_ASSERT(r, SkAndroidCodec::DecodeRegions(data, sampleSize, regions.data(),
+                                                                 (int)regions.size(), e));
+                for (size_t i = 0; i < regions.size(); i++) {
+                    REPORTER_ASSERT(r, SkCodec::kSuccess == regions[i].fResult);
+                    REPORTER_ASSERT(r, 0 == memcmp(tiles[i].getPixels(), expected[i].getPixels(),
+                                                   tiles[i].computeByteSize()));
+                }
+            }
+        }
+    }
+
+    // A region the wrong size for its subset fails on its own.
+    sk_sp<SkData> data = GetResourceAsData("images/mandrill_512_q075.jpg");
+    if (!data) {
+        return;
+    }
+    SkBitmap bm;
+    bm.allocN32Pixels(10, 10);
+    SkAndroidCodec::Region regions[2];
+    regions[0].fSubset = SkIRect::MakeWH(10, 10);
+    regions[0].fDst = bm.pixmap();
+    regions[1].fSubset = SkIRect::MakeWH(20, 20);
+    regions[1].fDst = bm.pixmap();
+    REPORTER_ASSERT(r, SkAndroidCodec::DecodeRegions(data, 1, regions, 2, executor.get()));
+    REPORTER_ASSERT(r, SkCodec::kSuccess == regions[0].fResult);
+    REPORTER_ASSERT(r, SkCodec::kSuccess != regions[1].fResult);
+
+    REPORTER_ASSERT(r, !SkAndroidCodec::DecodeRegions(SkData::MakeEmpty(), 1, nullptr, 0));
+}
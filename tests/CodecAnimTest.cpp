@@ -10,6 +10,7 @@
 #include "include/codec/SkCodecAnimation.h"
 #include "include/core/SkBitmap.h"
 #include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkRect.h"
@@ -18,6 +19,7 @@
 #include "include/core/SkString.h"
 #include "include/core/SkTypes.h"
 #include "include/utils/SkAnimCodecPlayer.h"
+#include "include/utils/SkAnimFrameDecoder.h"
 #include "tests/CodecPriv.h"
 #include "tests/Test.h"
 #include "tools/Resources.h"
@@ -496,3 +498,66 @@ DEF_TEST(AnimCodecPlayer, r) {
         REPORTER_ASSERT(r, f1->bounds().size() == test.fSize);
     }
 }
+
+DEF_TEST(AnimFrameDecoder, r) {
+    auto executor = SkExecutor::MakeFIFOThreadPool(4);
+
+    for (const char* file : { "images/required.gif", "images/required.webp",
+                              "images/alphabetAnim.gif", "images/randPixels.png" }) {
+        sk_sp<SkData> data = GetResourceAsData(file);
+        if (!data) {
+            continue;
+        }
+        auto decoder = SkAnimFrameDecoder::Make(data);
+        REPORTER_ASSERT(r, decoder);
+        if (!decoder) {
+            continue;
+        }
+        const SkImageInfo& info = decoder->imageInfo();
+        const int frameCount = decoder->frameCount();
+        REPORTER_ASSERT(r, frameCount >= 1);
+
+        // Decode every frame in order, from its required frame, for reference.
+        std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(data);
+        std::vector<SkBitmap> expected(frameCount);
+        for (int i = 0; i < frameCount; ++i) {
+            expected[i].allocPixels(info);
+            SkCodec::Options options;
+            options.fFrameIndex = i;
+            const int required = decoder->frameInfos()[i].fRequiredFrame;
+            if (required != SkCodec::kNoFrame) {
+                REPORTER_ASSERT(r, expected[required].readPixels(expected[i].pixmap()));
+                options.fPriorFrame = required;
+            }
+            REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getPixels(expected[i].pixmap(),
+                                                                     &options));
+        }
+
+        // A budget of two frames forces frames to be decoded again from their required frames.
+        const size_t budget = 2 * info.computeMinByteSize();
+        for (SkExecutor* exec : { (SkExecutor*)nullptr, executor.get() }) {
+            decoder = SkAnimFrameDecoder::Make(data, exec, budget);
+            decoder->prefetch(0, frameCount);
+            for (int i = frameCount - 1; i >= 0; --i) {
+                sk_sp<SkImage> frame = decoder->getFrame(i);
+                SkPixmap pixmap;
+                if (!frame || !frame->peekPixels(&pixmap)) {
+                    ERRORF(r, "%s: failed to decode frame %d", file, i);
+                    continue;
+                }
+                if (!ToolUtils::equal_pixels(pixmap, expected[i].pixmap())) {
+                    ERRORF(r, "%s: frame %d does not match a sequential decode", file, i);
+                }
+                REPORTER_ASSERT(r, decoder->cachedBytes() <= budget);
+            }
+            REPORTER_ASSERT(r, !decoder->getFrame(frameCount));
+        }
+
+        // The player shares the decoder's cache.
+        auto player = std::make_unique<SkAnimCodecPlayer>(decoder);
+        REPORTER_ASSERT(r, player->dimensions() == info.dimensions());
+        REPORTER_ASSERT(r, player->getFrame());
+        player->seek(500);
+        REPORTER_ASSERT(r, player->getFrame());
+    }
+}
@@ -13,6 +13,7 @@
 #include "include/core/SkColorSpace.h"
 #include "include/core/SkData.h"
 #include "include/core/SkEncodedImageFormat.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkImageEncoder.h"
 #include "include/core/SkImageGenerator.h"
@@ -47,12 +48,17 @@
 #include "png.h"
 
 #include <setjmp.h>
+#include <stdio.h>
 #include <cstring>
 #include <initializer_list>
 #include <memory>
 #include <utility>
 #include <vector>
 
+extern "C" {
+    #include "jpeglib.h"
+}
+
 #if PNG_LIBPNG_VER_MAJOR == 1 && PNG_LIBPNG_VER_MINOR < 5
     // FIXME (scroggo): Google3 needs to be updated to use a newer version of libpng. In
     // the meantime, we had to break some pieces of SkPngCodec in order to support Google3.
@@ -1787,3 +1793,215 @@ DEF_TEST(Codec_F16_noColorSpace, r) {
                                        .makeColorSpace(nullptr);
     test_info(r, codec.get(), info, SkCodec::kSuccess, nullptr);
 }
+
+// Encodes src, which must be RGBA_8888 or Gray_8, with a restart marker every restartInterval
+// MCUs.
+static sk_sp<SkData> encode_jpeg_with_restarts(const SkPixmap& src, int restartInterval,
+                                               bool subsampleChroma) {
+    jpeg_compress_struct cinfo;
+    jpeg_error_mgr jerr;
+    cinfo.err = jpeg_std_error(&jerr);
+    jpeg_create_compress(&cinfo);
+    unsigned char* buffer = nullptr;
+    unsigned long size = 0;
+    jpeg_mem_dest(&cinfo, &buffer, &size);
+
+    const bool gray = kGray_8_SkColorType == src.colorType();
+    cinfo.image_width = src.width();
+    cinfo.image_height = src.height();
+    cinfo.input_components = gray ? 1 : 4;
+    cinfo.in_color_space = gray ? JCS_GRAYSCALE : JCS_EXT_RGBA;
+    jpeg_set_defaults(&cinfo);
+    jpeg_set_quality(&cinfo, 90, TRUE);
+    cinfo.restart_interval = restartInterval;
+    if (!gray && !subsampleChroma) {
+        cinfo.comp_info[0].h_samp_factor = 1;
+        cinfo.comp_info[0].v_samp_factor = 1;
+    }
+
+    jpeg_start_compress(&cinfo, TRUE);
+    while (cinfo.next_scanline < cinfo.image_height) {
+        JSAMPROW row = (JSAMPROW)src.addr(0, cinfo.next_scanline);
+        jpeg_write_scanlines(&cinfo, &row, 1);
+    }
+    jpeg_finish_compress(&cinfo);
+    jpeg_destroy_compress(&cinfo);
+
+    sk_sp<SkData> data = SkData::MakeWithCopy(buffer, size);
+    free(buffer);
+    return data;
+}
+
+static void check_parallel_decode(skiatest::Reporter* r, sk_sp<SkData> data,
+                                  const SkImageInfo& dstInfo, SkExecutor* executor) {
+    std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(data);
+    if (!codec) {
+        ERRORF(r, "Could not create codec");
+        return;
+    }
+    SkBitmap serial, parallel;
+    serial.allocPixels(dstInfo);
+    parallel.allocPixels(dstInfo);
+    serial.eraseColor(SK_ColorTRANSPARENT);
+    parallel.eraseColor(SK_ColorTRANSPARENT);
+
+    SkCodec::Result expected = codec->getPixels(serial.pixmap());
+    SkCodec::Options options;
+    options.fExecutor = executor;
+    REPORTER_ASSERT(r, expected == codec->getPixels(parallel.pixmap(), &options));
+    for (int y = 0; y < dstInfo.height(); y++) {
+        if (memcmp(serial.getAddr(0, y), parallel.getAddr(0, y), dstInfo.minRowBytes())) {
+            ERRORF(r, "Row %d differs when decoding %s in parallel", y,
+                   ToolUtils::colortype_name(dstInfo.colorType()));
+            return;
+        }
+    }
+}
+
+DEF_TEST(Codec_jpeg_parallel, r) {
+    SkBitmap bitmap;
+    bitmap.allocPixels(SkImageInfo::Make(300, 517, kRGBA_8888_SkColorType, kOpaque_SkAlphaType));
+    SkRandom random;
+    for (int y = 0; y < bitmap.height(); y++) {
+        uint8_t* row = (uint8_t*)bitmap.getAddr(0, y);
+        for (int x = 0; x < bitmap.width(); x++) {
+            row[4 * x + 0] = x ^ (random.nextU() & 0x0F);
+            row[4 * x + 1] = y ^ (random.nextU() & 0x0F);
+            row[4 * x + 2] = (x * y) >> 8;
+            row[4 * x + 3] = 0xFF;
+        }
+    }
+    SkBitmap gray;
+    gray.allocPixels(bitmap.info().makeColorType(kGray_8_SkColorType));
+    bitmap.readPixels(gray.pixmap());
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    const sk_sp<SkColorSpace> adobe = SkColorSpace::MakeRGB(SkNamedTransferFn::k2Dot2,
+                                                            SkNamedGamut::kAdobeRGB);
+
+    // Restart intervals that do and don't line up with rows of MCUs, with and without
+    // subsampled chroma.
+    for (int interval : { 1, 7, 38 }) {
+        for (bool subsample : { true, false }) {
+            sk_sp<SkData> data = encode_jpeg_with_restarts(bitmap.pixmap(), interval, subsample);
+            SkImageInfo info = SkCodec::MakeFromData(data)->getInfo();
+            for (SkColorType ct : { kRGBA_8888_SkColorType, kBGRA_8888_SkColorType,
+                                    kRGB_565_SkColorType }) {
+                check_parallel_decode(r, data, info.makeColorType(ct), executor.get());
+            }
+            // With a color transform.
+            check_parallel_decode(r, data, info.makeColorType(kRGBA_F16_SkColorType)
+                                               .makeColorSpace(adobe), executor.get());
+
+            // Truncated images are decoded serially.
+            check_parallel_decode(r, SkData::MakeSubset(data.get(), 0, data->size() / 2), info,
+                                  executor.get());
+        }
+
+        sk_sp<SkData> data = encode_jpeg_with_restarts(gray.pixmap(), interval, false);
+        SkImageInfo info = SkCodec::MakeFromData(data)->getInfo();
+        check_parallel_decode(r, data, info, executor.get());
+        check_parallel_decode(r, data, info.makeColorType(kN32_SkColorType), executor.get());
+    }
+
+    // Images without restart markers, or that are CMYK, are decoded serially.
+    for (const char* path : { "images/icc-v2-gbr.jpg", "images/mandrill_512_q075.jpg",
+                              "images/mandrill_cmyk.jpg" }) {
+        sk_sp<SkData> data = GetResourceAsData(path);
+        if (!data) {
+            continue;
+        }
+        SkImageInfo info = SkCodec::MakeFromData(data)->getInfo();
+        check_parallel_decode(r, data, info.makeColorType(kN32_SkColorType), executor.get());
+    }
+}
+
+DEF_TEST(Codec_getResizedPixels, r) {
+    // A horizontal gradient, which averages to its value at the center of each resized pixel.
+    SkBitmap gradient;
+    gradient.allocPixels(SkImageInfo::Make(64, 48, kRGBA_8888_SkColorType, kOpaque_SkAlphaType));
+    for (int y = 0; y < gradient.height(); y++) {
+        for (int x = 0; x < gradient.width(); x++) {
+            uint8_t* pixel = (uint8_t*)gradient.getAddr32(x, y);
+            pixel[0] = 4 * x;
+            pixel[1] = 4 * y;
+            pixel[2] = 0;
+            pixel[3] = 0xFF;
+        }
+    }
+    SkDynamicMemoryWStream stream;
+    REPORTER_ASSERT(r, SkPngEncoder::Encode(&stream, gradient.pixmap(), SkPngEncoder::Options()));
+    auto codec = SkCodec::MakeFromData(stream.detachAsData());
+    REPORTER_ASSERT(r, codec);
+
+    for (SkISize size : { SkISize{64, 48}, SkISize{32, 24}, SkISize{25, 19}, SkISize{1, 1} }) {
+        SkBitmap bm;
+        bm.allocPixels(SkImageInfo::Make(size, kRGBA_8888_SkColorType, kOpaque_SkAlphaType));
+        REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getResizedPixels(bm.pixmap()));
+        for (int y = 0; y < size.height(); y++) {
+            for (int x = 0; x < size.width(); x++) {
+                float srcX = (x + 0.5f) * 64 / size.width()  - 0.5f,
+                      srcY = (y + 0.5f) * 48 / size.height() - 0.5f;
+                const uint8_t* pixel = (const uint8_t*)bm.getAddr32(x, y);
+                REPORTER_ASSERT(r, SkScalarNearlyEqual(pixel[0], 4 * srcX, 1));
+                REPORTER_ASSERT(r, SkScalarNearlyEqual(pixel[1], 4 * srcY, 1));
+            }
+        }
+    }
+
+    SkBitmap bm;
+    bm.allocPixels(SkImageInfo::Make(65, 10, kRGBA_8888_SkColorType, kOpaque_SkAlphaType));
+    REPORTER_ASSERT(r, SkCodec::kInvalidScale == codec->getResizedPixels(bm.pixmap()));
+    bm.allocPixels(SkImageInfo::Make(10, 10, kRGB_565_SkColorType, kOpaque_SkAlphaType));
+    REPORTER_ASSERT(r, SkCodec::kInvalidConversion == codec->getResizedPixels(bm.pixmap()));
+
+    // Unpremultiplied pixels are averaged premultiplied, so the color of transparent pixels
+    // does not show up in the result.
+    {
+        SkBitmap halves;
+        halves.allocPixels(SkImageInfo::Make(4, 4, kRGBA_8888_SkColorType, kUnpremul_SkAlphaType));
+        for (int y = 0; y < 4; y++) {
+            for (int x = 0; x < 4; x++) {
+                uint8_t* pixel = (uint8_t*)halves.getAddr32(x, y);
+                pixel[0] = x < 2 ? 0xFF : 0;     // transparent red on the left,
+                pixel[1] = x < 2 ? 0 : 0xFF;     // opaque green on the right.
+                pixel[2] = 0;
+                pixel[3] = x < 2 ? 0 : 0xFF;
+            }
+        }
+        SkDynamicMemoryWStream halvesStream;
+        REPORTER_ASSERT(r, SkPngEncoder::Encode(&halvesStream, halves.pixmap(),
+                                                SkPngEncoder::Options()));
+        auto halvesCodec = SkCodec::MakeFromData(halvesStream.detachAsData());
+        REPORTER_ASSERT(r, halvesCodec);
+        SkBitmap unpremul;
+        unpremul.allocPixels(SkImageInfo::Make(1, 1, kRGBA_8888_SkColorType,
+                                               kUnpremul_SkAlphaType));
+        REPORTER_ASSERT(r, SkCodec::kSuccess == halvesCodec->getResizedPixels(unpremul.pixmap()));
+        const uint8_t* pixel = (const uint8_t*)unpremul.getAddr32(0, 0);
+        REPORTER_ASSERT(r, pixel[0] == 0);
+        REPORTER_ASSERT(r, pixel[1] == 0xFF);
+        REPORTER_ASSERT(r, SkScalarNearlyEqual(pixel[3], 128, 1));
+    }
+
+    // JPEGs are decoded at the nearest larger DCT scale, and then resampled.
+    codec = SkCodec::MakeFromData(GetResourceAsData("images/mandrill_512_q075.jpg"));
+    if (!codec) {
+        return;
+    }
+    SkBitmap full, resized;
+    full.allocN32Pixels(512, 512);
+    resized.allocN32Pixels(100, 75);
+    REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getPixels(full.pixmap()));
+    REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getResizedPixels(resized.pixmap()));
+    auto average = [](const SkBitmap& bm) {
+        uint64_t sum = 0;
+        for (int y = 0; y < bm.height(); y++) {
+            for (int x = 0; x < bm.width(); x++) {
+                sum += SkColorGetG(*bm.getAddr32(x, y));
+            }
+        }
+        return (float)sum / (bm.width() * bm.height());
+    };
+    REPORTER_ASSERT(r, SkScalarNearlyEqual(average(full), average(resized), 2));
+}
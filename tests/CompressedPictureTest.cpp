@@ -0,0 +1,144 @@
+/*
+ * Copyright 2020 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkData.h"
+#include "include/core/SkPictureRecorder.h"
+#include "include/core/SkStream.h"
+#include "include/utils/SkCompressedPicture.h"
+#include "tests/Test.h"
+
+static sk_sp<SkPicture> make_picture(int rects) {
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(100, 100);
+    SkPaint paint;
+    for (int i = 0; i < rects; i++) {
+        paint.setColor(SkColorSetRGB(i & 0xFF, (i * 3) & 0xFF, (i / 8) & 0xFF));
+        canvas->drawRect(SkRect::MakeXYWH(i % 90, i % 70, 10, 30), paint);
+    }
+    return recorder.finishRecordingAsPicture();
+}
+
+static bool draws_same(const SkPicture& a, const SkPicture& b) {
+    SkBitmap bmA, bmB;
+    bmA.allocN32Pixels(100, 100);
+    bmB.allocN32Pixels(100, 100);
+    bmA.eraseColor(SK_ColorWHITE);
+    bmB.eraseColor(SK_ColorWHITE);
+    SkCanvas(bmA).drawPicture(&a);
+    SkCanvas(bmB).drawPicture(&b);
+    return 0 == memcmp(bmA.getPixels(), bmB.getPixels(), bmA.computeByteSize());
+}
+
+// A stream that can neither peek nor seek, like a socket.
+class ForwardOnlyStream : public SkStream {
+public:
+    explicit ForwardOnlyStream(sk_sp<SkData> data) : fStream(std::move(data)) {}
+    size_t read(void* buffer, size_t size) override { return fStream.read(buffer, size); }
+    bool isAtEnd() const override { return fStream.isAtEnd(); }
+
+private:
+    SkMemoryStream fStream;
+};
+
+DEF_TEST(CompressedPicture_Small, r) {
+    // Small pictures are written as plain SKPs.
+    sk_sp<SkPicture> picture = make_picture(3);
+    SkDynamicMemoryWStream stream;
+    REPORTER_ASSERT(r, SkCompressedPicture::Serialize(picture.get(), &stream));
+    sk_sp<SkData> data = stream.detachAsData();
+    REPORTER_ASSERT(r, data->equals(picture->serialize().get()));
+
+    sk_sp<SkPicture> copy = SkCompressedPicture::MakeFromData(data.get());
+    REPORTER_ASSERT(r, copy && draws_same(*picture, *copy));
+
+    ForwardOnlyStream forward(data);
+    copy = SkCompressedPicture::MakeFromStream(&forward);
+    REPORTER_ASSERT(r, copy && draws_same(*picture, *copy));
+}
+
+// A stream whose writes always fail, like a full disk.
+class FailingWStream : public SkWStream {
+public:
+    bool write(const void*, size_t) override { return false; }
+    size_t bytesWritten() const override { return 0; }
+};
+
+DEF_TEST(CompressedPicture_WriteFailure, r) {
+    // Plain and compressed pictures both report a failed write.
+    for (int rects : { 3, 2000 }) {
+        sk_sp<SkPicture> picture = make_picture(rects);
+        FailingWStream stream;
+        REPORTER_ASSERT(r, !SkCompressedPicture::Serialize(picture.get(), &stream));
+    }
+}
+
+DEF_TEST(CompressedPicture_Chunked, r) {
+    sk_sp<SkPicture> picture = make_picture(2000);
+    sk_sp<SkData> plain = picture->serialize();
+
+    SkCompressedPicture::Options options;
+    options.fChunkSize = 4096;
+    SkDynamicMemoryWStream stream;
+    REPORTER_ASSERT(r, SkCompressedPicture::Serialize(picture.get(), &stream, options));
+    sk_sp<SkData> data = stream.detachAsData();
+#ifdef SK_SUPPORT_COMPRESSED_PICTURE
+    REPORTER_ASSERT(r, data->size() < plain->size() / 2);
+#endif
+
+    sk_sp<SkPicture> copy = SkCompressedPicture::MakeFromData(data.get());
+    REPORTER_ASSERT(r, copy && draws_same(*picture, *copy));
+
+    ForwardOnlyStream forward(data);
+    copy = SkCompressedPicture::MakeFromStream(&forward);
+    REPORTER_ASSERT(r, copy && draws_same(*picture, *copy));
+
+    // The reader must stop at the end of the picture, leaving anything after it alone.
+    SkDynamicMemoryWStream twice;
+    twice.write(data->data(), data->size());
+    twice.write(data->data(), data->size());
+    std::unique_ptr<SkStreamAsset> both = twice.detachAsStream();
+    REPORTER_ASSERT(r, SkCompressedPicture::MakeFromStream(both.get()));
+    REPORTER_ASSERT(r, SkCompressedPicture::MakeFromStream(both.get()));
+
+    // Truncated or corrupt data is rejected.
+    sk_sp<SkData> truncated = SkData::MakeSubset(data.get(), 0, data->size() / 2);
+    REPORTER_ASSERT(r, !SkCompressedPicture::MakeFromData(truncated.get()));
+#ifdef SK_SUPPORT_COMPRESSED_PICTURE
+    sk_sp<SkData> corrupt = SkData::MakeWithCopy(data->data(), data->size());
+    static_cast<uint8_t*>(corrupt->writable_data())[100] ^= 0xFF;
+    REPORTER_ASSERT(r, !SkCompressedPicture::MakeFromData(corrupt.get()));
+#endif
+}
+
+#ifdef SK_SUPPORT_COMPRESSED_PICTURE
+DEF_TEST(CompressedPicture_HostileHeader, r) {
+    // Headers claiming far more chunks or bytes than the stream holds are rejected before
+    // anything is allocated for them.
+    auto make = [](uint32_t chunkCount, uint64_t totalSize, uint32_t size, uint32_t storedSize) {
+        SkDynamicMemoryWStream stream;
+        stream.write("skiapicz", 8);
+        stream.write32(1);
+        stream.write32(chunkCount);
+        stream.write(&totalSize, sizeof(totalSize));
+        stream.write32(size);
+        stream.write32(storedSize);
+        stream.write("junk", 4);
+        return stream.detachAsData();
+    };
+
+    sk_sp<SkData> manyChunks = make(0xFFFFFFFF, ~(uint64_t)0, 4, 4);
+    REPORTER_ASSERT(r, !SkCompressedPicture::MakeFromData(manyChunks.get()));
+    ForwardOnlyStream forward(manyChunks);
+    REPORTER_ASSERT(r, !SkCompressedPicture::MakeFromStream(&forward));
+
+    // A chunk can't inflate to more than deflate's maximum ratio.
+    sk_sp<SkData> bigChunk = make(1, 1 << 30, 1 << 30, 4);
+    REPORTER_ASSERT(r, !SkCompressedPicture::MakeFromData(bigChunk.get()));
+}
+#endif
@@ -9,8 +9,10 @@
 #include "tools/Resources.h"
 
 #include "include/core/SkBitmap.h"
+#include "include/codec/SkCodec.h"
 #include "include/core/SkColorPriv.h"
 #include "include/core/SkEncodedImageFormat.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkStream.h"
 #include "include/core/SkSurface.h"
@@ -330,6 +332,133 @@ DEF_TEST(Encode_PngOptions, r) {
     REPORTER_ASSERT(r, almost_equals(bm0, bm2, 0));
 }
 
+static bool decodes_to(sk_sp<SkData> data, const SkPixmap& expected) {
+    std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(std::move(data));
+    if (!codec) {
+        return false;
+    }
+    SkBitmap bm;
+    bm.allocPixels(expected.info());
+    if (SkCodec::kSuccess != codec->getPixels(bm.pixmap())) {
+        return false;
+    }
+    for (int y = 0; y < expected.height(); y++) {
+        if (memcmp(bm.getAddr(0, y), expected.addr(0, y), expected.info().minRowBytes())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+DEF_TEST(Encode_PngParallel, r) {
+    // Tall enough to be split into a few strips.
+    SkBitmap bitmap;
+    bitmap.allocPixels(SkImageInfo::Make(512, 1100, kRGBA_8888_SkColorType,
+                                         kUnpremul_SkAlphaType));
+    for (int y = 0; y < bitmap.height(); y++) {
+        uint8_t* row = (uint8_t*)bitmap.getAddr(0, y);
+        for (int x = 0; x < bitmap.width(); x++) {
+            row[4 * x + 0] = x;
+            row[4 * x + 1] = y;
+            row[4 * x + 2] = (x * y) >> 6;
+            row[4 * x + 3] = 255 - ((x ^ y) & 0x3F);
+        }
+    }
+    const SkPixmap& src = bitmap.pixmap();
+
+    std::unique_ptr<SkExecutor> one = SkExecutor::MakeFIFOThreadPool(1),
+                                four = SkExecutor::MakeFIFOThreadPool(4);
+    for (auto filters : { SkPngEncoder::FilterFlag::kAll, SkPngEncoder::FilterFlag::kPaeth,
+                          SkPngEncoder::FilterFlag::kZero }) {
+        for (int level : { 0, 6 }) {
+            SkPngEncoder::Options options;
+            options.fFilterFlags = filters;
+            options.fZLibLevel = level;
+
+            SkDynamicMemoryWStream serial, parallel1, parallel4;
+            REPORTER_ASSERT(r, SkPngEncoder::Encode(&serial, src, options));
+            options.fExecutor = one.get();
+            REPORTER_ASSERT(r, SkPngEncoder::Encode(&parallel1, src, options));
+            options.fExecutor = four.get();
+            REPORTER_ASSERT(r, SkPngEncoder::Encode(&parallel4, src, options));
+
+            // The output doesn't depend on the number of threads.
+            sk_sp<SkData> data1 = parallel1.detachAsData();
+            sk_sp<SkData> data4 = parallel4.detachAsData();
+            REPORTER_ASSERT(r, data1->equals(data4.get()));
+
+            REPORTER_ASSERT(r, decodes_to(serial.detachAsData(), src));
+            REPORTER_ASSERT(r, decodes_to(data4, src));
+        }
+    }
+
+    // Images too small to split are encoded serially.
+    SkPixmap small;
+    REPORTER_ASSERT(r, src.extractSubset(&small, SkIRect::MakeWH(512, 10)));
+    SkPngEncoder::Options options;
+    SkDynamicMemoryWStream serial, parallel;
+    REPORTER_ASSERT(r, SkPngEncoder::Encode(&serial, small, options));
+    options.fExecutor = one.get();
+    REPORTER_ASSERT(r, SkPngEncoder::Encode(&parallel, small, options));
+    sk_sp<SkData> serialData = serial.detachAsData();
+    REPORTER_ASSERT(r, serialData->equals(parallel.detachAsData().get()));
+}
+
+// Passes |src| to |encoder| in strips of |stripRows| rows.
+static bool encode_in_strips(SkEncoder* encoder, const SkPixmap& src, int stripRows) {
+    for (int y = 0; y < src.height(); y += stripRows) {
+        SkPixmap strip;
+        if (!src.extractSubset(&strip, SkIRect::MakeXYWH(0, y, src.width(), stripRows)) ||
+            !encoder->encodeRows(strip)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+DEF_TEST(Encode_PngStreaming, r) {
+    SkBitmap bitmap;
+    bitmap.allocPixels(SkImageInfo::Make(300, 200, kRGBA_8888_SkColorType, kPremul_SkAlphaType));
+    for (int y = 0; y < bitmap.height(); y++) {
+        for (int x = 0; x < bitmap.width(); x++) {
+            *bitmap.getAddr32(x, y) =
+                    SkPreMultiplyARGB((x + y) & 0xFF, x & 0xFF, y, (x ^ y) & 0xFF);
+        }
+    }
+    const SkPixmap& src = bitmap.pixmap();
+
+    SkDynamicMemoryWStream expected;
+    REPORTER_ASSERT(r, SkPngEncoder::Encode(&expected, src, SkPngEncoder::Options()));
+    sk_sp<SkData> expectedData = expected.detachAsData();
+
+    for (int stripRows : { 1, 7, 64, 200 }) {
+        SkDynamicMemoryWStream streamed;
+        std::unique_ptr<SkEncoder> encoder =
+                SkPngEncoder::Make(&streamed, src.info(), SkPngEncoder::Options());
+        REPORTER_ASSERT(r, encoder);
+        REPORTER_ASSERT(r, encode_in_strips(encoder.get(), src, stripRows));
+        REPORTER_ASSERT(r, expectedData->equals(streamed.detachAsData().get()));
+    }
+
+    // Rows that don't match the image are rejected.
+    SkDynamicMemoryWStream dst;
+    std::unique_ptr<SkEncoder> encoder =
+            SkPngEncoder::Make(&dst, src.info(), SkPngEncoder::Options());
+    SkPixmap narrow;
+    REPORTER_ASSERT(r, src.extractSubset(&narrow, SkIRect::MakeWH(100, 10)));
+    REPORTER_ASSERT(r, !encoder->encodeRows(narrow));
+    SkPixmap unpremul(src.info().makeAlphaType(kUnpremul_SkAlphaType), src.addr(),
+                      src.rowBytes());
+    REPORTER_ASSERT(r, !encoder->encodeRows(unpremul));
+
+    // Without pixels, rows can't be encoded by count.
+    REPORTER_ASSERT(r, !encoder->encodeRows(10));
+
+    // Encoders made from a pixmap already have all of their rows.
+    encoder = SkPngEncoder::Make(&dst, src, SkPngEncoder::Options());
+    REPORTER_ASSERT(r, !encoder->encodeRows(src));
+}
+
 #ifndef SK_BUILD_FOR_GOOGLE3
 DEF_TEST(Encode_WebpQuality, r) {
     SkBitmap bm;
@@ -430,3 +559,39 @@ DEF_TEST(Encode_WebpOptions, r) {
     REPORTER_ASSERT(r, almost_equals(bm0, bm2, 90));
     REPORTER_ASSERT(r, almost_equals(bm2, bm3, 50));
 }
+
+DEF_TEST(Encode_WebpEffort, r) {
+    SkBitmap bitmap;
+    if (!GetResourceAsBitmap("images/google_chrome.ico", &bitmap)) {
+        return;
+    }
+
+    for (auto compression : { SkWebpEncoder::Compression::kLossless,
+                              SkWebpEncoder::Compression::kLossy }) {
+        SkBitmap expected;
+        for (auto effort : { SkWebpEncoder::Effort::kDefault, SkWebpEncoder::Effort::kFastest,
+                             SkWebpEncoder::Effort::kFast, SkWebpEncoder::Effort::kBalanced,
+                             SkWebpEncoder::Effort::kSmallest }) {
+            for (bool multithreaded : { false, true }) {
+                SkWebpEncoder::Options options;
+                options.fCompression = compression;
+                options.fEffort = effort;
+                options.fMultithreaded = multithreaded;
+                SkDynamicMemoryWStream dst;
+                REPORTER_ASSERT(r, SkWebpEncoder::Encode(&dst, bitmap.pixmap(), options));
+
+                sk_sp<SkImage> image = SkImage::MakeFromEncoded(dst.detachAsData());
+                SkBitmap decoded;
+                REPORTER_ASSERT(r, image && image->asLegacyBitmap(&decoded));
+                if (expected.isNull()) {
+                    expected = decoded;
+                } else if (SkWebpEncoder::Compression::kLossless == compression) {
+                    // Effort only changes how small the image gets, never the pixels.
+                    REPORTER_ASSERT(r, almost_equals(expected, decoded, 0));
+                } else {
+                    REPORTER_ASSERT(r, almost_equals(expected, decoded, 90));
+                }
+            }
+        }
+    }
+}
@@ -6,16 +6,21 @@
  */
 
 #include "include/core/SkFont.h"
+#include "include/core/SkGraphics.h"
 #include "include/core/SkPaint.h"
+#include "include/core/SkPath.h"
 #include "include/core/SkStream.h"
 #include "include/core/SkTypeface.h"
 #include "src/core/SkAutoMalloc.h"
 #include "src/core/SkEndian.h"
 #include "src/core/SkFontStream.h"
 #include "src/core/SkOSFile.h"
+#include "src/core/SkTaskGroup.h"
 #include "tests/Test.h"
 #include "tools/Resources.h"
 
+#include <vector>
+
 //#define DUMP_TABLES
 //#define DUMP_TTC_TABLES
 
@@ -272,4 +277,46 @@ DEF_TEST(FontHost, reporter) {
     test_symbolfont(reporter);
 }
 
+// Glyphs from several typefaces, generated on many threads at once, should match the ones
+// generated one at a time.
+DEF_TEST(FontHost_ThreadedGlyphs, reporter) {
+    const char* names[] = {
+        "fonts/Em.ttf", "fonts/Funkster.ttf", "fonts/HangingS.ttf", "fonts/Roboto-Regular.ttf",
+    };
+    constexpr int kSizes = 8;
+    constexpr SkGlyphID kGlyphs = 32;
+
+    std::vector<SkFont> fonts;
+    for (const char* name : names) {
+        sk_sp<SkTypeface> typeface = MakeResourceAsTypeface(name);
+        if (!typeface) {
+            continue;
+        }
+        for (int i = 0; i < kSizes; i++) {
+            fonts.emplace_back(typeface, 12.0f + 5 * i);
+        }
+    }
+
+    auto glyph_paths = [](const SkFont& font) {
+        std::vector<SkPath> paths(kGlyphs);
+        for (SkGlyphID glyph = 0; glyph < kGlyphs; glyph++) {
+            font.getPath(glyph, &paths[glyph]);
+        }
+        return paths;
+    };
+
+    std::vector<std::vector<SkPath>> expected;
+    for (const SkFont& font : fonts) {
+        expected.push_back(glyph_paths(font));
+    }
+
+    SkGraphics::PurgeFontCache();
+    std::vector<std::vector<SkPath>> actual(fonts.size());
+    SkTaskGroup().batch((int)fonts.size(), [&](int i) { actual[i] = glyph_paths(fonts[i]); });
+
+    for (size_t i = 0; i < fonts.size(); i++) {
+        REPORTER_ASSERT(reporter, actual[i] == expected[i], "font %zu", i);
+    }
+}
+
 // need tests for SkStrSearch
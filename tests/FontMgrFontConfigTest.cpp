@@ -8,8 +8,10 @@
 #include "include/core/SkCanvas.h"
 #include "include/core/SkFont.h"
 #include "include/core/SkFontMgr.h"
+#include "include/core/SkGraphics.h"
 #include "include/core/SkTypeface.h"
 #include "include/ports/SkFontMgr_fontconfig.h"
+#include "src/core/SkTaskGroup.h"
 #include "tests/Test.h"
 #include "tools/Resources.h"
 
@@ -101,3 +103,106 @@ DEF_TEST(FontMgrFontConfig, reporter) {
         REPORTER_ASSERT(reporter, success);
     }
 }
+
+DEF_TEST(FontMgrFontConfig_MatchCache, reporter) {
+    FcConfig* config = FcConfigCreate();
+    FcConfigSetSysRoot(config, reinterpret_cast<const FcChar8*>(GetResourcePath("").c_str()));
+    SkString fontsPath(reinterpret_cast<const char*>(FcConfigGetSysRoot(config)));
+    for (const char* font : { "/fonts/Distortable.ttf", "/fonts/Roboto-Regular.ttf" }) {
+        SkString path = fontsPath;
+        path += font;
+        FcConfigAppFontAddFile(config, reinterpret_cast<const FcChar8*>(path.c_str()));
+    }
+    FcConfigBuildFonts(config);
+    sk_sp<SkFontMgr> fontMgr(SkFontMgr_New_FontConfig(config));
+
+    sk_sp<SkTypeface> distortable(fontMgr->matchFamilyStyle("Distortable", SkFontStyle()));
+    if (!distortable) {
+        ERRORF(reporter, "Could not find typeface. FcVersion: %d", FcGetVersion());
+        return;
+    }
+    sk_sp<SkTypeface> again(fontMgr->matchFamilyStyle("Distortable", SkFontStyle()));
+    REPORTER_ASSERT(reporter, distortable == again);
+    REPORTER_ASSERT(reporter, !fontMgr->matchFamilyStyle("Not A Family", SkFontStyle()));
+    REPORTER_ASSERT(reporter, !fontMgr->matchFamilyStyle("Not A Family", SkFontStyle()));
+
+    // Every typeface found, whether from fontconfig or the cache, contains the character.
+    const char* bcp47[] = { "en" };
+    const SkUnichar characters[] = { 'a', 'b', 'Q', 'a', 0xE9, 'Q', 0x10FFFD, 0x10FFFD };
+    SkTaskGroup().batch(64, [&](int i) {
+        SkUnichar c = characters[i % SK_ARRAY_COUNT(characters)];
+        sk_sp<SkTypeface> typeface(fontMgr->matchFamilyStyleCharacter(
+                "Distortable", SkFontStyle(), bcp47, SK_ARRAY_COUNT(bcp47), c));
+        if (c == 0x10FFFD) {
+            REPORTER_ASSERT(reporter, !typeface);
+        } else {
+            REPORTER_ASSERT(reporter, typeface && typeface->unicharToGlyph(c) != 0);
+        }
+    });
+
+    // Repeated lookups find the same typeface.
+    sk_sp<SkTypeface> first(fontMgr->matchFamilyStyleCharacter(
+            nullptr, SkFontStyle(), bcp47, SK_ARRAY_COUNT(bcp47), 'a'));
+    sk_sp<SkTypeface> second(fontMgr->matchFamilyStyleCharacter(
+            nullptr, SkFontStyle(), bcp47, SK_ARRAY_COUNT(bcp47), 'a'));
+    REPORTER_ASSERT(reporter, first && first == second);
+
+    // Cached results don't depend on the order of lookups: each matches what a font manager
+    // which has never seen another character finds.
+    const SkUnichar fallbackCharacters[] = { 'a', 0xE9, 'Q', 0x300, '1', 0x2019 };
+    for (SkUnichar c : fallbackCharacters) {
+        FcConfigReference(config);
+        sk_sp<SkFontMgr> fresh(SkFontMgr_New_FontConfig(config));
+        sk_sp<SkTypeface> expected(fresh->matchFamilyStyleCharacter(
+                "Distortable", SkFontStyle(), bcp47, SK_ARRAY_COUNT(bcp47), c));
+        sk_sp<SkTypeface> cached(fontMgr->matchFamilyStyleCharacter(
+                "Distortable", SkFontStyle(), bcp47, SK_ARRAY_COUNT(bcp47), c));
+        REPORTER_ASSERT(reporter, !expected == !cached);
+        if (expected && cached) {
+            SkString expectedName, cachedName;
+            expected->getFamilyName(&expectedName);
+            cached->getFamilyName(&cachedName);
+            REPORTER_ASSERT(reporter, expectedName == cachedName, "U+%04X: %s != %s",
+                            c, expectedName.c_str(), cachedName.c_str());
+        }
+    }
+
+    // Cached results, including misses, are dropped by SkGraphics::PurgeFontCache(), which is
+    // how a client adding fonts to the configuration makes them visible.
+    SkString funksterPath = fontsPath;
+    funksterPath += "/fonts/Funkster.ttf";
+    sk_sp<SkTypeface> funkster = SkTypeface::MakeFromFile(funksterPath.c_str());
+    if (!funkster) {
+        return;
+    }
+    SkString funksterFamily;
+    funkster->getFamilyName(&funksterFamily);
+    REPORTER_ASSERT(reporter, !fontMgr->matchFamilyStyle(funksterFamily.c_str(), SkFontStyle()));
+    FcConfigAppFontAddFile(config, reinterpret_cast<const FcChar8*>(funksterPath.c_str()));
+    SkGraphics::PurgeFontCache();
+    sk_sp<SkTypeface> added(fontMgr->matchFamilyStyle(funksterFamily.c_str(), SkFontStyle()));
+    REPORTER_ASSERT(reporter, added);
+}
+
+DEF_TEST(FontMgrFontConfig_SharedFileData, reporter) {
+    // Typefaces for the same file share its bytes, even when made by different managers.
+    SkString path = GetResourcePath("fonts/Distortable.ttf");
+    sk_sp<SkTypeface> typefaces[2];
+    std::unique_ptr<SkStreamAsset> streams[2];
+    for (int i = 0; i < 2; ++i) {
+        FcConfig* config = FcConfigCreate();
+        FcConfigAppFontAddFile(config, reinterpret_cast<const FcChar8*>(path.c_str()));
+        FcConfigBuildFonts(config);
+        sk_sp<SkFontMgr> fontMgr(SkFontMgr_New_FontConfig(config));
+        typefaces[i].reset(fontMgr->matchFamilyStyle("Distortable", SkFontStyle()));
+        if (!typefaces[i]) {
+            ERRORF(reporter, "Could not find typeface. FcVersion: %d", FcGetVersion());
+            return;
+        }
+        int ttcIndex;
+        streams[i] = typefaces[i]->openStream(&ttcIndex);
+        REPORTER_ASSERT(reporter, streams[i] && streams[i]->getMemoryBase());
+    }
+    REPORTER_ASSERT(reporter, typefaces[0] != typefaces[1]);
+    REPORTER_ASSERT(reporter, streams[0]->getMemoryBase() == streams[1]->getMemoryBase());
+}
@@ -10,8 +10,11 @@
 #include "src/core/SkFontPriv.h"
 #include "src/core/SkReadBuffer.h"
 #include "src/core/SkWriteBuffer.h"
+#include "src/utils/SkUTF.h"
 #include "tests/Test.h"
 
+#include <vector>
+
 static SkFont serialize_deserialize(const SkFont& font, skiatest::Reporter* reporter) {
     SkBinaryWriteBuffer wb;
     SkFontPriv::Flatten(font, wb);
@@ -81,3 +84,35 @@ DEF_TEST(Font_flatten, reporter) {
         }
     }
 }
+
+DEF_TEST(Font_textToGlyphs, reporter) {
+    // Runs of ASCII and BMP characters are converted in blocks; interrupt them at every offset.
+    const SkUnichar others[] = {0xE9, 0x4E2D, 0x1F600};
+    SkFont font;
+    for (int offset = 0; offset < 40; offset++) {
+        for (SkUnichar other : others) {
+            std::vector<SkUnichar> utf32;
+            for (int i = 0; i < 50; i++) {
+                utf32.push_back(i == offset ? other : 'A' + i % 26);
+            }
+            std::vector<char> utf8;
+            std::vector<uint16_t> utf16;
+            for (SkUnichar c : utf32) {
+                char buffer8[4];
+                utf8.insert(utf8.end(), buffer8, buffer8 + SkUTF::ToUTF8(c, buffer8));
+                uint16_t buffer16[2];
+                utf16.insert(utf16.end(), buffer16, buffer16 + SkUTF::ToUTF16(c, buffer16));
+            }
+
+            SkGlyphID expected[50], fromUTF8[50], fromUTF16[50];
+            font.textToGlyphs(utf32.data(), utf32.size() * 4, SkTextEncoding::kUTF32, expected, 50);
+            REPORTER_ASSERT(reporter, 50 == font.textToGlyphs(utf8.data(), utf8.size(),
+                                                              SkTextEncoding::kUTF8, fromUTF8, 50));
+            REPORTER_ASSERT(reporter, 50 == font.textToGlyphs(utf16.data(), utf16.size() * 2,
+                                                              SkTextEncoding::kUTF16, fromUTF16,
+                                                              50));
+            REPORTER_ASSERT(reporter, 0 == memcmp(expected, fromUTF8, sizeof(expected)));
+            REPORTER_ASSERT(reporter, 0 == memcmp(expected, fromUTF16, sizeof(expected)));
+        }
+    }
+}
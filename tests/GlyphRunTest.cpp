@@ -7,8 +7,14 @@
 
 #include "src/core/SkGlyphRun.h"
 
+#include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkGraphics.h"
 #include "include/core/SkTextBlob.h"
+#include "include/core/SkTypeface.h"
 #include "tests/Test.h"
+#include "tools/Resources.h"
 
 #include <algorithm>
 #include <memory>
@@ -41,6 +47,60 @@ DEF_TEST(GlyphRunGlyphIDSetBasic, reporter) {
     }
 }
 
+DEF_TEST(GlyphRunPainterPrepareInParallel, reporter) {
+    // Glyphs are prepared in parallel per typeface (FreeType locks each face), so use several.
+    // Each draw makes its own typefaces, so it finds no strikes left by the others.
+    const char* fonts[] = {"fonts/Roboto-Regular.ttf", "fonts/Funkster.ttf", "fonts/Em.ttf"};
+    auto make_blob = [&]() -> sk_sp<SkTextBlob> {
+        sk_sp<SkTypeface> typefaces[SK_ARRAY_COUNT(fonts)];
+        for (size_t i = 0; i < SK_ARRAY_COUNT(fonts); i++) {
+            typefaces[i] = MakeResourceAsTypeface(fonts[i]);
+            if (!typefaces[i]) {
+                return nullptr;
+            }
+        }
+
+        // Runs in many sizes and typefaces, some more than once, and some large enough to be
+        // drawn as paths.
+        SkTextBlobBuilder builder;
+        SkFont font;
+        for (int i = 0; i < 24; i++) {
+            font.setTypeface(typefaces[i % SK_ARRAY_COUNT(typefaces)]);
+            font.setSize(i < 20 ? 6 + (i % 10) * 3 : 300);
+            const char text[] = "Sphinx of black quartz";
+            font.textToGlyphs(text, strlen(text), SkTextEncoding::kUTF8,
+                              builder.allocRun(font, strlen(text), 5, 10 + i * 40).glyphs,
+                              strlen(text));
+        }
+        return builder.make();
+    };
+
+    auto draw = [&](SkBitmap* bitmap) {
+        bitmap->allocN32Pixels(400, 1000);
+        bitmap->eraseColor(SK_ColorWHITE);
+        if (sk_sp<SkTextBlob> blob = make_blob()) {
+            SkCanvas(*bitmap).drawTextBlob(blob, 0, 0, SkPaint());
+            return true;
+        }
+        return false;
+    };
+
+    SkBitmap serial, parallel;
+    if (!draw(&serial)) {
+        return;
+    }
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    {
+        SkAutoFontRasterizationExecutor scope(executor.get());
+        // Several times, so that tasks for different typefaces get a chance to overlap.
+        for (int i = 0; i < 4; i++) {
+            REPORTER_ASSERT(reporter, draw(&parallel));
+            REPORTER_ASSERT(reporter, 0 == memcmp(serial.getPixels(), parallel.getPixels(),
+                                                  serial.computeByteSize()));
+        }
+    }
+}
+
 #if 0   // should we revitalize this by consing up a device for drawTextBlob() ?
 DEF_TEST(GlyphRunBlob, reporter) {
     constexpr uint16_t count = 5;
@@ -0,0 +1,148 @@
+/*
+ * Copyright 2020 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkImage.h"
+#include "include/core/SkPicture.h"
+#include "include/core/SkPictureRecorder.h"
+#include "include/core/SkShader.h"
+#include "include/utils/SkImageDecodeAhead.h"
+#include "src/core/SkBitmapCache.h"
+#include "src/core/SkMipMap.h"
+#include "tests/Test.h"
+
+static sk_sp<SkImage> make_lazy_image(SkColor color) {
+    SkBitmap bm;
+    bm.allocN32Pixels(64, 64);
+    bm.eraseColor(color);
+    sk_sp<SkData> encoded = SkImage::MakeFromBitmap(bm)->encodeToData();
+    return encoded ? SkImage::MakeFromEncoded(std::move(encoded)) : nullptr;
+}
+
+static bool is_decoded(const SkImage* image) {
+    SkBitmap bm;
+    return SkBitmapCache::Find(SkBitmapCacheDesc::Make(image), &bm);
+}
+
+static bool has_mipmaps(const SkImage* image) {
+    sk_sp<const SkMipMap> mipmaps(SkMipMapCache::FindAndRef(SkBitmapCacheDesc::Make(image)));
+    return mipmaps != nullptr;
+}
+
+static const SkImageDecodeAhead::Request* find(const std::vector<SkImageDecodeAhead::Request>& v,
+                                               const SkImage* image) {
+    for (const auto& request : v) {
+        if (request.fImage.get() == image) {
+            return &request;
+        }
+    }
+    return nullptr;
+}
+
+DEF_TEST(ImageDecodeAhead, r) {
+    for (bool threaded : {false, true}) {
+        sk_sp<SkImage> plain    = make_lazy_image(SK_ColorRED),
+                       scaled   = make_lazy_image(SK_ColorGREEN),
+                       shaded   = make_lazy_image(SK_ColorBLUE),
+                       nested   = make_lazy_image(SK_ColorCYAN),
+                       clipped  = make_lazy_image(SK_ColorMAGENTA);
+        if (!plain || !scaled || !shaded || !nested || !clipped) {
+            ERRORF(r, "Could not make lazy images.");
+            return;
+        }
+        SkImage* lazy[] = { plain.get(), scaled.get(), shaded.get(), nested.get(), clipped.get() };
+
+        SkPaint medium;
+        medium.setFilterQuality(kMedium_SkFilterQuality);
+
+        SkPictureRecorder recorder;
+        SkCanvas* canvas = recorder.beginRecording(64, 64);
+        canvas->drawImage(nested, 0, 0);
+        sk_sp<SkPicture> inner = recorder.finishRecordingAsPicture();
+
+        canvas = recorder.beginRecording(256, 256);
+        canvas->drawImage(plain, 0, 0);
+        // The same image drawn at 1:1 and scaled down gets one request, which needs mipmaps.
+        canvas->drawImage(scaled, 64, 0);
+        canvas->drawImageRect(scaled, SkRect::MakeXYWH(0, 64, 32, 32), &medium);
+        {
+            SkPaint paint(medium);
+            SkMatrix localMatrix = SkMatrix::MakeScale(0.25f);
+            paint.setShader(shaded->makeShader(SkTileMode::kRepeat, SkTileMode::kRepeat,
+                                               &localMatrix));
+            canvas->drawRect(SkRect::MakeXYWH(64, 64, 64, 64), paint);
+        }
+        SkMatrix innerMatrix = SkMatrix::MakeTrans(128, 128);
+        canvas->drawPicture(inner, &innerMatrix, nullptr);
+        canvas->drawImage(clipped, 1000, 1000);
+        sk_sp<SkPicture> picture = recorder.finishRecordingAsPicture();
+
+        const SkIRect clip = SkIRect::MakeWH(256, 256);
+        auto requests = SkImageDecodeAhead::FindImages(picture.get(), SkMatrix::I(), clip);
+        REPORTER_ASSERT(r, requests.size() == 4);
+        REPORTER_ASSERT(r, !find(requests, clipped.get()));
+
+        if (auto request = find(requests, scaled.get())) {
+            REPORTER_ASSERT(r, request->fMatrix == SkMatrix::MakeRectToRect(
+                    SkRect::MakeWH(64, 64), SkRect::MakeXYWH(0, 64, 32, 32),
+                    SkMatrix::kFill_ScaleToFit));
+            REPORTER_ASSERT(r, request->fQuality == kMedium_SkFilterQuality);
+        } else {
+            ERRORF(r, "Scaled image not found.");
+        }
+        if (auto request = find(requests, nested.get())) {
+            REPORTER_ASSERT(r, request->fMatrix == innerMatrix);
+        } else {
+            ERRORF(r, "Nested image not found.");
+        }
+        REPORTER_ASSERT(r, find(requests, shaded.get()));
+
+        for (const SkImage* image : lazy) {
+            REPORTER_ASSERT(r, !is_decoded(image));
+        }
+
+        std::unique_ptr<SkExecutor> executor;
+        if (threaded) {
+            executor = SkExecutor::MakeFIFOThreadPool(2);
+        }
+        int decoded = SkImageDecodeAhead::DecodePicture(picture.get(), SkMatrix::I(), clip,
+                                                        executor.get());
+        REPORTER_ASSERT(r, decoded == 4);
+
+        REPORTER_ASSERT(r,  is_decoded(plain.get())  && !has_mipmaps(plain.get()));
+        REPORTER_ASSERT(r,  is_decoded(scaled.get()) &&  has_mipmaps(scaled.get()));
+        REPORTER_ASSERT(r,  is_decoded(shaded.get()) &&  has_mipmaps(shaded.get()));
+        REPORTER_ASSERT(r,  is_decoded(nested.get()) && !has_mipmaps(nested.get()));
+        REPORTER_ASSERT(r, !is_decoded(clipped.get()));
+
+        // A nine patch is scaled from its image to dst, but SkCanvas draws it with at most low
+        // quality, so it never needs mipmaps.
+        sk_sp<SkImage> nine = make_lazy_image(SK_ColorYELLOW);
+        canvas = recorder.beginRecording(64, 64);
+        canvas->drawImageNine(nine.get(), SkIRect::MakeXYWH(16, 16, 32, 32),
+                              SkRect::MakeWH(32, 32), &medium);
+        sk_sp<SkPicture> ninePicture = recorder.finishRecordingAsPicture();
+        requests = SkImageDecodeAhead::FindImages(ninePicture.get(), SkMatrix::I(), clip);
+        if (requests.size() == 1) {
+            REPORTER_ASSERT(r, requests[0].fMatrix == SkMatrix::MakeScale(0.5f));
+            REPORTER_ASSERT(r, requests[0].fQuality == kLow_SkFilterQuality);
+        } else {
+            ERRORF(r, "Nine patch image not found.");
+        }
+        REPORTER_ASSERT(r, SkImageDecodeAhead::DecodePicture(ninePicture.get(), SkMatrix::I(),
+                                                             clip, executor.get()) == 1);
+        REPORTER_ASSERT(r, is_decoded(nine.get()) && !has_mipmaps(nine.get()));
+
+        // Raster images are not lazy, so there is nothing to decode ahead.
+        SkImageDecodeAhead::Request request;
+        request.fImage = plain->makeRasterImage();
+        REPORTER_ASSERT(r, SkImageDecodeAhead::Decode(&request, 1, executor.get()) == 0);
+    }
+}
@@ -68,3 +68,22 @@ DEF_TEST(LRUCacheRandom, r) {
     }
     REPORTER_ASSERT(r, 0 == instances);
 }
+
+DEF_TEST(LRUCacheRemoveLRU, r) {
+    int instances = 0;
+    {
+        SkLRUCache<int, std::unique_ptr<Value>> test(10);
+        REPORTER_ASSERT(r, !test.lru());
+        test.removeLRU();
+        for (int i = 0; i < 5; i++) {
+            test.insert(i, std::unique_ptr<Value>(new Value(i, &instances)));
+        }
+        REPORTER_ASSERT(r, test.find(0));
+        REPORTER_ASSERT(r, 1 == (*test.lru())->fValue);
+        test.removeLRU();
+        REPORTER_ASSERT(r, 4 == instances);
+        REPORTER_ASSERT(r, !test.find(1));
+        REPORTER_ASSERT(r, 2 == (*test.lru())->fValue);
+    }
+    REPORTER_ASSERT(r, 0 == instances);
+}
@@ -0,0 +1,124 @@
+/*
+ * Copyright 2020 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkBBHFactory.h"
+#include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkData.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkPath.h"
+#include "include/core/SkPictureRecorder.h"
+#include "src/core/SkPictureDelta.h"
+#include "tests/Test.h"
+
+static constexpr int W = 256, H = 256;
+
+// Records a frame of 'count' rows; row 'changed' (if any) is drawn in a different color.
+static sk_sp<SkPicture> make_frame(int count, int changed, bool withBBH = true) {
+    SkRTreeFactory factory;
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(W, H, withBBH ? &factory : nullptr);
+    for (int i = 0; i < count; i++) {
+        SkPaint paint;
+        paint.setColor(i == changed ? SK_ColorRED : SK_ColorBLUE);
+
+        canvas->save();
+            canvas->translate(0, 10.0f * i);
+            canvas->clipRect(SkRect::MakeWH(W, 10));
+            SkPath path;
+            path.addCircle(5, 5, 4);
+            canvas->drawPath(path, paint);
+            canvas->drawRect(SkRect::MakeXYWH(20, 2, 100, 6), paint);
+        canvas->restore();
+    }
+    return recorder.finishRecordingAsPicture();
+}
+
+static SkBitmap draw(const SkPicture& picture) {
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(W, H);
+    bitmap.eraseColor(SK_ColorWHITE);
+    SkCanvas canvas(bitmap);
+    canvas.drawPicture(&picture);
+    return bitmap;
+}
+
+static bool same_pixels(const SkBitmap& a, const SkBitmap& b) {
+    return 0 == memcmp(a.getPixels(), b.getPixels(), a.computeByteSize());
+}
+
+DEF_TEST(PictureDelta_Empty, r) {
+    sk_sp<SkPicture> a = make_frame(10, -1),
+                     b = make_frame(10, -1);
+
+    // Separately recorded but identical frames produce an empty delta.
+    sk_sp<SkPictureDelta> delta = SkPictureDelta::Make(*a, *b);
+    REPORTER_ASSERT(r, delta->isEmpty());
+    REPORTER_ASSERT(r, delta->invalidBounds().isEmpty());
+
+    sk_sp<SkPicture> c = delta->apply(*a);
+    REPORTER_ASSERT(r, c && same_pixels(draw(*c), draw(*b)));
+}
+
+DEF_TEST(PictureDelta_ChangedOp, r) {
+    sk_sp<SkPicture> a = make_frame(10, -1),
+                     b = make_frame(10, 3);
+
+    sk_sp<SkPictureDelta> delta = SkPictureDelta::Make(*a, *b);
+    REPORTER_ASSERT(r, delta->hunkCount() == 1);
+
+    // Only the two draws of row 3 changed, and they share a save block.
+    const SkPictureDelta::Hunk& hunk = delta->hunk(0);
+    REPORTER_ASSERT(r, hunk.fBaseCount == hunk.fTargetCount);
+    REPORTER_ASSERT(r, hunk.fTargetCount < 6);
+    REPORTER_ASSERT(r, SkRect::MakeXYWH(0, 30, W, 10).contains(delta->invalidBounds()));
+
+    sk_sp<SkPicture> c = delta->apply(*a);
+    REPORTER_ASSERT(r, c && same_pixels(draw(*c), draw(*b)));
+}
+
+DEF_TEST(PictureDelta_InsertAndRemove, r) {
+    for (auto [before, after] : {std::make_pair(10, 12), std::make_pair(12, 10),
+                                 std::make_pair(0, 4), std::make_pair(4, 0)}) {
+        sk_sp<SkPicture> a = make_frame(before, -1, false),
+                         b = make_frame(after,  1, false);
+
+        sk_sp<SkPictureDelta> delta = SkPictureDelta::Make(*a, *b);
+        REPORTER_ASSERT(r, !delta->isEmpty());
+
+        sk_sp<SkPicture> c = delta->apply(*a);
+        REPORTER_ASSERT(r, c && same_pixels(draw(*c), draw(*b)));
+    }
+}
+
+DEF_TEST(PictureDelta_Serialize, r) {
+    sk_sp<SkPicture> a = make_frame(20, -1),
+                     b = make_frame(20, 7);
+
+    sk_sp<SkData> data = SkPictureDelta::Make(*a, *b)->serialize();
+    REPORTER_ASSERT(r, data && data->size() > 0);
+
+    sk_sp<SkPictureDelta> delta = SkPictureDelta::MakeFromData(data->data(), data->size());
+    REPORTER_ASSERT(r, delta);
+    if (!delta) {
+        return;
+    }
+
+    sk_sp<SkPicture> c = delta->apply(*a);
+    REPORTER_ASSERT(r, c && same_pixels(draw(*c), draw(*b)));
+
+    // Truncated data must be rejected.
+    REPORTER_ASSERT(r, !SkPictureDelta::MakeFromData(data->data(), SkAlign4(data->size() / 2)));
+}
+
+DEF_TEST(PictureDelta_WrongBase, r) {
+    sk_sp<SkPicture> a = make_frame(10, -1),
+                     b = make_frame(10,  3),
+                     other = make_frame(11, -1);
+
+    REPORTER_ASSERT(r, !SkPictureDelta::Make(*a, *b)->apply(*other));
+}
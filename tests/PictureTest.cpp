@@ -11,6 +11,7 @@
 #include "include/core/SkClipOp.h"
 #include "include/core/SkColor.h"
 #include "include/core/SkData.h"
+#include "include/core/SkFont.h"
 #include "include/core/SkFontStyle.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkMatrix.h"
@@ -23,8 +24,10 @@
 #include "include/core/SkScalar.h"
 #include "include/core/SkShader.h"
 #include "include/core/SkStream.h"
+#include "include/core/SkTextBlob.h"
 #include "include/core/SkTypeface.h"
 #include "include/core/SkTypes.h"
+#include "include/core/SkVertices.h"
 #include "include/utils/SkRandom.h"
 #include "src/core/SkBBoxHierarchy.h"
 #include "src/core/SkBigPicture.h"
@@ -979,3 +982,41 @@ DEF_TEST(Picture_fillsBBH, r) {
                         "results.count() == %d, want %d\n", results.count(), n);
     }
 }
+
+DEF_TEST(Picture_dedupsContentOnSerialize, r) {
+    // Draw content that is equal, but rebuilt from scratch each time, 'n' times.
+    auto serialize = [](int n) {
+        SkPictureRecorder rec;
+        SkCanvas* c = rec.beginRecording(100, 100);
+        for (int i = 0; i < n; i++) {
+            SkPath path;
+            path.moveTo(0, 0);
+            for (int j = 0; j < 100; j++) {
+                path.lineTo(j, j % 7);
+            }
+            SkPaint paint;
+            paint.setColor(SK_ColorRED);
+            paint.setAntiAlias(true);
+            c->drawPath(path, paint);
+
+            SkPoint pts[] = {{0, 0}, {50, 0}, {0, 50}, {50, 50}, {25, 75}, {75, 25}};
+            c->drawVertices(SkVertices::MakeCopy(SkVertices::kTriangles_VertexMode,
+                                                 SK_ARRAY_COUNT(pts), pts, nullptr, nullptr),
+                            SkBlendMode::kSrcOver, paint);
+
+            c->drawTextBlob(SkTextBlob::MakeFromString("Dedup me, dedup me, dedup me!", SkFont()),
+                            10, 10, paint);
+        }
+        return rec.finishRecordingAsPicture()->serialize();
+    };
+
+    sk_sp<SkData> one = serialize(1),
+                  many = serialize(50);
+
+    // Each repeat should only cost its ops, not another copy of the path, paint, blob or vertices.
+    REPORTER_ASSERT(r, many->size() < one->size() + 49 * 100,
+                    "one: %zu bytes, many: %zu bytes", one->size(), many->size());
+
+    sk_sp<SkPicture> pic = SkPicture::MakeFromData(many.get());
+    REPORTER_ASSERT(r, pic && pic->approximateOpCount() == 150);
+}
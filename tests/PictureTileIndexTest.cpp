@@ -0,0 +1,106 @@
+/*
+ * Copyright 2020 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkBBHFactory.h"
+#include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkPictureRecorder.h"
+#include "src/core/SkPictureTileIndex.h"
+#include "tests/Test.h"
+
+static constexpr int W = 256, H = 256;
+
+static sk_sp<SkPicture> make_picture() {
+    SkRTreeFactory factory;
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(W, H, &factory);
+    SkPaint paint;
+    for (int y = 0; y < H; y += 16) {
+        for (int x = 0; x < W; x += 16) {
+            paint.setColor(SkColorSetRGB(x, y, 128));
+            canvas->save();
+                canvas->translate(x, y);
+                canvas->clipRect(SkRect::MakeWH(12, 12));
+                canvas->drawCircle(6, 6, 8, paint);
+            canvas->restore();
+        }
+    }
+    // One op that spans every tile.
+    paint.setColor(0x40000000);
+    canvas->drawRect(SkRect::MakeXYWH(0, 100, W, 20), paint);
+    return recorder.finishRecordingAsPicture();
+}
+
+// Draws the tile at (left, top) into bitmap, either with the index or as a plain picture.
+static void draw_tile(SkBitmap* bitmap, const SkPictureTileIndex* index, const SkPicture* picture,
+                      const SkIRect& tile) {
+    bitmap->eraseColor(SK_ColorWHITE);
+    SkCanvas canvas(*bitmap);
+    canvas.translate(-tile.fLeft, -tile.fTop);
+    canvas.clipRect(SkRect::Make(tile));
+    if (index) {
+        index->playback(&canvas);
+    } else {
+        canvas.drawPicture(picture);
+    }
+}
+
+DEF_TEST(PictureTileIndex_MatchesBBH, r) {
+    sk_sp<SkPicture> picture = make_picture();
+    sk_sp<SkPictureTileIndex> index =
+            SkPictureTileIndex::Make(picture, SkIRect::MakeWH(W, H), {64, 64});
+    REPORTER_ASSERT(r, index);
+    REPORTER_ASSERT(r, index->columns() == 4 && index->rows() == 4);
+
+    SkBitmap expected, actual;
+    expected.allocN32Pixels(64, 64);
+    actual.allocN32Pixels(64, 64);
+    for (int row = 0; row < index->rows(); row++) {
+        for (int column = 0; column < index->columns(); column++) {
+            // Each tile only lists the ops near it.
+            REPORTER_ASSERT(r, index->opCount(column, row) > 0);
+            REPORTER_ASSERT(r, index->opCount(column, row) < picture->approximateOpCount() / 4);
+
+            SkIRect tile = index->tileRect(column, row);
+            draw_tile(&expected, nullptr, picture.get(), tile);
+            draw_tile(&actual, index.get(), nullptr, tile);
+            REPORTER_ASSERT(r, 0 == memcmp(expected.getPixels(), actual.getPixels(),
+                                           expected.computeByteSize()));
+        }
+    }
+}
+
+DEF_TEST(PictureTileIndex_PartialTiles, r) {
+    sk_sp<SkPicture> picture = make_picture();
+    sk_sp<SkPictureTileIndex> index =
+            SkPictureTileIndex::Make(picture, SkIRect::MakeXYWH(8, 8, 200, 200), {64, 64});
+    REPORTER_ASSERT(r, index->columns() == 4 && index->rows() == 4);
+    REPORTER_ASSERT(r, index->tileRect(3, 3) == SkIRect::MakeLTRB(200, 200, 208, 208));
+
+    // A query that straddles tiles falls back to the picture, and still draws the same.
+    SkBitmap expected, actual;
+    expected.allocN32Pixels(64, 64);
+    actual.allocN32Pixels(64, 64);
+    SkIRect straddle = SkIRect::MakeXYWH(40, 40, 64, 64);
+    draw_tile(&expected, nullptr, picture.get(), straddle);
+    draw_tile(&actual, index.get(), nullptr, straddle);
+    REPORTER_ASSERT(r, 0 == memcmp(expected.getPixels(), actual.getPixels(),
+                                   expected.computeByteSize()));
+
+    REPORTER_ASSERT(r, !SkPictureTileIndex::Make(picture, SkIRect::MakeEmpty(), {64, 64}));
+    REPORTER_ASSERT(r, !SkPictureTileIndex::Make(picture, SkIRect::MakeWH(W, H), {0, 64}));
+
+    // Rounding the tile count up, or stepping to the last tile's right edge, must not overflow.
+    index = SkPictureTileIndex::Make(picture, SkIRect::MakeLTRB(0, 0, SK_MaxS32, 1), {1 << 30, 1});
+    if (index) {
+        REPORTER_ASSERT(r, index->columns() == 2 && index->rows() == 1);
+        REPORTER_ASSERT(r, index->tileRect(1, 0) == SkIRect::MakeLTRB(1 << 30, 0, SK_MaxS32, 1));
+    } else {
+        ERRORF(r, "Could not index a wide grid.");
+    }
+}
@@ -16,6 +16,7 @@
 #include "tools/Resources.h"
 
 #include <cstdint>
+#include <cstring>
 #include <memory>
 
 namespace {
@@ -125,6 +126,54 @@ SHAPER_TEST(tibetan)
 SHAPER_TEST(tifnagh)
 SHAPER_TEST(vai)
 
+#ifdef SK_SHAPER_HARFBUZZ_AVAILABLE
+DEF_TEST(Shaper_cache, r) {
+    auto shaper = SkShaper::MakeShapeThenWrap();
+    if (!shaper) {
+        ERRORF(r, "Could not create shaper.");
+        return;
+    }
+    const char text[] = "Shaped text is cached.";
+    SkFont font(SkTypeface::MakeDefault());
+    auto shape = [&](RunHandler* rh) {
+        shaper->shape(text, strlen(text), font, true, 400, rh);
+    };
+
+    SkShaper::PurgeShapingCache();
+    RunHandler first("cache", r);
+    shape(&first);
+    SkShaper::ShapingCacheStats stats = SkShaper::GetShapingCacheStats();
+    REPORTER_ASSERT(r, stats.fRunCount >= 1);
+    REPORTER_ASSERT(r, stats.fBytesUsed > 0);
+
+    RunHandler second("cache", r);
+    shape(&second);
+    // Other tests may be shaping at the same time.
+    REPORTER_ASSERT(r, SkShaper::GetShapingCacheStats().fHits >= stats.fHits + 1);
+    REPORTER_ASSERT(r, first.fGlyphCount == second.fGlyphCount);
+    for (unsigned i = 0; i < first.fGlyphCount; ++i) {
+        REPORTER_ASSERT(r, first.fGlyphs[i] == second.fGlyphs[i]);
+        REPORTER_ASSERT(r, first.fPositions[i] == second.fPositions[i]);
+        REPORTER_ASSERT(r, first.fClusters[i] == second.fClusters[i]);
+    }
+
+    // Another font is another run.
+    font.setSize(font.getSize() * 2);
+    stats = SkShaper::GetShapingCacheStats();
+    RunHandler bigger("cache", r);
+    shape(&bigger);
+    REPORTER_ASSERT(r, SkShaper::GetShapingCacheStats().fMisses >= stats.fMisses + 1);
+
+    // With no room, nothing is cached.
+    size_t limit = SkShaper::SetShapingCacheLimit(0);
+    REPORTER_ASSERT(r, SkShaper::GetShapingCacheStats().fRunCount == 0);
+    REPORTER_ASSERT(r, SkShaper::GetShapingCacheStats().fBytesUsed == 0);
+    shape(&bigger);
+    REPORTER_ASSERT(r, SkShaper::GetShapingCacheStats().fRunCount == 0);
+    SkShaper::SetShapingCacheLimit(limit);
+}
+#endif
+
 // TODO(bungeman): fix these broken tests. (https://bugs.skia.org/9050)
 //SHAPER_TEST(bengali)
 //SHAPER_TEST(devanagari)
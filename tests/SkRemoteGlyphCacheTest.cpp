@@ -1049,3 +1049,176 @@ DEF_TEST(SkRemoteGlyphCache_ReWriteGlyph, reporter) {
     // Must unlock everything on termination, otherwise valgrind complains about memory leaks.
     discardableManager->unlockAndDeleteAll();
 }
+
+// Sends glyphs 1 to 9 from a server using memory, if any, as its glyph image arena to a client
+// using arena, and collects the client's glyphs and the server's arena misses. Returns the size of
+// the strike data, or 0 if the client could not read it.
+static size_t send_glyphs_with_arena(SkStrikeCache* clientCache, void* memory, size_t memorySize,
+                                     sk_sp<SkData> arena, std::vector<const SkGlyph*>* glyphs,
+                                     int* misses = nullptr) {
+    sk_sp<DiscardableManager> discardableManager = sk_make_sp<DiscardableManager>();
+    SkStrikeServer server(discardableManager.get());
+    server.setGlyphImageArena(memory, memorySize);
+    SkStrikeClient client(discardableManager, false, clientCache, std::move(arena));
+
+    auto serverTf = SkTypeface::MakeFromName("monospace", SkFontStyle());
+    auto tfData = server.serializeTypeface(serverTf.get());
+    auto clientTf = client.deserializeTypeface(tfData->data(), tfData->size());
+
+    SkFont font(serverTf, 24);
+    font.setEdging(SkFont::Edging::kAntiAlias);
+    SkPaint paint;
+    SkScalerContextFlags flags = SkScalerContextFlags::kFakeGammaAndBoostContrast;
+    SkScalerContextEffects effects;
+    auto* remoteStrike = server.getOrCreateCache(
+            paint, font, SkSurfacePropsCopyOrDefault(nullptr), SkMatrix::I(), flags, &effects);
+
+    SkGlyphID glyphIDs[] = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+    SkPoint positions[SK_ARRAY_COUNT(glyphIDs)];
+    for (size_t i = 0; i < SK_ARRAY_COUNT(glyphIDs); i++) {
+        positions[i] = {i * 24.0f, 24};
+    }
+    SkZip<const SkGlyphID, const SkPoint> source{SK_ARRAY_COUNT(glyphIDs), glyphIDs, positions};
+    SkSourceGlyphBuffer rejects;
+    SkDrawableGlyphBuffer drawables;
+    drawables.ensureSize(source.size());
+    rejects.setSource(source);
+    drawables.startSource(rejects.source(), {0, 0});
+    SkStrikeServer::AddGlyphForTesting(remoteStrike, &drawables, &rejects);
+
+    std::vector<uint8_t> serverStrikeData;
+    server.writeStrikeData(&serverStrikeData);
+    bool read = client.readStrikeData(serverStrikeData.data(), serverStrikeData.size());
+    if (misses) {
+        *misses = server.glyphImageArenaMisses();
+    }
+
+    if (read) {
+        SkAutoDescriptor ad;
+        SkScalerContextRec rec;
+        font.setTypeface(clientTf);
+        SkScalerContext::MakeRecAndEffects(
+                font, paint, SkSurfacePropsCopyOrDefault(nullptr), flags,
+                SkMatrix::I(), &rec, &effects);
+        auto desc = SkScalerContext::AutoDescriptorGivenRecAndEffects(rec, effects, &ad);
+        auto strike = clientCache->findStrikeExclusive(*desc);
+        for (SkGlyphID glyphID : glyphIDs) {
+            glyphs->push_back(strike ? strike->glyphOrNull(SkPackedGlyphID{glyphID}) : nullptr);
+        }
+    }
+
+    discardableManager->unlockAndDeleteAll();
+    return read ? serverStrikeData.size() : 0;
+}
+
+DEF_TEST(SkRemoteGlyphCache_SharedGlyphImages, reporter) {
+    SkStrikeCache copiedCache;
+    std::vector<const SkGlyph*> copied;
+    size_t copiedSize = send_glyphs_with_arena(&copiedCache, nullptr, 0, nullptr, &copied);
+    REPORTER_ASSERT(reporter, copiedSize > 0);
+
+    // With an arena, the images are used in place rather than sent in the strike data, but are
+    // accounted for the same.
+    constexpr size_t kArenaSize = 1 << 16;
+    sk_sp<SkData> arena = SkData::MakeUninitialized(kArenaSize);
+    char* memory = static_cast<char*>(arena->writable_data());
+    SkStrikeCache sharedCache;
+    std::vector<const SkGlyph*> shared;
+    int misses;
+    size_t sharedSize =
+            send_glyphs_with_arena(&sharedCache, memory, kArenaSize, arena, &shared, &misses);
+    REPORTER_ASSERT(reporter, sharedSize > 0 && sharedSize < copiedSize);
+    REPORTER_ASSERT(reporter, misses == 0);
+    REPORTER_ASSERT(reporter,
+                    sharedCache.getTotalMemoryUsed() == copiedCache.getTotalMemoryUsed());
+    sharedCache.validateGlyphCacheDataSize();
+
+    REPORTER_ASSERT(reporter, shared.size() == copied.size());
+    for (size_t i = 0; i < shared.size() && i < copied.size(); i++) {
+        if (!shared[i] || !copied[i]) {
+            ERRORF(reporter, "glyph %d was not sent", (int)i + 1);
+            continue;
+        }
+        REPORTER_ASSERT(reporter, shared[i]->imageSize() == copied[i]->imageSize());
+        if (const char* image = static_cast<const char*>(shared[i]->image())) {
+            REPORTER_ASSERT(reporter, image >= memory && image < memory + kArenaSize);
+            REPORTER_ASSERT(reporter,
+                            0 == memcmp(image, copied[i]->image(), copied[i]->imageSize()));
+        }
+    }
+
+    // Once the arena is full, images are sent in the strike data again, and counted as misses.
+    SkStrikeCache fullCache;
+    std::vector<const SkGlyph*> full;
+    size_t fullSize = send_glyphs_with_arena(&fullCache, memory, 64, arena, &full, &misses);
+    REPORTER_ASSERT(reporter, fullSize > sharedSize);
+    REPORTER_ASSERT(reporter, misses > 0);
+    REPORTER_ASSERT(reporter, fullCache.getTotalMemoryUsed() == copiedCache.getTotalMemoryUsed());
+    for (size_t i = 0; i < full.size() && i < copied.size(); i++) {
+        REPORTER_ASSERT(reporter, full[i] && full[i]->imageSize() == copied[i]->imageSize());
+    }
+}
+
+#if defined(SK_BUILD_FOR_UNIX) || defined(SK_BUILD_FOR_MAC)
+#include "src/utils/SkOSPath.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+// The server and client map a shared file separately, as two processes would, and the client's
+// mapping is read-only. Both stay in this process: DM runs tests on many threads, and forking a
+// process with other threads running (which may hold malloc's or Skia's locks) is not safe.
+DEF_TEST(SkRemoteGlyphCache_SharedGlyphImagesMapped, reporter) {
+    SkString tmpDir = skiatest::GetTmpDir();
+    if (tmpDir.isEmpty()) {
+        return;
+    }
+    constexpr size_t kArenaSize = 1 << 16;
+    SkString path = SkOSPath::Join(tmpDir.c_str(), "SkRemoteGlyphCache_arena");
+    int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+    if (fd < 0) {
+        ERRORF(reporter, "Could not create %s.", path.c_str());
+        return;
+    }
+    void* serverMemory = MAP_FAILED;
+    void* clientMemory = MAP_FAILED;
+    if (ftruncate(fd, kArenaSize) == 0) {
+        serverMemory = mmap(nullptr, kArenaSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        clientMemory = mmap(nullptr, kArenaSize, PROT_READ, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    remove(path.c_str());
+    if (serverMemory == MAP_FAILED || clientMemory == MAP_FAILED) {
+        ERRORF(reporter, "Could not map %s.", path.c_str());
+        return;
+    }
+    sk_sp<SkData> clientArena = SkData::MakeWithProc(
+            clientMemory, kArenaSize,
+            [](const void* ptr, void*) { munmap(const_cast<void*>(ptr), kArenaSize); }, nullptr);
+
+    SkStrikeCache copiedCache;
+    std::vector<const SkGlyph*> copied;
+    REPORTER_ASSERT(reporter, send_glyphs_with_arena(&copiedCache, nullptr, 0, nullptr, &copied));
+
+    SkStrikeCache sharedCache;
+    std::vector<const SkGlyph*> shared;
+    REPORTER_ASSERT(reporter, send_glyphs_with_arena(&sharedCache, serverMemory, kArenaSize,
+                                                     clientArena, &shared));
+    REPORTER_ASSERT(reporter, shared.size() == copied.size());
+    const char* clientBytes = static_cast<const char*>(clientMemory);
+    for (size_t i = 0; i < shared.size() && i < copied.size(); i++) {
+        if (!shared[i] || !copied[i]) {
+            ERRORF(reporter, "glyph %d was not sent", (int)i + 1);
+            continue;
+        }
+        if (const char* image = static_cast<const char*>(shared[i]->image())) {
+            // The client reads the server's pixels through its own mapping.
+            REPORTER_ASSERT(reporter, image >= clientBytes && image < clientBytes + kArenaSize);
+            REPORTER_ASSERT(reporter,
+                            0 == memcmp(image, copied[i]->image(), copied[i]->imageSize()));
+        }
+    }
+    munmap(serverMemory, kArenaSize);
+}
+#endif
@@ -0,0 +1,208 @@
+/*
+ * Copyright 2020 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkFont.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkPath.h"
+#include "include/core/SkStream.h"
+#include "include/core/SkSurfaceProps.h"
+#include "src/core/SkGlyphDiskCache.h"
+#include "src/core/SkOSFile.h"
+#include "src/core/SkStrikeCache.h"
+#include "src/core/SkStrikeSpec.h"
+#include "src/core/SkTaskGroup.h"
+#include "src/utils/SkOSPath.h"
+#include "tests/Test.h"
+#include "tools/Resources.h"
+#include "tools/ToolUtils.h"
+
+#include <vector>
+
+static std::vector<SkStrikeSpec> make_specs(int count) {
+    SkFont font(ToolUtils::create_portable_typeface());
+    std::vector<SkStrikeSpec> specs;
+    for (int i = 0; i < count; i++) {
+        font.setSize(8 + i);
+        specs.push_back(SkStrikeSpec::MakeMask(
+                font, SkPaint(), SkSurfaceProps(0, kUnknown_SkPixelGeometry),
+                SkScalerContextFlags::kNone, SkMatrix::I()));
+    }
+    return specs;
+}
+
+DEF_TEST(SkStrikeCache_FindAndPurge, reporter) {
+    SkStrikeCache cache;
+    std::vector<SkStrikeSpec> specs = make_specs(64);
+
+    std::vector<SkStrike*> strikes;
+    for (const SkStrikeSpec& spec : specs) {
+        strikes.push_back(spec.findOrCreateExclusiveStrike(&cache).get());
+    }
+    REPORTER_ASSERT(reporter, cache.getCacheCountUsed() == 64);
+    for (size_t i = 0; i < specs.size(); i++) {
+        REPORTER_ASSERT(reporter,
+                        cache.findStrikeExclusive(specs[i].descriptor()).get() == strikes[i]);
+    }
+
+    // The least recently used strikes are purged first, whichever shard they are in.
+    cache.setCacheCountLimit(16);
+    REPORTER_ASSERT(reporter, cache.getCacheCountUsed() <= 16);
+    for (size_t i = 0; i < specs.size(); i++) {
+        bool found = (bool)cache.findStrikeExclusive(specs[i].descriptor());
+        REPORTER_ASSERT(reporter, found == (i >= specs.size() - cache.getCacheCountUsed()));
+    }
+
+    cache.purgeAll();
+    REPORTER_ASSERT(reporter, cache.getCacheCountUsed() == 0);
+    REPORTER_ASSERT(reporter, cache.getTotalMemoryUsed() == 0);
+}
+
+DEF_TEST(SkStrikeCache_Duplicates, reporter) {
+    SkStrikeCache cache;
+    const SkStrikeSpec spec = make_specs(1)[0];
+
+    // Two users asking for the same strike at once each get their own.
+    SkStrike* first;
+    SkStrike* second;
+    {
+        SkExclusiveStrikePtr a = spec.findOrCreateExclusiveStrike(&cache),
+                             b = spec.findOrCreateExclusiveStrike(&cache);
+        first = a.get();
+        second = b.get();
+        REPORTER_ASSERT(reporter, first != second);
+    }
+    REPORTER_ASSERT(reporter, cache.getCacheCountUsed() == 2);
+
+    // Both can be found again, most recently returned first.
+    SkExclusiveStrikePtr a = cache.findStrikeExclusive(spec.descriptor()),
+                         b = cache.findStrikeExclusive(spec.descriptor());
+    REPORTER_ASSERT(reporter, a.get() == first);
+    REPORTER_ASSERT(reporter, b.get() == second);
+    REPORTER_ASSERT(reporter, !cache.findStrikeExclusive(spec.descriptor()));
+}
+
+DEF_TEST(SkStrikeCache_Threaded, reporter) {
+    SkStrikeCache cache;
+    cache.setCacheCountLimit(32);
+    std::vector<SkStrikeSpec> specs = make_specs(64);
+
+    const SkGlyphID glyphs[] = {1, 2, 3, 4, 5, 6, 7, 8};
+    SkTaskGroup().batch(256, [&](int i) {
+        const SkStrikeSpec& spec = specs[(i * 7) % specs.size()];
+        SkExclusiveStrikePtr strike = spec.findOrCreateExclusiveStrike(&cache);
+        const SkGlyph* results[SK_ARRAY_COUNT(glyphs)];
+        (void)strike->metrics(SkMakeSpan(glyphs), results);
+    });
+
+    REPORTER_ASSERT(reporter, cache.getCacheCountUsed() <= 32);
+    cache.purgeAll();
+    REPORTER_ASSERT(reporter, cache.getCacheCountUsed() == 0);
+    REPORTER_ASSERT(reporter, cache.getTotalMemoryUsed() == 0);
+}
+
+DEF_TEST(SkStrikeCache_DiskCache, reporter) {
+    SkString tmpDir = skiatest::GetTmpDir();
+    sk_sp<SkTypeface> typeface = MakeResourceAsTypeface("fonts/Em.ttf");
+    if (tmpDir.isEmpty() || !typeface) {
+        return;
+    }
+    SkString dir = SkOSPath::Join(tmpDir.c_str(), "SkStrikeCache_DiskCache");
+    sk_mkdir(dir.c_str());
+    SkGlyphDiskCache diskCache(dir.c_str(), 1 << 20);
+
+    auto spec_for = [](sk_sp<SkTypeface> typeface) {
+        SkFont font(std::move(typeface), 24);
+        return SkStrikeSpec::MakeMask(font, SkPaint(), SkSurfaceProps(0, kUnknown_SkPixelGeometry),
+                                      SkScalerContextFlags::kNone, SkMatrix::I());
+    };
+    const SkPackedGlyphID ids[] = {SkPackedGlyphID{(SkGlyphID)1}, SkPackedGlyphID{(SkGlyphID)2},
+                                   SkPackedGlyphID{(SkGlyphID)3}};
+    const SkGlyphID pathIDs[] = {1, 4};
+    const SkGlyph* images[SK_ARRAY_COUNT(ids)];
+    const SkGlyph* paths[SK_ARRAY_COUNT(pathIDs)];
+
+    SkStrikeCache cache;
+    SkExclusiveStrikePtr original = spec_for(typeface).findOrCreateExclusiveStrike(&cache);
+    original->prepareImages(SkMakeSpan(ids), images);
+    original->preparePaths(SkMakeSpan(pathIDs), paths);
+    REPORTER_ASSERT(reporter, original->hasUnsavedGlyphs());
+    REPORTER_ASSERT(reporter, diskCache.save(*original));
+    diskCache.purge();
+
+    // Another typeface for the same font, as another process would have, finds the glyphs.
+    sk_sp<SkTypeface> again = MakeResourceAsTypeface("fonts/Em.ttf");
+    REPORTER_ASSERT(reporter, again->uniqueID() != typeface->uniqueID());
+    SkStrikeSpec spec = spec_for(again);
+    sk_sp<SkGlyphDiskCache::Entry> entry = diskCache.find(spec.descriptor(), *again);
+    REPORTER_ASSERT(reporter, entry);
+
+    // Strikes find their files on the disk cache's thread.
+    SkStrikeCache otherCache;
+    SkExclusiveStrikePtr restored = spec.findOrCreateExclusiveStrike(&otherCache);
+    restored->setDiskCacheLookup(diskCache.findLater(spec.descriptor(), *again));
+    diskCache.flush();
+    REPORTER_ASSERT(reporter, restored->diskCacheEntry());
+    const SkGlyph* restoredImages[SK_ARRAY_COUNT(ids)];
+    const SkGlyph* restoredPaths[SK_ARRAY_COUNT(pathIDs)];
+    restored->prepareImages(SkMakeSpan(ids), restoredImages);
+    restored->preparePaths(SkMakeSpan(pathIDs), restoredPaths);
+    REPORTER_ASSERT(reporter, !restored->hasUnsavedGlyphs());
+
+    for (size_t i = 0; i < SK_ARRAY_COUNT(ids); i++) {
+        const SkGlyph& a = *images[i];
+        const SkGlyph& b = *restoredImages[i];
+        REPORTER_ASSERT(reporter, a.iRect() == b.iRect());
+        REPORTER_ASSERT(reporter, a.advanceX() == b.advanceX());
+        REPORTER_ASSERT(reporter, a.maskFormat() == b.maskFormat());
+        REPORTER_ASSERT(reporter, (a.image() == nullptr) == (b.image() == nullptr));
+        if (a.image()) {
+            REPORTER_ASSERT(reporter, 0 == memcmp(a.image(), b.image(), a.imageSize()));
+        }
+    }
+    for (size_t i = 0; i < SK_ARRAY_COUNT(pathIDs); i++) {
+        const SkPath* a = paths[i]->path();
+        const SkPath* b = restoredPaths[i]->path();
+        REPORTER_ASSERT(reporter, (a == nullptr) == (b == nullptr));
+        REPORTER_ASSERT(reporter, !a || *a == *b);
+    }
+
+    // A glyph that wasn't saved still comes from the scaler.
+    const SkGlyphID unsaved[] = {5};
+    const SkGlyph* unsavedGlyph[1];
+    restored->metrics(SkMakeSpan(unsaved), unsavedGlyph);
+    REPORTER_ASSERT(reporter, restored->hasUnsavedGlyphs());
+
+    // Other strikes are not found.
+    SkFont font(again, 25);
+    SkStrikeSpec otherSize = SkStrikeSpec::MakeMask(
+            font, SkPaint(), SkSurfaceProps(0, kUnknown_SkPixelGeometry),
+            SkScalerContextFlags::kNone, SkMatrix::I());
+    REPORTER_ASSERT(reporter, !diskCache.find(otherSize.descriptor(), *again));
+
+    // A file with a glyph whose mask format is out of range is rejected.
+    SkString path;
+    SkOSFile::Iter iter(dir.c_str(), ".glyphs");
+    while (iter.next(&path)) {
+        path = SkOSPath::Join(dir.c_str(), path.c_str());
+        sk_sp<SkData> data = SkData::MakeFromFileName(path.c_str());
+        if (!data || data->size() < sizeof(SkGlyphDiskCache::FileHeader)) {
+            continue;
+        }
+        SkGlyphDiskCache::FileHeader header;
+        memcpy(&header, data->data(), sizeof(header));
+        const size_t maskFormat = sizeof(header) + header.fKeySize +
+                                  offsetof(SkGlyphDiskCache::FileGlyph, fMaskFormat);
+        if (header.fGlyphCount == 0 || data->size() <= maskFormat) {
+            continue;
+        }
+        sk_sp<SkData> corrupt = SkData::MakeWithCopy(data->data(), data->size());
+        static_cast<uint8_t*>(corrupt->writable_data())[maskFormat] = 0xFF;
+        data = nullptr;  // Unmap the file before rewriting it.
+        SkFILEWStream(path.c_str()).write(corrupt->data(), corrupt->size());
+    }
+    REPORTER_ASSERT(reporter, !diskCache.find(spec.descriptor(), *again));
+}
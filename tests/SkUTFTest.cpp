@@ -4,6 +4,9 @@
 #include "src/utils/SkUTF.h"
 #include "tests/Test.h"
 
+#include <string>
+#include <vector>
+
 DEF_TEST(SkUTF_UTF16, reporter) {
     // Test non-basic-multilingual-plane unicode.
     static const SkUnichar gUni[] = {
@@ -134,6 +137,27 @@ DEF_TEST(SkUTF_NextUTF8_ToUTF8, r) {
         REPORTER_ASSERT(r, 0 == strcmp(str, buff));
     }
 }
+DEF_TEST(SkUTF_CountLongText, r) {
+    // Long runs of ASCII are counted in blocks; put other characters at every offset in them.
+    for (size_t offset = 0; offset < 40; offset++) {
+        for (const char* other : {LEADING_TWO_BYTE CONTINUATION_BYTE,
+                                  LEADING_FOUR_BYTE "\x90\x8C\xB0"}) {
+            std::string utf8 = std::string(offset, 'a') + other + std::string(40, 'b');
+            REPORTER_ASSERT(r, SkUTF::CountUTF8(utf8.data(), utf8.size()) == (int)offset + 41);
+
+            std::string invalid =
+                    std::string(offset, 'a') + CONTINUATION_BYTE + std::string(40, 'b');
+            REPORTER_ASSERT(r, SkUTF::CountUTF8(invalid.data(), invalid.size()) == -1);
+        }
+
+        std::vector<uint16_t> utf16(offset + 40, 'a');
+        utf16.insert(utf16.begin() + offset, {0xD800, 0xDC00});
+        REPORTER_ASSERT(r, SkUTF::CountUTF16(utf16.data(), utf16.size() * 2) == (int)offset + 41);
+        utf16.erase(utf16.begin() + offset + 1);
+        REPORTER_ASSERT(r, SkUTF::CountUTF16(utf16.data(), utf16.size() * 2) == -1);
+    }
+}
+
 #undef ASCII_BYTE
 #undef CONTINUATION_BYTE
 #undef LEADING_TWO_BYTE
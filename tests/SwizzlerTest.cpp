@@ -5,6 +5,7 @@
  * found in the LICENSE file.
  */
 
+#include "include/core/SkColorPriv.h"
 #include "include/core/SkSwizzle.h"
 #include "include/private/SkImageInfoPriv.h"
 #include "src/codec/SkSwizzler.h"
@@ -152,3 +153,124 @@ DEF_TEST(PublicSwizzleOpts, r) {
     SkSwapRB(&dst, &src, 1);
     REPORTER_ASSERT(r, dst == 0xFA04B0CE);
 }
+
+DEF_TEST(SwizzleOpts_16bit, r) {
+    // Enough pixels to exercise the SIMD loops and their tails.
+    const int kCount = 67;
+    uint8_t rgba16[8 * kCount], rgb16[6 * kCount], indices[kCount];
+    uint32_t rgba8[kCount], ctable[256];
+    uint8_t rgb8[3 * kCount];
+    for (int i = 0; i < 8 * kCount; i++) {
+        rgba16[i] = (i * 37 + 11) & 0xFF;
+    }
+    for (int i = 0; i < 6 * kCount; i++) {
+        rgb16[i] = (i * 53 + 7) & 0xFF;
+    }
+    for (int i = 0; i < kCount; i++) {
+        // The first, most significant byte of each component is kept.
+        rgba8[i] = rgba16[8*i + 0] <<  0 | rgba16[8*i + 2] <<  8 |
+                   rgba16[8*i + 4] << 16 | (uint32_t)rgba16[8*i + 6] << 24;
+        for (int c = 0; c < 3; c++) {
+            rgb8[3*i + c] = rgb16[6*i + 2*c];
+        }
+        indices[i] = (i * 97) & 0xFF;
+    }
+    for (int i = 0; i < 256; i++) {
+        ctable[i] = i * 0x01010101 ^ 0x00FF00FF;
+    }
+
+    for (int count : { 1, 7, 16, 33, kCount }) {
+        uint32_t dst[kCount], expected[kCount];
+        auto check = [&](const char* name) {
+            if (memcmp(dst, expected, count * sizeof(uint32_t))) {
+                ERRORF(r, "%s mismatch with %d pixels", name, count);
+            }
+        };
+
+        SkOpts::RGBA16_to_RGBA(dst, rgba16, count);
+        memcpy(expected, rgba8, count * sizeof(uint32_t));
+        check("RGBA16_to_RGBA");
+        SkOpts::RGBA16_to_BGRA(dst, rgba16, count);
+        SkOpts::RGBA_to_BGRA(expected, rgba8, count);
+        check("RGBA16_to_BGRA");
+        SkOpts::RGBA16_to_rgbA(dst, rgba16, count);
+        SkOpts::RGBA_to_rgbA(expected, rgba8, count);
+        check("RGBA16_to_rgbA");
+        SkOpts::RGBA16_to_bgrA(dst, rgba16, count);
+        SkOpts::RGBA_to_bgrA(expected, rgba8, count);
+        check("RGBA16_to_bgrA");
+
+        SkOpts::RGB16_to_RGB1(dst, rgb16, count);
+        SkOpts::RGB_to_RGB1(expected, rgb8, count);
+        check("RGB16_to_RGB1");
+        SkOpts::RGB16_to_BGR1(dst, rgb16, count);
+        SkOpts::RGB_to_BGR1(expected, rgb8, count);
+        check("RGB16_to_BGR1");
+
+        SkOpts::index_to_8888(dst, indices, count, ctable);
+        for (int i = 0; i < count; i++) {
+            expected[i] = ctable[indices[i]];
+        }
+        check("index_to_8888");
+    }
+}
+
+// Sampled swizzles must pick the same pixels, with the same results, as full width swizzles.
+DEF_TEST(SwizzlerSampled, r) {
+    const int kWidth = 50;
+    uint8_t src[8 * kWidth];
+    for (int i = 0; i < 8 * kWidth; i++) {
+        src[i] = (i * 37 + 11) & 0xFF;
+    }
+    SkPMColor ctable[256];
+    for (int i = 0; i < 256; i++) {
+        ctable[i] = SkPreMultiplyARGB(i, 255 - i, i / 2, i ^ 0x55);
+    }
+
+    struct {
+        SkEncodedInfo::Color fColor;
+        SkEncodedInfo::Alpha fAlpha;
+        int                  fBitsPerComponent;
+    } formats[] = {
+        { SkEncodedInfo::kRGBA_Color,      SkEncodedInfo::kUnpremul_Alpha, 16 },
+        { SkEncodedInfo::kRGB_Color,       SkEncodedInfo::kOpaque_Alpha,   16 },
+        { SkEncodedInfo::kRGBA_Color,      SkEncodedInfo::kUnpremul_Alpha,  8 },
+        { SkEncodedInfo::kRGB_Color,       SkEncodedInfo::kOpaque_Alpha,    8 },
+        { SkEncodedInfo::kGrayAlpha_Color, SkEncodedInfo::kUnpremul_Alpha,  8 },
+        { SkEncodedInfo::kGray_Color,      SkEncodedInfo::kOpaque_Alpha,    8 },
+        { SkEncodedInfo::kPalette_Color,   SkEncodedInfo::kUnpremul_Alpha,  8 },
+    };
+    for (const auto& format : formats) {
+        for (SkColorType ct : { kRGBA_8888_SkColorType, kBGRA_8888_SkColorType }) {
+            for (SkAlphaType at : { kPremul_SkAlphaType, kUnpremul_SkAlphaType }) {
+                auto encodedInfo = SkEncodedInfo::Make(kWidth, 1, format.fColor, format.fAlpha,
+                                                       format.fBitsPerComponent);
+                if (SkEncodedInfo::kOpaque_Alpha == format.fAlpha) {
+                    at = kOpaque_SkAlphaType;
+                }
+                auto dstInfo = SkImageInfo::Make(kWidth, 1, ct, at);
+                const SkPMColor* colors =
+                        SkEncodedInfo::kPalette_Color == format.fColor ? ctable : nullptr;
+
+                uint32_t full[kWidth], sampled[kWidth];
+                auto swizzler = SkSwizzler::Make(encodedInfo, colors, dstInfo,
+                                                 SkCodec::Options());
+                REPORTER_ASSERT(r, swizzler);
+                swizzler->swizzle(full, src);
+
+                for (int sampleX : { 2, 3, 7 }) {
+                    swizzler = SkSwizzler::Make(encodedInfo, colors, dstInfo, SkCodec::Options());
+                    int width = swizzler->setSampleX(sampleX);
+                    swizzler->swizzle(sampled, src);
+                    for (int x = 0; x < width; x++) {
+                        if (sampled[x] != full[sampleX / 2 + x * sampleX]) {
+                            ERRORF(r, "color %d bpc %d sample %d: mismatch at %d",
+                                   format.fColor, format.fBitsPerComponent, sampleX, x);
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
@@ -351,4 +351,14 @@ DEF_TEST(chartoglyph_cache, reporter) {
             REPORTER_ASSERT(reporter, (unsigned)index == glyph);
         }
     }
+
+    // Characters in and out of the BMP can be looked up together.
+    SkUnichar outside = 0x1F600;
+    cache.insertCharAndGlyph(~cache.findGlyphIndex(outside), outside, 7);
+    SkUnichar text[] = {3, 6, 300, 1500, outside, 9, 4};
+    SkGlyphID glyphs[SK_ARRAY_COUNT(text)];
+    REPORTER_ASSERT(reporter, cache.findGlyphs(text, SK_ARRAY_COUNT(text), glyphs) == 6);
+    for (int i = 0; i < 6; i++) {
+        REPORTER_ASSERT(reporter, glyphs[i] == (text[i] == outside ? 7 : hash_to_glyph(text[i])));
+    }
 }
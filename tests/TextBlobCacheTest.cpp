@@ -14,6 +14,7 @@
 #include "include/core/SkGraphics.h"
 #include "include/core/SkPaint.h"
 #include "include/core/SkPoint.h"
+#include "include/core/SkShader.h"
 #include "include/core/SkSurface.h"
 #include "include/core/SkTextBlob.h"
 #include "include/core/SkTypeface.h"
@@ -27,7 +28,14 @@
 #include "tests/Test.h"
 
 #include "include/gpu/GrContext.h"
+#include "src/gpu/GrClip.h"
 #include "src/gpu/GrContextPriv.h"
+#include "src/gpu/GrDrawingManager.h"
+#include "src/gpu/GrRenderTargetContext.h"
+#include "src/gpu/geometry/GrShape.h"
+#include "src/gpu/ops/GrAtlasTextOp.h"
+#include "src/gpu/text/GrTextContext.h"
+#include "src/gpu/text/GrTextTarget.h"
 
 static void draw(SkCanvas* canvas, int redraw, const SkTArray<sk_sp<SkTextBlob>>& blobs) {
     int yOffset = 0;
@@ -325,3 +333,80 @@ DEF_GPUTEST_FOR_RENDERING_CONTEXTS(TextBlobSmoothScroll, reporter, ctxInfo) {
         }
     }
 }
+
+// Forwards to another target, remembering the paths of the glyphs drawn as shapes.
+class PathRecordingTextTarget : public GrTextTarget {
+public:
+    PathRecordingTextTarget(GrTextTarget* target)
+            : GrTextTarget(target->width(), target->height(), target->colorInfo())
+            , fTarget(target) {}
+
+    void addDrawOp(const GrClip& clip, std::unique_ptr<GrAtlasTextOp> op) override {
+        fTarget->addDrawOp(clip, std::move(op));
+    }
+
+    void drawShape(const GrClip& clip, const SkPaint& paint,
+                   const SkMatrix& viewMatrix, const GrShape& shape) override {
+        SkPath path;
+        shape.asPath(&path);
+        fPathIDs.push_back(path.getGenerationID());
+        fTarget->drawShape(clip, paint, viewMatrix, shape);
+    }
+
+    void makeGrPaint(GrMaskFormat maskFormat, const SkPaint& skPaint, const SkMatrix& viewMatrix,
+                     GrPaint* grPaint) override {
+        fTarget->makeGrPaint(maskFormat, skPaint, viewMatrix, grPaint);
+    }
+
+    GrRecordingContext* getContext() override { return fTarget->getContext(); }
+
+    SkGlyphRunListPainter* glyphPainter() override { return fTarget->glyphPainter(); }
+
+    SkTArray<uint32_t> fPathIDs;
+
+private:
+    GrTextTarget* fTarget;
+};
+
+DEF_GPUTEST_FOR_RENDERING_CONTEXTS(TextBlobPathGlyphsReused, reporter, ctxInfo) {
+    auto grContext = ctxInfo.grContext();
+    const SkImageInfo info =
+            SkImageInfo::Make(kScreenDim, kScreenDim, kN32_SkColorType, kPremul_SkAlphaType);
+    auto surface = SkSurface::MakeRenderTarget(grContext, SkBudgeted::kNo, info);
+    GrRenderTargetContext* rtc =
+            surface->getCanvas()->internal_private_accessTopLayerRenderTargetContext();
+    GrTextContext* textContext = grContext->priv().drawingManager()->getTextContext();
+
+    // Hairline glyphs are drawn as paths, and the shader makes them be scaled into source space.
+    SkPaint paint;
+    paint.setStyle(SkPaint::kStroke_Style);
+    paint.setStrokeWidth(0);
+    paint.setShader(SkShaders::Color(SK_ColorBLACK));
+    auto blob = make_blob();
+    SkGlyphRunBuilder builder;
+    builder.textBlobToGlyphRunListIgnoringRSXForm(paint, *blob, {40, 80});
+    const SkGlyphRunList& glyphRunList = builder.useGlyphRunList();
+
+    auto draw = [&](const SkMatrix& matrix, SkBitmap* bitmap) {
+        surface->getCanvas()->drawColor(SK_ColorWHITE, SkBlendMode::kSrc);
+        PathRecordingTextTarget target(rtc->textTarget());
+        textContext->drawGlyphRunList(grContext, &target, GrNoClip(), matrix, surface->props(),
+                                      glyphRunList);
+        bitmap->allocN32Pixels(kScreenDim, kScreenDim);
+        surface->readPixels(*bitmap, 0, 0);
+        return target.fPathIDs;
+    };
+
+    // The second draw finds the blob in the cache, and draws the same source space paths.
+    SkBitmap first, second, scaled;
+    SkTArray<uint32_t> firstIDs = draw(SkMatrix::I(), &first);
+    SkTArray<uint32_t> secondIDs = draw(SkMatrix::I(), &second);
+    REPORTER_ASSERT(reporter, !firstIDs.empty());
+    REPORTER_ASSERT(reporter, firstIDs == secondIDs);
+    REPORTER_ASSERT(reporter, compare_bitmaps(first, second));
+
+    // The source space paths don't depend on the matrix either.
+    SkTArray<uint32_t> scaledIDs = draw(SkMatrix::MakeScale(1.5f), &scaled);
+    REPORTER_ASSERT(reporter, firstIDs == scaledIDs);
+    REPORTER_ASSERT(reporter, !compare_bitmaps(first, scaled));
+}
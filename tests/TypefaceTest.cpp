@@ -13,12 +13,15 @@
 #include "include/ports/SkTypeface_win.h"
 #include "include/private/SkFixed.h"
 #include "src/core/SkAdvancedTypefaceMetrics.h"
+#include "src/core/SkAutoMalloc.h"
 #include "src/core/SkFontDescriptor.h"
+#include "src/core/SkFontFileCache.h"
 #include "src/core/SkFontMgrPriv.h"
 #include "src/core/SkFontPriv.h"
 #include "src/core/SkTypefaceCache.h"
 #include "src/sfnt/SkOTTable_OS_2.h"
 #include "src/sfnt/SkSFNTHeader.h"
+#include "src/utils/SkOSPath.h"
 #include "src/utils/SkUTF.h"
 #include "tests/Test.h"
 #include "tools/Resources.h"
@@ -26,6 +29,7 @@
 #include "tools/fonts/TestEmptyTypeface.h"
 
 #include <memory>
+#include <stdio.h>
 
 static void TypefaceStyle_test(skiatest::Reporter* reporter,
                                uint16_t weight, uint16_t width, SkData* data)
@@ -305,6 +309,72 @@ DEF_TEST(TypefaceCache, reporter) {
     REPORTER_ASSERT(reporter, t1->unique());
 }
 
+DEF_TEST(Typeface_SharedFileData, reporter) {
+    SkString path = GetResourcePath("fonts/Em.ttf");
+    sk_sp<SkData> data = SkFontFileCache::Find(path.c_str());
+    if (!data) {
+        return;
+    }
+    REPORTER_ASSERT(reporter, SkFontFileCache::Find(path.c_str()) == data);
+
+    sk_sp<SkTypeface> a = SkFontMgr::RefDefault()->makeFromFile(path.c_str());
+    sk_sp<SkTypeface> b = SkFontMgr::RefDefault()->makeFromFile(path.c_str());
+    if (!a || !b) {
+        return;
+    }
+    const SkFontTableTag tags[] = { SkSetFourByteTag('h', 'e', 'a', 'd'),
+                                    SkSetFourByteTag('c', 'm', 'a', 'p'),
+                                    SkSetFourByteTag('n', 'o', 'n', 'e') };
+    int ttcIndex;
+    for (SkFontTableTag tag : tags) {
+        sk_sp<SkData> table = a->copyTableData(tag);
+        size_t size = a->getTableSize(tag);
+        REPORTER_ASSERT(reporter, (table ? table->size() : 0) == size);
+        if (table && a->openStream(&ttcIndex)->getMemoryBase() == data->data()) {
+            // Shared with the mapped file rather than copied.
+            REPORTER_ASSERT(reporter, table->bytes() >= data->bytes() &&
+                                      table->bytes() + size <= data->bytes() + data->size());
+        }
+        if (table) {
+            SkAutoMalloc copy(size);
+            REPORTER_ASSERT(reporter, b->getTableData(tag, 0, size, copy.get()) == size);
+            REPORTER_ASSERT(reporter, 0 == memcmp(table->data(), copy.get(), size));
+        }
+    }
+}
+
+static bool write_file(const SkString& path, const char contents[]) {
+    SkFILEWStream stream(path.c_str());
+    return stream.isValid() && stream.write(contents, strlen(contents));
+}
+
+DEF_TEST(Typeface_SharedFileDataReplaced, reporter) {
+    SkString tmpDir = skiatest::GetTmpDir();
+    if (tmpDir.isEmpty()) {
+        return;
+    }
+    SkString path = SkOSPath::Join(tmpDir.c_str(), "font_file_cache_test");
+    SkString replacement = SkOSPath::Join(tmpDir.c_str(), "font_file_cache_test_replacement");
+    if (!write_file(path, "first")) {
+        ERRORF(reporter, "Failed to create tmp file %s\n", path.c_str());
+        return;
+    }
+    sk_sp<SkData> first = SkFontFileCache::Find(path.c_str());
+    REPORTER_ASSERT(reporter, first && SkFontFileCache::Find(path.c_str()) == first);
+
+    // Replace the file with one of the same size, likely within the same second. Holding on to
+    // the first mapping keeps the replacement from reusing its file system object.
+    if (!write_file(replacement, "secnd") ||
+        0 != rename(replacement.c_str(), path.c_str())) {
+        return;
+    }
+    sk_sp<SkData> second = SkFontFileCache::Find(path.c_str());
+    REPORTER_ASSERT(reporter, second && second != first);
+    REPORTER_ASSERT(reporter, second && 0 == memcmp(second->data(), "secnd", 5));
+    REPORTER_ASSERT(reporter, first && 0 == memcmp(first->data(), "first", 5));
+    remove(path.c_str());
+}
+
 static void check_serialize_behaviors(sk_sp<SkTypeface> tf, bool isLocalData,
                                       skiatest::Reporter* reporter) {
     if (!tf) {
@@ -15,7 +15,8 @@
 
 static void codec_yuv(skiatest::Reporter* reporter,
                       const char path[],
-                      SkISize expectedSizes[4]) {
+                      SkISize expectedSizes[4],
+                      SkYUVColorSpace expectedColorSpace = kJPEG_SkYUVColorSpace) {
     std::unique_ptr<SkStream> stream(GetResourceAsStream(path));
     if (!stream) {
         return;
@@ -58,7 +59,7 @@ static void codec_yuv(skiatest::Reporter* reporter,
             REPORTER_ASSERT(reporter,
                             info.fWidthBytes[i] == (uint32_t) SkAlign8(info.fSizes[i].width()));
         }
-        REPORTER_ASSERT(reporter, kJPEG_SkYUVColorSpace == colorSpace);
+        REPORTER_ASSERT(reporter, expectedColorSpace == colorSpace);
     }
 
     // Allocate the memory for the YUV decode
@@ -125,6 +126,21 @@ DEF_TEST(Jpeg_YUV_Codec, r) {
     codec_yuv(r, "images/arrow.png", nullptr);
 }
 
+DEF_TEST(Webp_YUV_Codec, r) {
+    SkISize sizes[4];
+
+    sizes[0].set(800, 800);
+    sizes[1].set(400, 400);
+    sizes[2].set(400, 400);
+    sizes[3].set(0, 0);
+    codec_yuv(r, "images/webp-color-profile-lossy.webp", sizes, kRec601_SkYUVColorSpace);
+
+    // Lossless, alpha and animated images should fail.
+    codec_yuv(r, "images/webp-color-profile-lossless.webp", nullptr);
+    codec_yuv(r, "images/webp-color-profile-lossy-alpha.webp", nullptr);
+    codec_yuv(r, "images/webp-animated.webp", nullptr);
+}
+
 #include "include/effects/SkColorMatrix.h"
 #include "src/core/SkYUVMath.h"
 
@@ -164,3 +180,167 @@ DEF_TEST(YUVMath, reporter) {
         }
     }
 }
+
+#include "include/core/SkPixmap.h"
+
+// Check the vectorized conversion against the color matrix applied in float.
+DEF_TEST(YUVMath_ConvertPlanes, reporter) {
+    const int kW = 37, kH = 11;     // Odd, to exercise the SIMD tails and rounded-up chroma.
+    uint8_t planeY[kW * kH], planeU[kW * kH], planeV[kW * kH];
+    for (int i = 0; i < kW * kH; ++i) {
+        planeY[i] = (i * 37 + 11) & 0xFF;
+        planeU[i] = (i * 73 +  5) & 0xFF;
+        planeV[i] = (i * 151 + 3) & 0xFF;
+    }
+
+    for (SkColorType ct : { kRGBA_8888_SkColorType, kBGRA_8888_SkColorType }) {
+    for (SkYUVColorSpace cs : { kJPEG_SkYUVColorSpace, kRec601_SkYUVColorSpace,
+                                kRec709_SkYUVColorSpace }) {
+    for (int shift : { 0, 1 }) {
+        const int uvW = (kW + shift) >> shift,
+                  uvH = (kH + shift) >> shift;
+        SkPixmap planes[3] = {
+            { SkImageInfo::MakeA8(kW, kH),   planeY, kW },
+            { SkImageInfo::MakeA8(uvW, uvH), planeU, (size_t)uvW },
+            { SkImageInfo::MakeA8(uvW, uvH), planeV, (size_t)uvW },
+        };
+        uint32_t pixels[kW * kH];
+        SkPixmap dst(SkImageInfo::Make(kW, kH, ct, kOpaque_SkAlphaType), pixels, 4 * kW);
+        REPORTER_ASSERT(reporter, SkConvertYUV8PlanesToRGBA(planes, cs, dst));
+
+        float m[20];
+        SkColorMatrix_YUV2RGB(cs, m);
+        for (int y = 0; y < kH; ++y)
+        for (int x = 0; x < kW; ++x) {
+            float Y = planeY[y * kW + x],
+                  U = planeU[(y >> shift) * uvW + (x >> shift)],
+                  V = planeV[(y >> shift) * uvW + (x >> shift)];
+            const uint8_t* px = (const uint8_t*)(pixels + y * kW + x);
+            int r = ct == kRGBA_8888_SkColorType ? 0 : 2,
+                b = 2 - r;
+            for (int c = 0; c < 3; ++c) {
+                float expected = SkTPin(m[5*c+0]*Y + m[5*c+1]*U + m[5*c+2]*V + m[5*c+4]*255,
+                                        0.0f, 255.0f);
+                int channel = c == 0 ? r : c == 2 ? b : 1;
+                REPORTER_ASSERT(reporter, SkScalarAbs(px[channel] - expected) <= 0.51f);
+            }
+            REPORTER_ASSERT(reporter, px[3] == 0xFF);
+        }
+    }
+    }
+    }
+
+    // Chroma must match the luma size, or half of it rounded up.
+    SkPixmap planes[3] = {
+        { SkImageInfo::MakeA8(kW, kH),         planeY, kW },
+        { SkImageInfo::MakeA8(kW / 2, kH / 2), planeU, kW },
+        { SkImageInfo::MakeA8(kW / 2, kH / 2), planeV, kW },
+    };
+    uint32_t pixels[kW * kH];
+    SkPixmap dst(SkImageInfo::MakeN32Premul(kW, kH), pixels, 4 * kW);
+    REPORTER_ASSERT(reporter, !SkConvertYUV8PlanesToRGBA(planes, kJPEG_SkYUVColorSpace, dst));
+}
+
+#include "src/core/SkOpts.h"
+
+// The vectorized conversion must round halves up, like the portable one, not to even.
+DEF_TEST(YUVMath_RoundHalfUp, reporter) {
+    const int kCount = 37;
+    uint8_t planeY[kCount], planeU[kCount], planeV[kCount];
+    for (int i = 0; i < kCount; ++i) {
+        planeY[i] = 2 * i + 1;
+        planeU[i] = 2 * i + 75;
+        planeV[i] = 2 * i + 149;
+    }
+    float m[20] = {};
+    m[0] = m[6] = m[12] = 0.5f;
+
+    uint32_t pixels[kCount];
+    SkOpts::YUV_to_RGB1(pixels, planeY, planeU, planeV, kCount, 0, m);
+    for (int i = 0; i < kCount; ++i) {
+        const uint8_t* px = (const uint8_t*)(pixels + i);
+        REPORTER_ASSERT(reporter, px[0] == (planeY[i] + 1) / 2);
+        REPORTER_ASSERT(reporter, px[1] == (planeU[i] + 1) / 2);
+        REPORTER_ASSERT(reporter, px[2] == (planeV[i] + 1) / 2);
+    }
+}
+
+#include "include/core/SkBitmap.h"
+#include "include/core/SkImage.h"
+#include "include/core/SkYUVAIndex.h"
+
+DEF_TEST(YUVImage_RasterFromPixmaps, reporter) {
+    const int kW = 9, kH = 7, kUVW = 5, kUVH = 4;
+    uint8_t planeY[kW * kH], planeA[kW * kH], planeU[kUVW * kUVH], planeV[kUVW * kUVH];
+    for (int i = 0; i < kW * kH; ++i) {
+        planeY[i] = (i * 37 + 11) & 0xFF;
+        planeA[i] = (i * 19 + 7) & 0xFF;
+    }
+    for (int i = 0; i < kUVW * kUVH; ++i) {
+        planeU[i] = (i * 73 +  5) & 0xFF;
+        planeV[i] = (i * 151 + 3) & 0xFF;
+    }
+    const SkPixmap pixmaps[4] = {
+        { SkImageInfo::MakeA8(kW, kH),     planeY, kW },
+        { SkImageInfo::MakeA8(kUVW, kUVH), planeU, kUVW },
+        { SkImageInfo::MakeA8(kUVW, kUVH), planeV, kUVW },
+        { SkImageInfo::MakeA8(kW, kH),     planeA, kW },
+    };
+    SkYUVAIndex indices[4] = {
+        { 0, SkColorChannel::kA },
+        { 1, SkColorChannel::kA },
+        { 2, SkColorChannel::kA },
+        { 3, SkColorChannel::kA },
+    };
+
+    uint32_t expected[kW * kH];
+    SkPixmap expectedPixmap(SkImageInfo::Make(kW, kH, kRGBA_8888_SkColorType, kOpaque_SkAlphaType),
+                            expected, 4 * kW);
+    REPORTER_ASSERT(reporter, SkConvertYUV8PlanesToRGBA(pixmaps, kRec601_SkYUVColorSpace,
+                                                        expectedPixmap));
+
+    for (bool withAlpha : { false, true }) {
+    for (GrSurfaceOrigin origin : { kTopLeft_GrSurfaceOrigin, kBottomLeft_GrSurfaceOrigin }) {
+        indices[SkYUVAIndex::kA_Index].fIndex = withAlpha ? 3 : -1;
+        sk_sp<SkImage> image = SkImage::MakeFromYUVAPixmaps(
+                nullptr, kRec601_SkYUVColorSpace, pixmaps, indices, {kW, kH}, origin, false);
+        if (!image) {
+            ERRORF(reporter, "Could not make raster YUVA image.");
+            continue;
+        }
+        REPORTER_ASSERT(reporter, !image->isTextureBacked());
+        REPORTER_ASSERT(reporter, image->isOpaque() == !withAlpha);
+
+        uint32_t pixels[kW * kH];
+        SkImageInfo info = SkImageInfo::Make(kW, kH, kRGBA_8888_SkColorType, kUnpremul_SkAlphaType);
+        if (!image->readPixels(info, pixels, 4 * kW, 0, 0)) {
+            ERRORF(reporter, "Could not read raster YUVA image.");
+            continue;
+        }
+        for (int y = 0; y < kH; ++y)
+        for (int x = 0; x < kW; ++x) {
+            int srcY = origin == kBottomLeft_GrSurfaceOrigin ? kH - 1 - y : y;
+            const uint8_t* px  = (const uint8_t*)(pixels + y * kW + x);
+            const uint8_t* exp = (const uint8_t*)(expected + srcY * kW + x);
+            uint8_t alpha = withAlpha ? planeA[srcY * kW + x] : 0xFF;
+            REPORTER_ASSERT(reporter, px[3] == alpha);
+            if (alpha == 0xFF) {
+                REPORTER_ASSERT(reporter, !memcmp(px, exp, 3));
+            } else {
+                // Premultiplying and unpremultiplying again may lose precision.
+                for (int c = 0; alpha && c < 3; ++c) {
+                    REPORTER_ASSERT(reporter, SkTAbs(px[c] - exp[c]) <= 255 / alpha + 1);
+                }
+            }
+        }
+    }
+    }
+
+    // Interleaved planes are not supported on the CPU.
+    indices[SkYUVAIndex::kA_Index].fIndex = -1;
+    indices[SkYUVAIndex::kV_Index].fIndex = 1;
+    indices[SkYUVAIndex::kV_Index].fChannel = SkColorChannel::kR;
+    REPORTER_ASSERT(reporter, !SkImage::MakeFromYUVAPixmaps(
+            nullptr, kRec601_SkYUVColorSpace, pixmaps, indices, {kW, kH},
+            kTopLeft_GrSurfaceOrigin, false));
+}
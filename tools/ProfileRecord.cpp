@@ -0,0 +1,214 @@
+/*
+ * Copyright 2020 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkCanvas.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkTime.h"
+#include "src/core/SkRecord.h"
+#include "src/core/SkRecordDraw.h"
+#include "src/utils/SkJSONWriter.h"
+#include "tools/ProfileRecord.h"
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace {
+
+static constexpr int kSlowestCount = 20;
+
+template <typename T>
+static const char* NameOf(const T&) {
+#define CASE(U) case SkRecords::U##_Type: return #U;
+    switch (T::kType) { SK_RECORD_TYPES(CASE) }
+#undef CASE
+    SkDEBUGFAIL("Unknown T");
+    return "Unknown T";
+}
+
+// Most commands carry their paint as either an SkPaint or an Optional<SkPaint> named 'paint'.
+static const SkPaint* AsPaint(const SkPaint& paint) { return &paint; }
+static const SkPaint* AsPaint(const SkRecords::Optional<SkPaint>& paint) { return paint; }
+
+template <typename T>
+static auto PaintOf(const T& command, int) -> decltype(AsPaint(command.paint)) {
+    return AsPaint(command.paint);
+}
+template <typename T>
+static const SkPaint* PaintOf(const T&, long) { return nullptr; }
+
+// The paint features most likely to make a command expensive, e.g. "aa+stroke+shader".
+static std::string PaintFeatures(const SkPaint* paint) {
+    std::string features;
+    if (!paint) {
+        return features;
+    }
+    auto add = [&](bool present, const char* name) {
+        if (present) {
+            if (!features.empty()) {
+                features += '+';
+            }
+            features += name;
+        }
+    };
+    add(paint->isAntiAlias(),                      "aa");
+    add(paint->getStyle() != SkPaint::kFill_Style, "stroke");
+    add(paint->getAlpha() != 0xFF,                 "alpha");
+    add(!paint->isSrcOver(),                       "blend");
+    add(paint->getShader() != nullptr,             "shader");
+    add(paint->getColorFilter() != nullptr,        "colorFilter");
+    add(paint->getMaskFilter() != nullptr,         "maskFilter");
+    add(paint->getPathEffect() != nullptr,         "pathEffect");
+    add(paint->getImageFilter() != nullptr,        "imageFilter");
+    return features;
+}
+
+struct Stats {
+    int    fCount = 0;
+    double fNs    = 0;
+    double fMaxNs = 0;
+
+    void add(double ns) {
+        fCount++;
+        fNs += ns;
+        fMaxNs = std::max(fMaxNs, ns);
+    }
+};
+
+// Times each command as it draws it, accumulating across loops.
+class Timer {
+public:
+    Timer(SkCanvas* canvas, std::vector<double>* ns)
+        : fDraw(canvas, nullptr, nullptr, 0, nullptr)
+        , fNs(ns) {}
+
+    void setIndex(int index) { fIndex = index; }
+
+    template <typename T>
+    void operator()(const T& command) {
+        auto start = SkTime::GetNSecs();
+        fDraw(command);
+        (*fNs)[fIndex] += SkTime::GetNSecs() - start;
+    }
+
+    void operator()(const SkRecords::NoOp&) {}
+
+private:
+    SkRecords::Draw      fDraw;
+    std::vector<double>* fNs;
+    int                  fIndex = 0;
+};
+
+// Describes each command once timing is done.
+struct Describer {
+    template <typename T>
+    void operator()(const T& command) {
+        fName     = NameOf(command);
+        fFeatures = PaintFeatures(PaintOf(command, 0));
+        fSkip     = T::kType == SkRecords::NoOp_Type;
+    }
+
+    const char* fName = nullptr;
+    std::string fFeatures;
+    bool        fSkip = false;
+};
+
+}  // namespace
+
+void ProfileRecord(const SkRecord& record,
+                   SkCanvas* canvas,
+                   int loops,
+                   SkJSONWriter* writer) {
+    loops = std::max(loops, 1);
+
+    std::vector<double> ns(record.count());
+    Timer timer(canvas, &ns);
+    for (int loop = 0; loop < loops; loop++) {
+        SkAutoCanvasRestore acr(canvas, true);
+        for (int i = 0; i < record.count(); i++) {
+            timer.setIndex(i);
+            record.visit(i, timer);
+        }
+    }
+
+    struct Command {
+        int         fIndex;
+        const char* fName;
+        std::string fFeatures;
+        double      fNs;
+    };
+    std::vector<Command> commands;
+    std::map<std::string, Stats> byType, byTypeAndPaint;
+    double totalNs = 0;
+    for (int i = 0; i < record.count(); i++) {
+        Describer describer;
+        record.visit(i, describer);
+        if (describer.fSkip) {
+            continue;
+        }
+        const double opNs = ns[i] / loops;
+        totalNs += opNs;
+        byType[describer.fName].add(opNs);
+        byTypeAndPaint[std::string(describer.fName) + ' ' + describer.fFeatures].add(opNs);
+        commands.push_back({i, describer.fName, describer.fFeatures, opNs});
+    }
+
+    // Most expensive first.
+    auto sorted = [](const std::map<std::string, Stats>& stats) {
+        std::vector<std::pair<std::string, Stats>> v(stats.begin(), stats.end());
+        std::sort(v.begin(), v.end(), [](const auto& a, const auto& b) {
+            return a.second.fNs > b.second.fNs;
+        });
+        return v;
+    };
+    std::sort(commands.begin(), commands.end(), [](const Command& a, const Command& b) {
+        return a.fNs > b.fNs;
+    });
+
+    writer->beginObject();
+    writer->appendS32("loops", loops);
+    writer->appendS32("commands", (int)commands.size());
+    writer->appendDouble("totalUs", totalNs * 1e-3);
+
+    writer->beginArray("byType");
+    for (const auto& [name, stats] : sorted(byType)) {
+        writer->beginObject(nullptr, false);
+        writer->appendString("type", name.c_str());
+        writer->appendS32("count", stats.fCount);
+        writer->appendDouble("totalUs", stats.fNs * 1e-3);
+        writer->appendDouble("maxUs", stats.fMaxNs * 1e-3);
+        writer->endObject();
+    }
+    writer->endArray();
+
+    writer->beginArray("byTypeAndPaint");
+    for (const auto& [key, stats] : sorted(byTypeAndPaint)) {
+        const size_t space = key.find(' ');
+        writer->beginObject(nullptr, false);
+        writer->appendString("type", key.substr(0, space).c_str());
+        writer->appendString("paint", key.substr(space + 1).c_str());
+        writer->appendS32("count", stats.fCount);
+        writer->appendDouble("totalUs", stats.fNs * 1e-3);
+        writer->appendDouble("maxUs", stats.fMaxNs * 1e-3);
+        writer->endObject();
+    }
+    writer->endArray();
+
+    writer->beginArray("slowest");
+    for (int i = 0; i < std::min((int)commands.size(), kSlowestCount); i++) {
+        writer->beginObject(nullptr, false);
+        writer->appendS32("index", commands[i].fIndex);
+        writer->appendString("type", commands[i].fName);
+        writer->appendString("paint", commands[i].fFeatures.c_str());
+        writer->appendDouble("us", commands[i].fNs * 1e-3);
+        writer->endObject();
+    }
+    writer->endArray();
+
+    writer->endObject();
+}
@@ -0,0 +1,28 @@
+/*
+ * Copyright 2020 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#ifndef ProfileRecord_DEFINED
+#define ProfileRecord_DEFINED
+
+class SkCanvas;
+class SkJSONWriter;
+class SkRecord;
+
+/**
+ * Draw the record to the supplied canvas via SkRecords::Draw 'loops' times, timing every
+ * command, and write a report to writer as a JSON object. Times are per loop, in microseconds,
+ * aggregated by command type, by command type and paint features (antialiasing, stroking,
+ * shaders, filters, non-srcover blending, ...), and listed for the slowest commands.
+ *
+ * Only the time spent in the canvas calls is measured, so on GPU-backed canvases this
+ * is the CPU cost of issuing the commands, not the cost of executing them.
+ */
+void ProfileRecord(const SkRecord& record,
+                   SkCanvas* canvas,
+                   int loops,
+                   SkJSONWriter* writer);
+
+#endif  // ProfileRecord_DEFINED
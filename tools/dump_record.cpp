@@ -12,7 +12,9 @@
 #include "src/core/SkRecordDraw.h"
 #include "src/core/SkRecordOpts.h"
 #include "src/core/SkRecorder.h"
+#include "src/utils/SkJSONWriter.h"
 #include "tools/DumpRecord.h"
+#include "tools/ProfileRecord.h"
 #include "tools/flags/CommandLineFlags.h"
 
 #include <stdio.h>
@@ -25,6 +27,10 @@ static DEFINE_int(tile, 1000000000, "Simulated tile size.");
 static DEFINE_bool(timeWithCommand, false,
                    "If true, print time next to command, else in first column.");
 static DEFINE_string2(write, w, "", "Write the (optimized) picture to the named file.");
+static DEFINE_string(profile, "",
+                     "Instead of dumping, write a JSON report of per-command timings to the named "
+                     "file, keyed by .SKP name.");
+static DEFINE_int(loops, 10, "Number of times to draw each .SKP when profiling.");
 
 static void dump(const char* name, int w, int h, const SkRecord& record) {
     SkBitmap bitmap;
@@ -38,9 +44,38 @@ static void dump(const char* name, int w, int h, const SkRecord& record) {
     DumpRecord(record, &canvas, FLAGS_timeWithCommand);
 }
 
+static void profile(const char* name, int w, int h, const SkRecord& record, SkJSONWriter* writer) {
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(w, h);
+    SkCanvas canvas(bitmap);
+    canvas.clipRect(SkRect::MakeWH(SkIntToScalar(FLAGS_tile),
+                                   SkIntToScalar(FLAGS_tile)));
+
+    writer->appendName(name);
+    ProfileRecord(record, &canvas, FLAGS_loops, writer);
+}
+
 int main(int argc, char** argv) {
     CommandLineFlags::Parse(argc, argv);
 
+    std::unique_ptr<SkFILEWStream> profileStream;
+    std::unique_ptr<SkJSONWriter> profileWriter;
+    if (FLAGS_profile.count() > 0) {
+        profileStream.reset(new SkFILEWStream(FLAGS_profile[0]));
+        if (!profileStream->isValid()) {
+            SkDebugf("Could not open %s for writing.\n", FLAGS_profile[0]);
+            return 1;
+        }
+        profileWriter.reset(new SkJSONWriter(profileStream.get(), SkJSONWriter::Mode::kPretty));
+        profileWriter->beginObject();
+    }
+    auto finish = [&](int result) {
+        if (profileWriter) {
+            profileWriter->endObject();
+        }
+        return result;
+    };
+
     for (int i = 0; i < FLAGS_skps.count(); i++) {
         if (CommandLineFlags::ShouldSkip(FLAGS_match, FLAGS_skps[i])) {
             continue;
@@ -49,12 +84,12 @@ int main(int argc, char** argv) {
         std::unique_ptr<SkStream> stream = SkStream::MakeFromFile(FLAGS_skps[i]);
         if (!stream) {
             SkDebugf("Could not read %s.\n", FLAGS_skps[i]);
-            return 1;
+            return finish(1);
         }
         sk_sp<SkPicture> src(SkPicture::MakeFromStream(stream.get()));
         if (!src) {
             SkDebugf("Could not read %s as an SkPicture.\n", FLAGS_skps[i]);
-            return 1;
+            return finish(1);
         }
         const int w = SkScalarCeilToInt(src->cullRect().width());
         const int h = SkScalarCeilToInt(src->cullRect().height());
@@ -70,7 +105,11 @@ int main(int argc, char** argv) {
             SkRecordOptimize2(&record);
         }
 
-        dump(FLAGS_skps[i], w, h, record);
+        if (profileWriter) {
+            profile(FLAGS_skps[i], w, h, record, profileWriter.get());
+        } else {
+            dump(FLAGS_skps[i], w, h, record);
+        }
 
         if (FLAGS_write.count() > 0) {
             SkPictureRecorder r;
@@ -87,5 +126,5 @@ int main(int argc, char** argv) {
         }
     }
 
-    return 0;
+    return finish(0);
 }
@@ -5,12 +5,18 @@
  * found in the LICENSE file.
  */
 
+#include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
 #include "include/core/SkPicture.h"
 #include "include/core/SkStream.h"
 #include "include/private/SkTo.h"
 #include "src/core/SkFontDescriptor.h"
 #include "src/core/SkPictureCommon.h"
 #include "src/core/SkPictureData.h"
+#include "src/core/SkRecord.h"
+#include "src/core/SkRecorder.h"
+#include "src/utils/SkJSONWriter.h"
+#include "tools/ProfileRecord.h"
 #include "tools/flags/CommandLineFlags.h"
 
 static DEFINE_string2(input, i, "", "skp on which to report");
@@ -19,6 +25,9 @@ static DEFINE_bool2(cullRect, c, true, "cullRect");
 static DEFINE_bool2(flags, f, true, "flags");
 static DEFINE_bool2(tags, t, true, "tags");
 static DEFINE_bool2(quiet, q, false, "quiet");
+static DEFINE_string2(profile, p, "",
+                      "Draw the skp and write a JSON report of per-command timings to this file");
+static DEFINE_int(loops, 10, "Number of times to draw the skp when profiling");
 
 // This tool can print simple information about an SKP but its main use
 // is just to check if an SKP has been truncated during the recording
@@ -31,6 +40,38 @@ static const int kInvalidTag = 3;
 static const int kMissingInput = 4;
 static const int kIOError = 5;
 
+// Draws the skp into a raster canvas and writes per-command timings as JSON.
+static int profile(const char* input, const char* output) {
+    std::unique_ptr<SkStream> stream = SkStream::MakeFromFile(input);
+    if (!stream) {
+        return kIOError;
+    }
+    sk_sp<SkPicture> picture = SkPicture::MakeFromStream(stream.get());
+    if (!picture) {
+        return kNotAnSKP;
+    }
+    const int w = SkScalarCeilToInt(picture->cullRect().width());
+    const int h = SkScalarCeilToInt(picture->cullRect().height());
+
+    SkRecord record;
+    SkRecorder recorder(&record, w, h);
+    picture->playback(&recorder);
+
+    SkBitmap bitmap;
+    if (!bitmap.tryAllocN32Pixels(w, h)) {
+        return kIOError;
+    }
+    SkCanvas canvas(bitmap);
+
+    SkFILEWStream out(output);
+    if (!out.isValid()) {
+        return kIOError;
+    }
+    SkJSONWriter writer(&out, SkJSONWriter::Mode::kPretty);
+    ProfileRecord(record, &canvas, FLAGS_loops, &writer);
+    return kSuccess;
+}
+
 int main(int argc, char** argv) {
     CommandLineFlags::SetUsage("Prints information about an skp file");
     CommandLineFlags::Parse(argc, argv);
@@ -50,6 +91,16 @@ int main(int argc, char** argv) {
         return kIOError;
     }
 
+    if (FLAGS_profile.count() > 0) {
+        int result = profile(FLAGS_input[0], FLAGS_profile[0]);
+        if (result != kSuccess) {
+            if (!FLAGS_quiet) {
+                SkDebugf("Couldn't profile skp\n");
+            }
+            return result;
+        }
+    }
+
     size_t totStreamSize = stream.getLength();
 
     SkPictInfo info;